@@ -0,0 +1,29 @@
+#pragma once
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+/// Number of rows of check matrices of challenge instances (examples/decoding_challenge_*) and Classic McEliece
+unsigned RowsFor(unsigned cols) {
+    switch(cols) {
+        case 381: return 75;
+        case 640: return 127;
+        case 1041: return 207;
+        case 1409: return 280;
+        case 3488: return 768;
+        default: return cols / 5;
+    }
+}
+
+/// Comma separated list of numbers, e.g. value of --sizes
+std::vector<unsigned> ParseList(const std::string& values) {
+    std::vector<unsigned> result;
+    std::stringstream stream(values);
+    for(std::string value; std::getline(stream, value, ',');) {
+        result.push_back(std::stoul(value));
+    }
+
+    return result;
+}
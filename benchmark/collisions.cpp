@@ -0,0 +1,488 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/parallel_invoke.h>
+#include <oneapi/tbb/task_arena.h>
+#include <nlohmann/json.hpp>
+
+#include <permutations/combination_iterator.hpp>
+#include <stern_attack/list_matching.hpp>
+#include <stern_attack/stern_algorithm.hpp>
+#include <stern_attack/hash_mmt_algorithm.hpp>
+#include <utils/benchmark.hpp>
+
+#include "challenge_sizes.hpp"
+
+
+/**
+ * One list of a join as the algorithm produces it: keys of sums projected onto the collision window
+ * and tuples of column indexes of the same size
+ */
+struct ListInput {
+    std::vector<KeyType> keys;
+    std::vector<unsigned> tuples;
+    unsigned tupleSize;
+
+    std::span<const unsigned> Tuple(std::size_t pos) const {
+        return std::span<const unsigned>(tuples.data() + pos * tupleSize, tupleSize);
+    }
+};
+
+/// Keys of sums of random columns are uniform on the window, indexes are taken from a half of information set
+ListInput GenerateList(std::size_t size, unsigned keyBits, unsigned tupleSize, unsigned numberOfIndexes, std::mt19937_64& gen) {
+    const KeyType mask = keyBits == maxKeyLength ? ~KeyType(0) : (KeyType(1) << keyBits) - 1;
+    std::uniform_int_distribution<unsigned> index(0, std::max(numberOfIndexes, 1u) - 1);
+
+    ListInput list{{}, {}, tupleSize};
+    list.keys.reserve(size);
+    list.tuples.reserve(size * tupleSize);
+    for(std::size_t pos = 0; pos < size; ++pos) {
+        list.keys.push_back(gen() & mask);
+        for(unsigned idx = 0; idx < tupleSize; ++idx) {
+            list.tuples.push_back(index(gen));
+        }
+    }
+
+    return list;
+}
+
+
+/**
+ * All collisions of a join: their number and a checksum of indexes of both tuples of every collision,
+ * it is the same for all strategies if they find the same collisions
+ */
+struct JoinResult {
+    std::uint64_t collisions = 0;
+    std::uint64_t checksum = 0;
+
+    static std::uint64_t Hash(std::span<const unsigned> tuple) {
+        std::uint64_t hash = 0;
+        for(const auto idx: tuple) {
+            hash = hash * 0x100000001B3ull + idx;
+        }
+
+        return hash;
+    }
+
+    /// Checksum is a sum over collisions, so it does not depend on the order in which they are found
+    void Add(std::span<const unsigned> left, std::span<const unsigned> right) {
+        ++collisions;
+        checksum += Hash(left) * 0x9E3779B97F4A7C15ull ^ Hash(right);
+    }
+
+    JoinResult& operator+=(const JoinResult& other) {
+        collisions += other.collisions;
+        checksum += other.checksum;
+        return *this;
+    }
+};
+
+/// Results of parts of a parallel join
+JoinResult Sum(const std::vector<JoinResult>& parts) {
+    JoinResult result;
+    for(const auto& part: parts) {
+        result += part;
+    }
+
+    return result;
+}
+
+template <typename ListType>
+void FillList(ListType& list, const ListInput& input) {
+    list.Reserve(input.keys.size(), input.tupleSize);
+    for(std::size_t pos = 0; pos < input.keys.size(); ++pos) {
+        list.Add(input.keys[pos], input.Tuple(pos));
+    }
+}
+
+/// Position of the first key which is not less than key in sorted list
+std::size_t LowerBound(const SortedList& list, KeyType key) {
+    std::size_t begin = 0, end = list.size();
+    while(begin < end) {
+        const std::size_t middle = begin + (end - begin) / 2;
+        if(list.Key(middle) < key) {
+            begin = middle + 1;
+        } else {
+            end = middle;
+        }
+    }
+
+    return begin;
+}
+
+
+/**
+ * Sort-merge join of SortedList: both lists are sorted at once, the merge pass of SortMergeMatcher
+ * is split into ranges of keys between threads
+ */
+JoinResult SortMergeJoin(const ListInput& left, const ListInput& right, unsigned keyBits, unsigned numThreads) {
+    SortedList leftList, rightList;
+    tbb::parallel_invoke([&]() { FillList(leftList, left); leftList.Finalize(); },
+                         [&]() { FillList(rightList, right); rightList.Finalize(); });
+
+    std::vector<JoinResult> parts(numThreads);
+    tbb::parallel_for(0u, numThreads, [&](unsigned part) {
+        const auto bound = [&](unsigned rangeIdx) {
+            // the last range ends at the end of the list, keys of the full width do not fit into the shift
+            if(rangeIdx == numThreads) {
+                return std::make_pair(leftList.size(), rightList.size());
+            }
+            const KeyType key = static_cast<KeyType>(std::ldexp(static_cast<double>(rangeIdx) / numThreads, keyBits));
+            return std::make_pair(LowerBound(leftList, key), LowerBound(rightList, key));
+        };
+        auto [leftPos, rightPos] = part == 0 ? std::make_pair(std::size_t(0), std::size_t(0)) : bound(part);
+        const auto [leftEnd, rightEnd] = bound(part + 1);
+
+        while(leftPos < leftEnd && rightPos < rightEnd) {
+            const KeyType key = leftList.Key(leftPos);
+            if(key < rightList.Key(rightPos)) {
+                ++leftPos;
+            } else if(key > rightList.Key(rightPos)) {
+                ++rightPos;
+            } else {
+                auto leftMatchedEnd = leftPos, rightMatchedEnd = rightPos;
+                while(leftMatchedEnd < leftEnd && leftList.Key(leftMatchedEnd) == key) {
+                    ++leftMatchedEnd;
+                }
+                while(rightMatchedEnd < rightEnd && rightList.Key(rightMatchedEnd) == key) {
+                    ++rightMatchedEnd;
+                }
+
+                for(auto leftMatched = leftPos; leftMatched != leftMatchedEnd; ++leftMatched) {
+                    for(auto rightMatched = rightPos; rightMatched != rightMatchedEnd; ++rightMatched) {
+                        parts[part].Add(leftList.Indexes(leftMatched), rightList.Indexes(rightMatched));
+                    }
+                }
+
+                leftPos = leftMatchedEnd;
+                rightPos = rightMatchedEnd;
+            }
+        }
+    });
+
+    return Sum(parts);
+}
+
+
+/**
+ * Hash join of HashJoinMatcher: chained hash index is built over the right list,
+ * entries of the left list probe it in chunks of threads
+ */
+JoinResult HashJoin(const ListInput& left, const ListInput& right, unsigned, unsigned numThreads) {
+    UnorderedList leftList;
+    HashedList rightList;
+    tbb::parallel_invoke([&]() { FillList(leftList, left); },
+                         [&]() { FillList(rightList, right); rightList.Finalize(); });
+
+    std::vector<JoinResult> parts(numThreads);
+    tbb::parallel_for(0u, numThreads, [&](unsigned part) {
+        const std::size_t begin = leftList.size() * part / numThreads, end = leftList.size() * (part + 1) / numThreads;
+        for(std::size_t leftPos = begin; leftPos < end; ++leftPos) {
+            rightList.ForEachMatch(leftList.Key(leftPos), [&](std::size_t rightPos) {
+                parts[part].Add(leftList.Indexes(leftPos), rightList.Indexes(rightPos));
+                return false;
+            });
+        }
+    });
+
+    return Sum(parts);
+}
+
+
+/**
+ * Entries of a list grouped by the top bits of their keys: offsets[bucket] is the first entry of bucket
+ */
+struct BucketedEntries {
+    struct Entry {
+        KeyType key;
+        std::uint32_t id;
+    };
+
+    std::vector<Entry> entries;
+    std::vector<std::uint32_t> offsets;
+    std::vector<unsigned> tuples;
+    unsigned shift;
+};
+
+/// Bucket of key by its top bucketBits of keyBits bits
+inline std::size_t BucketOf(KeyType key, unsigned shift) {
+    return shift >= maxKeyLength ? 0 : key >> shift;
+}
+
+/**
+ * Counting sort of the list into 2^bucketBits buckets, every chunk of threads counts its own histogram,
+ * so chunks are scattered in parallel
+ */
+BucketedEntries Bucketize(const ListInput& list, unsigned keyBits, unsigned bucketBits, unsigned numThreads) {
+    BucketedEntries bucketed;
+    bucketed.shift = keyBits - bucketBits;
+    const std::size_t numberOfBuckets = std::size_t(1) << bucketBits, size = list.keys.size();
+
+    bucketed.entries.resize(size);
+    bucketed.tuples = list.tuples;
+    std::vector<std::vector<std::uint32_t>> histograms(numThreads, std::vector<std::uint32_t>(numberOfBuckets, 0));
+
+    tbb::parallel_for(0u, numThreads, [&](unsigned chunk) {
+        for(std::size_t pos = size * chunk / numThreads; pos < size * (chunk + 1) / numThreads; ++pos) {
+            ++histograms[chunk][BucketOf(list.keys[pos], bucketed.shift)];
+        }
+    });
+
+    bucketed.offsets.resize(numberOfBuckets + 1);
+    std::uint32_t offset = 0;
+    for(std::size_t bucket = 0; bucket < numberOfBuckets; ++bucket) {
+        bucketed.offsets[bucket] = offset;
+        for(auto& histogram: histograms) {
+            offset += std::exchange(histogram[bucket], offset);
+        }
+    }
+    bucketed.offsets[numberOfBuckets] = offset;
+
+    tbb::parallel_for(0u, numThreads, [&](unsigned chunk) {
+        auto& positions = histograms[chunk];
+        for(std::size_t pos = size * chunk / numThreads; pos < size * (chunk + 1) / numThreads; ++pos) {
+            const KeyType key = list.keys[pos];
+            bucketed.entries[positions[BucketOf(key, bucketed.shift)]++] = {key, static_cast<std::uint32_t>(pos)};
+        }
+    });
+
+    return bucketed;
+}
+
+
+/**
+ * Bucket index: the right list is grouped into about one bucket per entry by the top bits of keys
+ * (a direct-address table if the window is narrower), entries of the left list probe their bucket
+ */
+JoinResult BucketIndexJoin(const ListInput& left, const ListInput& right, unsigned keyBits, unsigned numThreads) {
+    const unsigned bucketBits = std::min<unsigned>(keyBits, std::bit_width(right.keys.size()));
+    const auto index = Bucketize(right, keyBits, bucketBits, numThreads);
+    const std::vector<unsigned> leftTuples = left.tuples;
+
+    std::vector<JoinResult> parts(numThreads);
+    tbb::parallel_for(0u, numThreads, [&](unsigned part) {
+        const std::size_t size = left.keys.size();
+        for(std::size_t leftPos = size * part / numThreads; leftPos < size * (part + 1) / numThreads; ++leftPos) {
+            const KeyType key = left.keys[leftPos];
+            const std::size_t bucket = BucketOf(key, index.shift);
+            for(auto pos = index.offsets[bucket]; pos < index.offsets[bucket + 1]; ++pos) {
+                if(index.entries[pos].key == key) {
+                    parts[part].Add(std::span<const unsigned>(leftTuples.data() + leftPos * left.tupleSize, left.tupleSize),
+                                    std::span<const unsigned>(index.tuples.data() + index.entries[pos].id * right.tupleSize, right.tupleSize));
+                }
+            }
+        }
+    });
+
+    return Sum(parts);
+}
+
+
+/**
+ * Radix-partitioned join: both lists are partitioned by the top bits of keys into partitions
+ * which fit into cache, partitions are joined independently by threads with a small chained hash index
+ */
+JoinResult RadixPartitionedJoin(const ListInput& left, const ListInput& right, unsigned keyBits, unsigned numThreads) {
+    // 16-byte entries of a pair of partitions of about 8K entries fit into L2 cache
+    constexpr std::size_t entriesOfPartition = 8192;
+    const std::size_t size = std::max(left.keys.size(), right.keys.size());
+    const unsigned partitionBits = std::min<unsigned>({keyBits, 16, static_cast<unsigned>(std::bit_width(size / entriesOfPartition))});
+
+    BucketedEntries leftPartitions, rightPartitions;
+    tbb::parallel_invoke([&]() { leftPartitions = Bucketize(left, keyBits, partitionBits, numThreads); },
+                         [&]() { rightPartitions = Bucketize(right, keyBits, partitionBits, numThreads); });
+
+    const std::size_t numberOfPartitions = std::size_t(1) << partitionBits;
+    std::vector<JoinResult> parts(numberOfPartitions);
+    tbb::parallel_for(std::size_t(0), numberOfPartitions, [&](std::size_t partition) {
+        const auto rightBegin = rightPartitions.offsets[partition], rightEnd = rightPartitions.offsets[partition + 1];
+        const std::size_t numberOfHeads = std::bit_ceil(std::max<std::size_t>(rightEnd - rightBegin, 1));
+        const unsigned hashShift = maxKeyLength - std::countr_zero(numberOfHeads);
+        const auto hash = [&](KeyType key) {
+            return numberOfHeads == 1 ? 0 : (key * 0x9E3779B97F4A7C15ull) >> hashShift;
+        };
+
+        constexpr std::uint32_t empty = ~std::uint32_t(0);
+        std::vector<std::uint32_t> heads(numberOfHeads, empty), next(rightEnd - rightBegin);
+        for(auto pos = rightBegin; pos < rightEnd; ++pos) {
+            auto& head = heads[hash(rightPartitions.entries[pos].key)];
+            next[pos - rightBegin] = head;
+            head = pos - rightBegin;
+        }
+
+        for(auto leftPos = leftPartitions.offsets[partition]; leftPos < leftPartitions.offsets[partition + 1]; ++leftPos) {
+            const auto& leftEntry = leftPartitions.entries[leftPos];
+            for(auto pos = heads[hash(leftEntry.key)]; pos != empty; pos = next[pos]) {
+                const auto& rightEntry = rightPartitions.entries[rightBegin + pos];
+                if(rightEntry.key == leftEntry.key) {
+                    parts[partition].Add(std::span<const unsigned>(leftPartitions.tuples.data() + leftEntry.id * left.tupleSize, left.tupleSize),
+                                         std::span<const unsigned>(rightPartitions.tuples.data() + rightEntry.id * right.tupleSize, right.tupleSize));
+                }
+            }
+        }
+    });
+
+    return Sum(parts);
+}
+
+
+/**
+ * Join of one level of an algorithm at one challenge size
+ */
+struct JoinCase {
+    std::string algorithm;
+    unsigned cols;
+    unsigned keyBits;
+    std::size_t leftSize;
+    std::size_t rightSize;
+    unsigned tupleSize;
+    unsigned numberOfIndexes;
+};
+
+/**
+ * Joins of Stern and MMT with their default parameters: lists of C(k / 2, p) sums on l bits for Stern;
+ * level 1 of MMT joins C((k + l) / 2, p) sums on l2 bits, level 2 joins the merged lists on l1 bits
+ */
+std::vector<JoinCase> CasesFor(unsigned cols, std::size_t maxEntries) {
+    const unsigned rows = RowsFor(cols), k = cols - rows;
+    std::vector<JoinCase> cases;
+
+    const auto [p, l] = SternAlgorithm(cols).getParams();
+    const std::size_t sternSize = std::min<std::size_t>(NumberOfCombinations(k / 2, p), maxEntries);
+    cases.push_back(JoinCase{"Stern", cols, l, sternSize, sternSize, p, k / 2});
+
+    const MMTHashAlgorithm mmt(cols, rows);
+    const auto [mmtP, l1, l2, mmtL] = mmt.getParams();
+    const std::size_t level1Size = std::min<std::size_t>(NumberOfCombinations((k + mmtL) / 2, mmtP), maxEntries);
+    cases.push_back(JoinCase{"MMT level 1", cols, l2, level1Size, level1Size, mmtP, (k + mmtL) / 2});
+
+    const std::size_t level2Size = std::min(mmt.ExpectedLengthOfList(), maxEntries);
+    cases.push_back(JoinCase{"MMT level 2", cols, l1, level2Size, level2Size, 2 * mmtP, k + mmtL});
+
+    return cases;
+}
+
+
+int main(int argc, const char** argv) {
+    if(argc < 2) {
+        std::cerr << "usage: collisions <output json> [--sizes 381,640,...] [--threads 1,2,...] [--samples N] [--max-entries N]\n";
+        return 1;
+    }
+
+    std::vector<unsigned> sizes{381, 640, 1041, 1409};
+    std::vector<unsigned> threads;
+    for(unsigned numThreads = 1; numThreads <= std::max(std::thread::hardware_concurrency(), 1u); numThreads *= 2) {
+        threads.push_back(numThreads);
+    }
+    unsigned samples = 5;
+    std::size_t maxEntries = std::size_t(1) << 22;
+
+    for(int argIdx = 2; argIdx < argc; ++argIdx) {
+        const std::string option(argv[argIdx]);
+        if(argIdx + 1 == argc) {
+            std::cerr << "option " << option << " has no value\n";
+            return 1;
+        }
+        const std::string value(argv[++argIdx]);
+
+        if(option == "--sizes") {
+            sizes = ParseList(value);
+        } else if(option == "--threads") {
+            threads = ParseList(value);
+        } else if(option == "--samples") {
+            samples = std::stoul(value);
+        } else if(option == "--max-entries") {
+            maxEntries = std::stoull(value);
+        } else {
+            std::cerr << "unknown option " << option << '\n';
+            return 1;
+        }
+    }
+
+    using JoinFunction = std::function<JoinResult(const ListInput&, const ListInput&, unsigned, unsigned)>;
+    const std::vector<std::pair<std::string, JoinFunction>> strategies{
+        {"sort-merge", SortMergeJoin},
+        {"hash join", HashJoin},
+        {"bucket index", BucketIndexJoin},
+        {"radix-partitioned", RadixPartitionedJoin},
+    };
+
+    using json = nlohmann::json;
+    json data;
+    data["config"] = {{"samples", samples}, {"sizes", sizes}, {"threads", threads}, {"max_entries", maxEntries}};
+    data["results"] = json::array();
+
+    // one sample is one full join, the first one is dropped as warmup
+    const MicroBenchmark benchmark(samples, 1);
+    bool isConsistent = true;
+
+    for(const unsigned cols: sizes) {
+        for(const auto& joinCase: CasesFor(cols, maxEntries)) {
+            std::mt19937_64 gen(cols);
+            const ListInput left = GenerateList(joinCase.leftSize, joinCase.keyBits, joinCase.tupleSize, joinCase.numberOfIndexes, gen);
+            const ListInput right = GenerateList(joinCase.rightSize, joinCase.keyBits, joinCase.tupleSize, joinCase.numberOfIndexes, gen);
+
+            std::optional<JoinResult> reference;
+            for(const unsigned numThreads: threads) {
+                tbb::task_arena arena(numThreads);
+
+                for(const auto& [name, join]: strategies) {
+                    JoinResult result;
+                    const auto statistics = arena.execute([&]() {
+                        return benchmark.Run([]() {}, [&]() { result = join(left, right, joinCase.keyBits, numThreads); });
+                    });
+
+                    if(!reference) {
+                        reference = result;
+                    } else if(result.collisions != reference->collisions || result.checksum != reference->checksum) {
+                        std::cerr << name << " finds other collisions than " << strategies.front().first << '\n';
+                        isConsistent = false;
+                    }
+
+                    const double entries = joinCase.leftSize + joinCase.rightSize;
+                    std::cout << std::left << std::setw(12) << joinCase.algorithm << " n = " << std::setw(5) << cols
+                              << " l = " << std::setw(3) << joinCase.keyBits << " |L| = " << std::setw(9) << joinCase.leftSize
+                              << " threads " << std::setw(3) << numThreads << std::setw(18) << name
+                              << " median " << std::setw(12) << statistics.medianNs / 1e6 << " ms, "
+                              << statistics.medianNs / entries << " ns/entry, " << result.collisions << " collisions\n";
+
+                    data["results"].push_back({
+                        {"strategy", name},
+                        {"algorithm", joinCase.algorithm},
+                        {"n", cols},
+                        {"key_bits", joinCase.keyBits},
+                        {"left_entries", joinCase.leftSize},
+                        {"right_entries", joinCase.rightSize},
+                        {"tuple_size", joinCase.tupleSize},
+                        {"threads", numThreads},
+                        {"collisions", result.collisions},
+                        {"samples", statistics.samples},
+                        {"min_ns", statistics.minNs},
+                        {"median_ns", statistics.medianNs},
+                        {"mean_ns", statistics.meanNs},
+                        {"max_ns", statistics.maxNs},
+                        {"median_ns_per_entry", statistics.medianNs / entries},
+                    });
+                }
+            }
+        }
+    }
+
+    std::ofstream output(argv[1]);
+    output << std::setw(4) << data << '\n';
+
+    return isConsistent ? 0 : 1;
+}
@@ -2,167 +2,283 @@
 #include <nlohmann/json.hpp>
 
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
 #include <iostream>
+#include <optional>
+#include <sstream>
 #include <vector>
 #include <string>
 #include <fstream>
-#include <filesystem>
 
 #include <algebra/binary_matrix.hpp>
+#include <instances/instance_generator.hpp>
+#include <instances/text_format.hpp>
 #include <permutations/random_permutation_iterator.hpp>
+#include <stern_attack/base_decoding.hpp>
+#include <stern_attack/instrumentation.hpp>
 #include <stern_attack/stern_algorithm.hpp>
 #include <stern_attack/new_stern_algorithm.hpp>
 #include <stern_attack/mmt_algorithm.hpp>
 #include <stern_attack/hash_mmt_algorithm.hpp>
 #include <stern_attack/fs-isd_algorithm.hpp>
+#include <stern_attack/ball_collision_algorithm.hpp>
+#include <stern_attack/parameter_optimizer.hpp>
 #include <utils/benchmark.hpp>
-#define assertm(exp, msg) assert(((void)msg, exp))
- 
-
-std::vector<std::string> ReadLinesFromFile(const std::string& file) {
-    assertm(std::filesystem::exists(file), " is not found\n");
-
-    std::ifstream ifs(file);
-    std::vector<std::string> lines;
-    std::string line;
-
-    while(std::getline(ifs, line)) {
-        lines.push_back(line);
-    }
-
-    return lines;
-}
 
 
 struct DataStruct {
-    long duration;
-    long numberOfIterations;
+    double durationNs;
+    /// Number of permutations including ones which elimination failed
+    std::uint64_t numberOfIterations;
+    /// Number of permutations which elimination succeeded, i.e. number of information sets
+    std::uint64_t numberOfEliminations;
 };
 
 
 /**
- * @tparam DecodingStepAlgorithm type of algorithm (for example, ISD, Stern)
- * @param checkMatrix binary permuted check matrix for which gauss elimination should be applied
- * @param syndrome syndrome vector 
+ * One seeded run of decoding: permutations are taken from the stream of seed, so the run is reproducible.
+ * Every permutation is eliminated exactly once by Eliminate and searched by Search
+ * @tparam DecodingStepAlgorithm type of algorithm (for example, Stern, MMT)
+ * @param checkMatrix binary check matrix
+ * @param syndrome syndrome vector
  * @param omega number of errors in codeword (i.e. number of ones in error vector)
- * @param algorithm algorithm for decoding 
- * @return number of iteration and time
+ * @param algorithm algorithm for decoding
+ * @param seed seed of the stream of permutations
+ * @return number of iterations and time
  */
 template <typename DecodingStepAlgorithm>
-DataStruct DecodingBecnhmark(BinaryMatrix checkMatrix, boost::dynamic_bitset<> syndrome,
-                                 const unsigned omega, const DecodingStepAlgorithm& algorithm){
-    Timer timer(algorithm.algorithmName, 1, false);
-    unsigned cols = checkMatrix.ColumnsSize();
-
-    boost::dynamic_bitset<> errorVector(cols);
-    unsigned numberOfIterations = 0;
-    for(auto permutationIter = RandomPermutation(cols).begin(); permutationIter.CanBePermuted(); ++permutationIter, ++numberOfIterations) {
-        
-        BinaryMatrix permutedCheckMatrix = checkMatrix.applyPermutation(*permutationIter);
-        auto copiedSyndrome = syndrome;
+DataStruct DecodingBenchmark(const BinaryMatrix& checkMatrix, const boost::dynamic_bitset<>& syndrome,
+                             const unsigned omega, const DecodingStepAlgorithm& algorithm, std::uint64_t seed) {
+    const auto start = std::chrono::steady_clock::now();
+    const unsigned cols = checkMatrix.ColumnsSize();
 
-        if(!algorithm.GaussElimination(permutedCheckMatrix, copiedSyndrome)){
+    DataStruct result{0, 0, 0};
+    auto permutationIter = RandomPermutation(cols).begin(seed, 0, 1, NumberOfRandomPositions(algorithm, checkMatrix));
+    for(; permutationIter.CanBePermuted(); ++permutationIter) {
+        ++result.numberOfIterations;
+
+        BinaryMatrix permutedCheckMatrix = checkMatrix.applyPermutation(*permutationIter);
+        const auto context = algorithm.Eliminate(permutedCheckMatrix, syndrome, omega);
+        if(!context) {
             continue;
         }
 
-        auto permutedErrorVector = algorithm(permutedCheckMatrix, copiedSyndrome, omega);
-
-        if(permutedErrorVector) {
-            for(unsigned idx = 0; idx < permutationIter->size(); ++idx){
-                errorVector[(*permutationIter)[idx]] = (*permutedErrorVector)[idx];
-            }
-
+        ++result.numberOfEliminations;
+        if(algorithm.Search(*context)) {
             break;
         }
     }
 
-    return DataStruct{timer.GetDuration(), numberOfIterations};
+    result.durationNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return result;
 }
 
-int main(int argc, const char** argv) {
-    if(argc != 3) {
-        std::cerr << "You should provide the name of output json and number of iterations\n";
-        return 0;
-    }
 
-    std::ofstream output(argv[1]);
-    int N = std::atoi(argv[2]);
+nlohmann::json ToJson(const SampleSummary& summary) {
+    return {
+        {"count", summary.count},
+        {"mean", summary.mean},
+        {"standard_deviation", summary.standardDeviation},
+        {"mean_ci95", {summary.meanLow, summary.meanHigh}},
+        {"median", summary.median},
+        {"median_ci95", {summary.medianLow, summary.medianHigh}},
+    };
+}
 
-    using json = nlohmann::json;
 
-    json data;
+/**
+ * Runs algorithm numberOfRuns times with seeds firstSeed, firstSeed + 1, ..., so all algorithms
+ * share the same streams of permutations, and summarizes runs
+ */
+template <typename DecodingStepAlgorithm>
+void BenchmarkAlgorithm(nlohmann::json& data, const std::string& name, const BinaryMatrix& checkMatrix,
+                        const boost::dynamic_bitset<>& syndrome, unsigned omega, const DecodingStepAlgorithm& algorithm,
+                        unsigned numberOfRuns, std::uint64_t firstSeed) {
+    std::vector<double> iterations, eliminations, durations, timesOfIteration;
+    const auto reportBefore = Instrumentation::Collect();
+
+    for(unsigned run = 0; run < numberOfRuns; ++run) {
+        const auto result = DecodingBenchmark(checkMatrix, syndrome, omega, algorithm, firstSeed + run);
+
+        data[name][run] = {
+            {"seed", firstSeed + run},
+            {"iterations_count", result.numberOfIterations},
+            {"eliminations_count", result.numberOfEliminations},
+            {"duration", result.durationNs * 1e-6},
+        };
 
-    auto inputDataForMatrix = ReadLinesFromFile("benchmark/check_matrix.txt");
-    auto inputDataForSyndrome = ReadLinesFromFile("benchmark/syndrome.txt");
-    auto omega = 9;
+        iterations.push_back(result.numberOfIterations);
+        eliminations.push_back(result.numberOfEliminations);
+        durations.push_back(result.durationNs * 1e-6);
+        timesOfIteration.push_back(result.durationNs / result.numberOfIterations);
+    }
 
-    BinaryMatrix checkMatrix;
-    for(auto& line: inputDataForMatrix) {
-        std::reverse(line.begin(), line.end());
-        checkMatrix.addRow(line);
+    const double expected = algorithm.ExpectedIterations(checkMatrix.RowsSize(), checkMatrix.ColumnsSize(), omega);
+    const auto eliminationsSummary = Summarize(eliminations);
+    // expectation counts information sets, so it is compared with the number of successful eliminations
+    const bool isExpectedInInterval = eliminationsSummary.meanLow <= expected && expected <= eliminationsSummary.meanHigh;
+
+    auto& summary = data["summary"][name];
+    summary["iterations"] = ToJson(Summarize(iterations));
+    summary["eliminations"] = ToJson(eliminationsSummary);
+    summary["duration_ms"] = ToJson(Summarize(durations));
+    summary["time_of_iteration_ns"] = ToJson(Summarize(timesOfIteration));
+    summary["expected_eliminations"] = expected;
+    summary["measured_to_expected"] = eliminationsSummary.mean / expected;
+    summary["expected_in_ci95"] = isExpectedInInterval;
+    summary["peak_list_bytes"] = algorithm.MemoryOfLists().peakBytes;
+
+    if constexpr (Instrumentation::enabled) {
+        DecodingStatistics statistics;
+        (Instrumentation::Collect() - reportBefore).Save(statistics);
+        summary["instrumentation"] = statistics;
+    }
+
+    if constexpr (Instrumentation::hardwareCounters) {
+        const auto report = Instrumentation::Collect() - reportBefore;
+        for(std::size_t event = 0; event < hardwarePerfEvents.size(); ++event) {
+            if(!report.IsEventCounted(event)) {
+                continue;
+            }
+
+            for(std::size_t phase = 0; phase < InstrumentationReport::numberOfPhases; ++phase) {
+                summary["hardware_counters"][InstrumentationReport::phaseNames[phase]][hardwarePerfEvents[event].name] = report.events[phase][event];
+            }
+        }
     }
 
-    std::reverse(inputDataForSyndrome.front().begin(), inputDataForSyndrome.front().end());
-    boost::dynamic_bitset<> syndrome(inputDataForSyndrome.front());
+    const auto timeSummary = Summarize(timesOfIteration);
+    std::cout << std::left << std::setw(16) << name
+              << " eliminations: mean " << std::setw(10) << eliminationsSummary.mean
+              << " [" << eliminationsSummary.meanLow << ", " << eliminationsSummary.meanHigh << "]"
+              << ", median " << eliminationsSummary.median
+              << ", expected " << expected << (isExpectedInInterval ? "" : " (out of CI)")
+              << "; time of iteration: median " << timeSummary.median * 1e-3 << " us"
+              << " [" << timeSummary.medianLow * 1e-3 << ", " << timeSummary.medianHigh * 1e-3 << "]\n";
+}
 
-    for(int iteration = 0; iteration < N; ++iteration) {
-        auto resultStern = DecodingBecnhmark(checkMatrix, syndrome, omega, SternAlgorithm(checkMatrix.ColumnsSize()));
-        auto resultSternHash = DecodingBecnhmark(checkMatrix, syndrome, omega, NewSternAlgorithm(checkMatrix.ColumnsSize()));
-        auto resultFS = DecodingBecnhmark(checkMatrix, syndrome, omega, FS_ISD_Algorithm(checkMatrix.ColumnsSize()));
-        auto resultMMT = DecodingBecnhmark(checkMatrix, syndrome, omega, MMTAlgorithm(checkMatrix.ColumnsSize(), checkMatrix.RowsSize()));
-        auto resultMMTHash = DecodingBecnhmark(checkMatrix, syndrome, omega, MMTHashAlgorithm(checkMatrix.ColumnsSize(), checkMatrix.RowsSize()));
+/**
+ * Algorithm with default parameters or with parameters chosen by ParameterOptimizer for the instance
+ */
+template <OptimizableAlgorithm AlgorithmType>
+AlgorithmType MakeBenchmarkedAlgorithm(bool isOptimized, const BinaryMatrix& checkMatrix, const boost::dynamic_bitset<>& syndrome, unsigned omega) {
+    if(isOptimized) {
+        return MakeOptimizedAlgorithm<AlgorithmType>(checkMatrix, syndrome, omega);
+    }
 
-        data["stern"][iteration] = {
-            {"iterations_count", resultStern.numberOfIterations},
-            {"duration", resultStern.duration},
-        };
+    if constexpr (std::is_constructible_v<AlgorithmType, unsigned>) {
+        return AlgorithmType(checkMatrix.ColumnsSize());
+    } else {
+        return AlgorithmType(checkMatrix.ColumnsSize(), checkMatrix.RowsSize());
+    }
+}
 
-        data["stern_hash"][iteration] = {
-            {"iterations_count", resultSternHash.numberOfIterations},
-            {"duration", resultSternHash.duration},
-        };
+int main(int argc, const char** argv) {
+    std::vector<std::string> arguments(argv + 1, argv + argc);
+    const auto optimizedFlag = std::find(arguments.begin(), arguments.end(), "--optimized");
+    const bool isOptimized = optimizedFlag != arguments.end();
+    if(isOptimized) {
+        arguments.erase(optimizedFlag);
+    }
 
-        data["FS_ISD"][iteration] = {
-            {"iterations_count", resultFS.numberOfIterations},
-            {"duration", resultFS.duration},
-        };
+    // instance with planted error instead of benchmark/check_matrix.txt: --generate n,k,omega[,seed]
+    std::optional<DecodingInstance> generated;
+    const auto generateFlag = std::find(arguments.begin(), arguments.end(), "--generate");
+    if(generateFlag != arguments.end() && generateFlag + 1 != arguments.end()) {
+        std::vector<std::uint64_t> values;
+        std::stringstream stream(*(generateFlag + 1));
+        for(std::string value; std::getline(stream, value, ',');) {
+            values.push_back(std::stoull(value));
+        }
+        if(values.size() != 3 && values.size() != 4) {
+            std::cerr << "--generate takes n,k,omega and optionally the seed of instance\n";
+            return 0;
+        }
 
-        data["MMT"][iteration] = {
-            {"iterations_count", resultMMT.numberOfIterations},
-            {"duration", resultMMT.duration},
-        };
+        generated = GenerateInstance(values[0], values[1], values[2], values.size() == 4 ? values[3] : 1);
+        arguments.erase(generateFlag, generateFlag + 2);
+    }
 
-        data["MMT_hash"][iteration] = {
-            {"iterations_count", resultMMTHash.numberOfIterations},
-            {"duration", resultMMTHash.duration},
-        };
+    if(arguments.size() != 2 && arguments.size() != 3) {
+        std::cerr << "You should provide the name of output json, number of runs, optionally the first seed, "
+                     "--optimized to choose parameters by ParameterOptimizer and --generate n,k,omega[,seed] "
+                     "to decode a generated instance\n";
+        return 0;
     }
 
-    data["params"]["n"] = checkMatrix.ColumnsSize();
-    data["params"]["k"] = checkMatrix.ColumnsSize() - checkMatrix.RowsSize();
-    data["params"]["omega"] = omega;
+    std::ofstream output(arguments[0]);
+    const unsigned N = std::stoul(arguments[1]);
+    const std::uint64_t firstSeed = arguments.size() == 3 ? std::stoull(arguments[2]) : 1;
+
+    using json = nlohmann::json;
 
-    auto [sternP, sternL] = SternAlgorithm(checkMatrix.ColumnsSize()).getParams();
-    auto [fsP, fsL] = FS_ISD_Algorithm(checkMatrix.ColumnsSize()).getParams();
-    auto [mmtP, mmtL1, mmtL2, _] = MMTAlgorithm(checkMatrix.ColumnsSize(), checkMatrix.RowsSize()).getParams();
+    json data;
 
-    data["stern_params"]["p"] = sternP;
-    data["stern_params"]["l"] = sternL;
-    
-    data["stern_hash_params"]["p"] = sternP;
-    data["stern_hash_params"]["l"] = sternL;
+    unsigned omega = 9;
+    BinaryMatrix checkMatrix;
+    boost::dynamic_bitset<> syndrome;
+
+    if(generated) {
+        checkMatrix = generated->checkMatrix;
+        syndrome = generated->syndrome;
+        omega = generated->errorVector.count();
+    } else {
+        checkMatrix = ReadTextMatrix("benchmark/check_matrix.txt");
+        syndrome = ReadTextVector("benchmark/syndrome.txt");
+    }
 
-    data["FS_ISD_params"]["p"] = fsP;
-    data["FS_ISD_params"]["l"] = fsL;
+    const unsigned rows = checkMatrix.RowsSize(), cols = checkMatrix.ColumnsSize();
 
-    data["MMT_params"]["p"] = mmtP;
-    data["MMT_params"]["l1"] = mmtL1;
-    data["MMT_params"]["l2"] = mmtL2;
+    const auto stern = MakeBenchmarkedAlgorithm<SternAlgorithm>(isOptimized, checkMatrix, syndrome, omega);
+    const auto sternHash = MakeBenchmarkedAlgorithm<NewSternAlgorithm>(isOptimized, checkMatrix, syndrome, omega);
+    const auto fs = MakeBenchmarkedAlgorithm<FS_ISD_Algorithm>(isOptimized, checkMatrix, syndrome, omega);
+    const auto mmt = MakeBenchmarkedAlgorithm<MMTAlgorithm>(isOptimized, checkMatrix, syndrome, omega);
+    const auto mmtHash = MakeBenchmarkedAlgorithm<MMTHashAlgorithm>(isOptimized, checkMatrix, syndrome, omega);
+    const auto ballCollision = MakeBenchmarkedAlgorithm<BallCollisionAlgorithm>(isOptimized, checkMatrix, syndrome, omega);
 
-    data["MMT_hash_params"]["p"] = mmtP;
-    data["MMT_hash_params"]["l1"] = mmtL1;
-    data["MMT_hash_params"]["l2"] = mmtL2;
+    BenchmarkAlgorithm(data, "stern", checkMatrix, syndrome, omega, stern, N, firstSeed);
+    BenchmarkAlgorithm(data, "stern_hash", checkMatrix, syndrome, omega, sternHash, N, firstSeed);
+    BenchmarkAlgorithm(data, "FS_ISD", checkMatrix, syndrome, omega, fs, N, firstSeed);
+    BenchmarkAlgorithm(data, "MMT", checkMatrix, syndrome, omega, mmt, N, firstSeed);
+    BenchmarkAlgorithm(data, "MMT_hash", checkMatrix, syndrome, omega, mmtHash, N, firstSeed);
+    BenchmarkAlgorithm(data, "ball_collision", checkMatrix, syndrome, omega, ballCollision, N, firstSeed);
+
+    data["params"]["n"] = cols;
+    data["params"]["k"] = cols - rows;
+    data["params"]["omega"] = omega;
+    data["params"]["runs"] = N;
+    data["params"]["first_seed"] = firstSeed;
+    data["params"]["optimized"] = isOptimized;
+    data["params"]["generated"] = generated.has_value();
+
+    const auto saveSternParams = [&data](const std::string& name, const auto& algorithm) {
+        auto [p, l] = algorithm.getParams();
+        data[name]["p"] = p;
+        data[name]["l"] = l;
+        data[name]["windows"] = algorithm.getNumberOfWindows();
+        data[name]["splits"] = algorithm.getNumberOfSplits();
+    };
+
+    const auto saveMMTParams = [&data](const std::string& name, const auto& algorithm) {
+        auto [p, l1, l2, _] = algorithm.getParams();
+        data[name]["p"] = p;
+        data[name]["l1"] = l1;
+        data[name]["l2"] = l2;
+    };
+
+    saveSternParams("stern_params", stern);
+    saveSternParams("stern_hash_params", sternHash);
+    saveSternParams("FS_ISD_params", fs);
+    saveMMTParams("MMT_params", mmt);
+    saveMMTParams("MMT_hash_params", mmtHash);
+
+    auto [ballP, ballL, ballQ] = ballCollision.getParams();
+    data["ball_collision_params"]["p"] = ballP;
+    data["ball_collision_params"]["l"] = ballL;
+    data["ball_collision_params"]["q"] = ballQ;
 
 
     output << std::setw(4) << data << '\n';
-}
\ No newline at end of file
+}
@@ -16,11 +16,17 @@ class GetParams:
         self.k = params["k"]
         self.omega = params["omega"]
 
+    @staticmethod
+    def _with_rounds(expected, params_optimized):
+        # every window and split is an extra chance for the same elimination (rounds are treated as independent)
+        rounds = params_optimized.get("windows", 1) * params_optimized.get("splits", 1)
+        return 1 / (1 - (1 - 1 / expected) ** rounds)
+
     def _get_expected_stern(self, params_optimized):
         p = int(params_optimized["p"]) * 2
         t = comb(self.k // 2, p // 2)
         t1 = comb(self.n - self.k - params_optimized["l"], self.omega - p)
-        return comb(self.params["n"], self.params["omega"]) / (t * t * t1)
+        return self._with_rounds(comb(self.params["n"], self.params["omega"]) / (t * t * t1), params_optimized)
     
     def _get_expected_mmt(self, params_optimized):
         p = int(params_optimized["p"]) * 4
@@ -32,8 +38,21 @@ class GetParams:
         p = int(params_optimized["p"]) * 2
         t = comb((self.k + params_optimized["l"]) // 2, p // 2)
         t1 = comb(self.n - self.k - params_optimized["l"], self.omega - p)
-        return comb(self.params["n"], self.params["omega"]) / (t * t * t1)
+        return self._with_rounds(comb(self.params["n"], self.params["omega"]) / (t * t * t1), params_optimized)
     
+    def _get_expected_ball_collision(self, params_optimized):
+        p = int(params_optimized["p"])
+        l, q = params_optimized["l"], params_optimized["q"]
+        l1, l2 = l // 2, l - l // 2
+        t = comb(self.k // 2, p)
+        successes = sum(
+            t * t * comb(l1, q1) * comb(l2, q2) * comb(self.n - self.k - l, self.omega - 2 * p - q1 - q2)
+            for q1 in range(q + 1)
+            for q2 in range(q + 1)
+            if self.omega - 2 * p - q1 - q2 >= 0
+        )
+        return comb(self.params["n"], self.params["omega"]) / successes
+
     def get_expected(self, alg: str, params_optimized: dict) -> int:
         if alg == "stern" or alg == "stern_hash":
             return self._get_expected_stern(params_optimized)
@@ -41,6 +60,8 @@ class GetParams:
             return self._get_expected_fs_isd(params_optimized)
         elif alg == "MMT" or alg == "MMT_hash":
             return self._get_expected_mmt(params_optimized)
+        elif alg == "ball_collision":
+            return self._get_expected_ball_collision(params_optimized)
         else:
             raise ValueError(f"unknown alg {alg}")
         
@@ -49,7 +70,7 @@ if __name__ == "__main__":
     parser = ArgumentParser()
 
     parser.add_argument("input_data")
-    parser.add_argument("-a", "--algs", help="algs name", default="stern MMT FS_ISD stern_hash MMT_hash", required=False)
+    parser.add_argument("-a", "--algs", help="algs name", default="stern MMT FS_ISD stern_hash MMT_hash ball_collision", required=False)
 
     args = parser.parse_args()
 
@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+#include <nlohmann/json.hpp>
+
+#include <algebra/binary_matrix.hpp>
+#include <permutations/combination_iterator.hpp>
+#include <permutations/random_permutation_iterator.hpp>
+#include <stern_attack/base_decoding.hpp>
+#include <stern_attack/fs-isd_algorithm.hpp>
+#include <stern_attack/stern_algorithm.hpp>
+#include <utils/benchmark.hpp>
+
+#include "challenge_sizes.hpp"
+
+
+BinaryMatrix GenerateRandomMatrix(unsigned rows, unsigned cols, std::mt19937& gen) {
+    std::bernoulli_distribution d(0.5);
+
+    BinaryMatrix matrix;
+    for(unsigned rowIdx = 0; rowIdx < rows; ++rowIdx) {
+        BinaryMatrix::BitContainerType row(cols);
+        for(unsigned colIdx = 0; colIdx < cols; ++colIdx) {
+            row[colIdx] = d(gen);
+        }
+        matrix.addRow(row);
+    }
+
+    return matrix;
+}
+
+boost::dynamic_bitset<> GenerateRandomVector(unsigned size, std::mt19937& gen) {
+    std::bernoulli_distribution d(0.5);
+
+    boost::dynamic_bitset<> vector(size);
+    for(unsigned idx = 0; idx < size; ++idx) {
+        vector[idx] = d(gen);
+    }
+
+    return vector;
+}
+
+std::vector<unsigned> RandomIndexes(unsigned count, unsigned size, std::mt19937& gen) {
+    std::vector<unsigned> indexes(size);
+    std::iota(indexes.begin(), indexes.end(), 0);
+    std::shuffle(indexes.begin(), indexes.end(), gen);
+    indexes.resize(count);
+
+    return indexes;
+}
+
+int main(int argc, const char** argv) {
+    if(argc < 2) {
+        std::cerr << "usage: kernels <output json> [--sizes 381,640,...] [--samples N] [--warmup N] [--filter name]\n";
+        return 2;
+    }
+
+    std::vector<unsigned> sizes{381, 640, 1041, 1409, 3488};
+    unsigned samples = 31, warmupSamples = 3;
+    std::string filter;
+    for(int argIdx = 2; argIdx < argc; ++argIdx) {
+        const std::string option(argv[argIdx]);
+        if(argIdx + 1 == argc) {
+            std::cerr << "option " << option << " has no value\n";
+            return 2;
+        }
+        const std::string value(argv[++argIdx]);
+
+        if(option == "--sizes") {
+            sizes = ParseList(value);
+        } else if(option == "--samples") {
+            samples = std::stoul(value);
+        } else if(option == "--warmup") {
+            warmupSamples = std::stoul(value);
+        } else if(option == "--filter") {
+            filter = value;
+        } else {
+            std::cerr << "unknown option " << option << '\n';
+            return 2;
+        }
+    }
+
+    using json = nlohmann::json;
+    json data;
+    data["config"] = {{"samples", samples}, {"warmup", warmupSamples}, {"sizes", sizes}};
+    data["results"] = json::array();
+
+    const MicroBenchmark benchmark(samples, warmupSamples);
+
+    for(const unsigned cols: sizes) {
+        const unsigned rows = RowsFor(cols), k = cols - rows;
+        std::mt19937 gen(cols);
+
+        const BinaryMatrix checkMatrix = GenerateRandomMatrix(rows, cols, gen);
+        const boost::dynamic_bitset<> syndrome = GenerateRandomVector(rows, gen);
+        const boost::dynamic_bitset<> vector = GenerateRandomVector(cols, gen);
+        const auto [p, l] = SternAlgorithm(cols).getParams();
+        const auto columns = RandomIndexes(2 * p, k, gen);
+        const auto rowIndexes = RandomIndexes(2 * p, rows, gen);
+        const auto permutation = RandomPermutation(cols).Get(cols, 0);
+
+        BinaryMatrix eliminatedMatrix;
+        boost::dynamic_bitset<> eliminatedSyndrome;
+        const auto restore = [&]() {
+            eliminatedMatrix = checkMatrix;
+            eliminatedSyndrome = syndrome;
+        };
+
+        std::uint64_t index = 0;
+        const std::vector<std::pair<std::string, std::function<BenchmarkStatistics()>>> kernels{
+            {"sumOfColumns", [&]() {
+                return benchmark.Run([&]() { DoNotOptimize(checkMatrix.sumOfColumns(columns)); });
+            }},
+            {"sumOfRows", [&]() {
+                return benchmark.Run([&]() { DoNotOptimize(checkMatrix.sumOfRows(rowIndexes)); });
+            }},
+            {"applyPermutation", [&]() {
+                return benchmark.Run([&]() { DoNotOptimize(checkMatrix.applyPermutation(permutation)); });
+            }},
+            {"TransposeMatrix", [&]() {
+                BinaryMatrix matrix = checkMatrix;
+                return benchmark.Run([&]() { DoNotOptimize(matrix.TransposeMatrix(0, rows)); });
+            }},
+            {"GaussElimination", [&]() {
+                return benchmark.Run(restore, [&]() { DoNotOptimize(BinaryMatrix::GaussElimination(eliminatedMatrix, eliminatedSyndrome)); });
+            }},
+            {"PartialGaussElimination", [&]() {
+                return benchmark.Run(restore, [&]() { DoNotOptimize(PartialGaussElimination(eliminatedMatrix, eliminatedSyndrome, l)); });
+            }},
+            {"matVecMul", [&]() {
+                return benchmark.Run([&]() { DoNotOptimize(checkMatrix.matVecMul(vector)); });
+            }},
+            {"Projection", [&]() {
+                return benchmark.Run([&]() { DoNotOptimize(Projection(vector, k + l, k)); });
+            }},
+            {"Combination", [&]() {
+                // the first combinationsPerRun p-combinations of a half of information set, as in lists of Stern algorithm
+                constexpr unsigned combinationsPerRun = 1024;
+                return benchmark.Run([&]() {
+                    unsigned sum = 0, count = 0;
+                    for(auto combinationIter = Combination(p, k / 2).begin(); combinationIter.CombinationsStillExist() && count < combinationsPerRun;
+                        ++combinationIter, ++count) {
+                        sum += (*combinationIter)[0];
+                    }
+                    DoNotOptimize(sum);
+                });
+            }},
+            {"RandomPermutation", [&]() {
+                const RandomPermutation permutations(cols);
+                return benchmark.Run([&]() { DoNotOptimize(permutations.Get(cols, index++)); });
+            }},
+        };
+
+        for(const auto& [name, run]: kernels) {
+            if(!filter.empty() && name.find(filter) == std::string::npos) {
+                continue;
+            }
+
+            const auto statistics = run();
+            std::cout << std::left << std::setw(24) << name << " n = " << std::setw(5) << cols
+                      << " median " << std::setw(12) << statistics.medianNs << " ns, p90 " << statistics.p90Ns << " ns\n";
+
+            data["results"].push_back({
+                {"kernel", name},
+                {"n", cols},
+                {"k", k},
+                {"batch", statistics.batch},
+                {"samples", statistics.samples},
+                {"min_ns", statistics.minNs},
+                {"median_ns", statistics.medianNs},
+                {"mean_ns", statistics.meanNs},
+                {"p90_ns", statistics.p90Ns},
+                {"p99_ns", statistics.p99Ns},
+                {"max_ns", statistics.maxNs},
+            });
+        }
+    }
+
+    std::ofstream output(argv[1]);
+    output << std::setw(4) << data << '\n';
+}
@@ -0,0 +1,298 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+#include <nlohmann/json.hpp>
+
+#include <algebra/binary_matrix.hpp>
+#include <instances/text_format.hpp>
+#include <permutations/random_permutation_iterator.hpp>
+#include <stern_attack/base_decoding.hpp>
+#include <stern_attack/stern_algorithm.hpp>
+#include <stern_attack/new_stern_algorithm.hpp>
+#include <stern_attack/fs-isd_algorithm.hpp>
+#include <stern_attack/hash_mmt_algorithm.hpp>
+#include <stern_attack/ball_collision_algorithm.hpp>
+#include <stern_attack/information_set_decoding.hpp>
+
+#define STR(x) #x
+#define RETURN_STR_MACRO(x) STR(x)
+
+
+using json = nlohmann::json;
+using Metrics = std::map<std::string, double>;
+
+
+/// Instances of tests/test_data which are decoded by the gate
+const std::vector<std::string> instances{"small1", "small2", "medium1", "medium2", "medium3", "medium4"};
+
+/// Seeds of runs of every algorithm on every instance
+constexpr unsigned numberOfRuns = 20;
+
+/// Repeats of all runs for measurement of time
+constexpr unsigned numberOfRepeats = 10;
+
+/// Run which does not find the error vector in so many permutations is counted as failed
+constexpr std::uint64_t maxIterations = 100000;
+
+
+struct Instance {
+    BinaryMatrix checkMatrix;
+    boost::dynamic_bitset<> syndrome;
+    unsigned omega;
+};
+
+Instance ReadInstance(const std::string& name) {
+    const std::string directory = RETURN_STR_MACRO(TEST_DATA) + std::string("/") + name + "/";
+    Instance instance;
+    instance.checkMatrix = ReadTextMatrix(directory + "check_matrix.txt");
+    instance.syndrome = ReadTextVector(directory + "syndrome.txt");
+    instance.omega = ReadTextVector(directory + "error_vector.txt").count();
+
+    return instance;
+}
+
+
+/**
+ * Runs of algorithm with seeds 1, ..., numberOfRuns: the number of iterations is deterministic,
+ * so it changes only with behaviour of algorithm. Time of iteration is the least of repeats, see MeasureAllDecoding
+ */
+template <typename DecodingStepAlgorithm>
+void MeasureDecoding(Metrics& metrics, const std::string& prefix, const Instance& instance, const DecodingStepAlgorithm& algorithm) {
+    const unsigned cols = instance.checkMatrix.ColumnsSize();
+    std::uint64_t totalIterations = 0, failures = 0;
+    const auto start = std::chrono::steady_clock::now();
+
+    for(std::uint64_t seed = 1; seed <= numberOfRuns; ++seed) {
+        std::uint64_t iterations = 0;
+        bool isFound = false;
+
+        auto permutationIter = RandomPermutation(cols).begin(seed, 0, 1, NumberOfRandomPositions(algorithm, instance.checkMatrix));
+        for(; !isFound && iterations < maxIterations; ++permutationIter, ++iterations) {
+            BinaryMatrix permutedCheckMatrix = instance.checkMatrix.applyPermutation(*permutationIter);
+            auto syndrome = instance.syndrome;
+            isFound = algorithm(permutedCheckMatrix, syndrome, instance.omega).has_value();
+        }
+
+        totalIterations += iterations;
+        failures += !isFound;
+    }
+
+    const double durationNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    const std::string timeMetric = prefix + "/time_per_iteration_ns";
+    const double timeOfIteration = durationNs / totalIterations;
+
+    metrics[prefix + "/iterations"] = totalIterations;
+    metrics[prefix + "/failures"] = failures;
+    metrics[timeMetric] = metrics.contains(timeMetric) ? std::min(metrics[timeMetric], timeOfIteration) : timeOfIteration;
+}
+
+/**
+ * Repeats go over all instances and algorithms, so a slow period of the machine
+ * spoils only one repeat of every metric and the least time skips it
+ */
+Metrics MeasureAllDecoding() {
+    Metrics metrics;
+    std::vector<std::pair<std::string, Instance>> testInstances;
+    for(const auto& name: instances) {
+        testInstances.emplace_back(name, ReadInstance(name));
+    }
+
+    for(unsigned repeat = 0; repeat < numberOfRepeats; ++repeat) {
+        for(const auto& [name, instance]: testInstances) {
+            const unsigned rows = instance.checkMatrix.RowsSize(), cols = instance.checkMatrix.ColumnsSize();
+            const std::string prefix = "decoding/" + name + "/";
+
+            MeasureDecoding(metrics, prefix + "stern", instance, SternAlgorithm(cols));
+            MeasureDecoding(metrics, prefix + "stern_hash", instance, NewSternAlgorithm(cols));
+            MeasureDecoding(metrics, prefix + "FS_ISD", instance, FS_ISD_Algorithm(cols));
+            MeasureDecoding(metrics, prefix + "ball_collision", instance, BallCollisionAlgorithm(cols));
+            MeasureDecoding(metrics, prefix + "ISD", instance, InformationSetDecoding(cols));
+
+            // MMT needs 2p errors in each half of extended information set
+            if(std::isfinite(MMTHashAlgorithm(cols, rows).ExpectedIterations(rows, cols, instance.omega))) {
+                MeasureDecoding(metrics, prefix + "MMT_hash", instance, MMTHashAlgorithm(cols, rows));
+            }
+        }
+    }
+
+    return metrics;
+}
+
+/// Median time of every kernel and size of the report of benchmark/kernels
+Metrics ReadKernels(const std::string& file) {
+    std::ifstream input(file);
+    if(!input) {
+        throw std::runtime_error("report of kernels " + file + " is not found");
+    }
+
+    Metrics metrics;
+    for(const auto& result: json::parse(input)["results"]) {
+        metrics["kernels/" + result["kernel"].get<std::string>() + "/" + std::to_string(result["n"].get<unsigned>()) + "/median_ns"] = result["median_ns"];
+    }
+
+    return metrics;
+}
+
+
+/**
+ * Tolerances are relative increases of metrics: "time" is for metrics in nanoseconds, "count" for others,
+ * "metrics" overrides tolerance of single metrics. Decreases are improvements and never fail
+ */
+struct Tolerances {
+    double time = 0.35;
+    double count = 0;
+    std::map<std::string, double> metrics;
+
+    static bool IsTime(const std::string& metric) {
+        return metric.ends_with("_ns");
+    }
+
+    double For(const std::string& metric) const {
+        if(const auto iter = metrics.find(metric); iter != metrics.end()) {
+            return iter->second;
+        }
+
+        return IsTime(metric) ? time : count;
+    }
+
+    static Tolerances FromJson(const json& data) {
+        Tolerances tolerances;
+        tolerances.time = data.value("time", tolerances.time);
+        tolerances.count = data.value("count", tolerances.count);
+        tolerances.metrics = data.value("metrics", std::map<std::string, double>());
+
+        return tolerances;
+    }
+
+    json ToJson() const {
+        return {{"time", time}, {"count", count}, {"metrics", metrics}};
+    }
+};
+
+
+/**
+ * Prints the per-metric diff of current metrics against the baseline
+ * @return true if no metric regressed or disappeared
+ */
+bool Compare(const Metrics& baseline, const Metrics& current, const Tolerances& tolerances) {
+    bool isPassed = true;
+    unsigned numberOfRegressions = 0, numberOfImprovements = 0;
+
+    std::cout << std::left << std::setw(56) << "metric" << std::right << std::setw(14) << "baseline" << std::setw(14) << "current"
+              << std::setw(10) << "change" << std::setw(11) << "tolerance" << "  status\n";
+
+    for(const auto& [metric, baselineValue]: baseline) {
+        const auto iter = current.find(metric);
+        if(iter == current.end()) {
+            std::cout << std::left << std::setw(56) << metric << std::right << std::setw(14) << baselineValue << std::setw(14) << "-"
+                      << std::setw(10) << "-" << std::setw(11) << "-" << "  MISSING\n";
+            isPassed = false;
+            continue;
+        }
+
+        const double currentValue = iter->second;
+        const double tolerance = tolerances.For(metric);
+        const double change = baselineValue != 0 ? (currentValue - baselineValue) / baselineValue : (currentValue != 0 ? INFINITY : 0);
+
+        std::string status = "ok";
+        if(change > tolerance) {
+            status = "REGRESSION";
+            ++numberOfRegressions;
+            isPassed = false;
+        } else if(change < -tolerance) {
+            status = "improved";
+            ++numberOfImprovements;
+        }
+
+        std::ostringstream changeText;
+        changeText << std::showpos << std::fixed << std::setprecision(1) << change * 100 << '%';
+
+        std::cout << std::left << std::setw(56) << metric << std::right << std::setw(14) << baselineValue << std::setw(14) << currentValue
+                  << std::setw(10) << changeText.str() << std::setw(10) << tolerance * 100 << "%  " << status << '\n';
+    }
+
+    for(const auto& [metric, currentValue]: current) {
+        if(!baseline.contains(metric)) {
+            std::cout << std::left << std::setw(56) << metric << std::right << std::setw(14) << "-" << std::setw(14) << currentValue
+                      << std::setw(10) << "-" << std::setw(11) << "-" << "  new (refresh the baseline)\n";
+        }
+    }
+
+    std::cout << '\n' << baseline.size() << " metrics, " << numberOfRegressions << " regressions, " << numberOfImprovements << " improvements\n";
+    return isPassed;
+}
+
+
+int main(int argc, const char** argv) {
+    if(argc < 3) {
+        std::cerr << "usage: regression <baseline json> <kernels json> [--update] [--tolerance time|count|<metric>=<value>]...\n"
+                     "compares fixed-seed decoding of tests/test_data and the report of benchmark/kernels with the baseline,\n"
+                     "--update writes current metrics to the baseline instead\n";
+        return 2;
+    }
+
+    const std::string baselineFile = argv[1], kernelsFile = argv[2];
+    bool isUpdate = false;
+    std::map<std::string, double> toleranceOverrides;
+
+    for(int argIdx = 3; argIdx < argc; ++argIdx) {
+        const std::string option(argv[argIdx]);
+        if(option == "--update") {
+            isUpdate = true;
+        } else if(option == "--tolerance" && argIdx + 1 < argc) {
+            const std::string value(argv[++argIdx]);
+            const auto separator = value.find('=');
+            if(separator == std::string::npos) {
+                std::cerr << "tolerance should be <name>=<value>\n";
+                return 2;
+            }
+            toleranceOverrides[value.substr(0, separator)] = std::stod(value.substr(separator + 1));
+        } else {
+            std::cerr << "unknown option " << option << '\n';
+            return 2;
+        }
+    }
+
+    json baseline = json::object();
+    if(std::ifstream input(baselineFile); input) {
+        baseline = json::parse(input);
+    } else if(!isUpdate) {
+        std::cerr << "baseline " << baselineFile << " is not found, create it by --update\n";
+        return 2;
+    }
+
+    Tolerances tolerances = Tolerances::FromJson(baseline.value("tolerances", json::object()));
+    for(const auto& [name, value]: toleranceOverrides) {
+        if(name == "time") {
+            tolerances.time = value;
+        } else if(name == "count") {
+            tolerances.count = value;
+        } else {
+            tolerances.metrics[name] = value;
+        }
+    }
+
+    Metrics current = MeasureAllDecoding();
+    current.merge(ReadKernels(kernelsFile));
+
+    if(isUpdate) {
+        std::filesystem::create_directories(std::filesystem::path(baselineFile).parent_path());
+        std::ofstream output(baselineFile);
+        output << std::setw(4) << json{{"tolerances", tolerances.ToJson()}, {"metrics", current}} << '\n';
+        std::cout << "baseline " << baselineFile << " is updated with " << current.size() << " metrics\n";
+        return 0;
+    }
+
+    return Compare(baseline.value("metrics", Metrics()), current, tolerances) ? 0 : 1;
+}
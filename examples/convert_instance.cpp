@@ -0,0 +1,39 @@
+#include <iostream>
+#include <string>
+
+#include <instances/packed_format.hpp>
+#include <instances/text_format.hpp>
+
+
+int main(int argc, char** argv) {
+    if(argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <instance directory> <output file> [--omega w] [--columns] [--systematic]\n"
+                  << "converts check_matrix.txt, syndrome.txt and error_vector.txt (if it exists) to the packed format,\n"
+                  << "--omega stores the weight of error of instances without error vector, --columns packs columns\n"
+                  << "of the check matrix instead of rows, --systematic precomputes the systematic form\n";
+        return -1;
+    }
+
+    PackedWriteOptions options;
+    for(int argIdx = 3; argIdx < argc; ++argIdx) {
+        const std::string arg(argv[argIdx]);
+        if(arg == "--omega" && argIdx + 1 < argc) {
+            options.omega = std::stoul(argv[++argIdx]);
+        } else if(arg == "--columns") {
+            options.layout = PackedLayout::Columns;
+        } else if(arg == "--systematic") {
+            options.withSystematicForm = true;
+        } else {
+            std::cerr << "unknown option " << arg << '\n';
+            return -1;
+        }
+    }
+
+    const auto instance = LoadInstance(argv[1]);
+    SavePackedInstance(instance, argv[2], options);
+
+    const auto packed = LoadPackedInstance(argv[2]);
+    std::cout << "instance n = " << packed.header.n << ", k = " << packed.header.k << ", omega = " << packed.header.omega
+              << (packed.header.layout == PackedLayout::Rows ? ", rows" : ", columns")
+              << (packed.systematicMatrix ? ", with systematic form" : "") << " is written to " << argv[2] << '\n';
+}
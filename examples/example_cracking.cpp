@@ -4,71 +4,103 @@
 #include <fstream>
 #include <cassert>
 #include <iostream>
+#include <thread>
+#include <chrono>
+#include <limits>
+#include <numeric>
 #include <boost/dynamic_bitset.hpp>
 
 #include <algebra/binary_matrix.hpp>
+#include <instances/packed_format.hpp>
+#include <instances/systematic_instance.hpp>
+#include <instances/text_format.hpp>
 
 #include <stern_attack/mmt_algorithm.hpp>
 #include <stern_attack/hash_mmt_algorithm.hpp>
 #include <stern_attack/stern_algorithm.hpp>
 #include <stern_attack/information_set_decoding.hpp>
+#include <stern_attack/decoding_pool.hpp>
+#include <stern_attack/checkpoint.hpp>
+#include <stern_attack/memory_accounting.hpp>
+#include <stern_attack/parameter_optimizer.hpp>
+#include <stern_attack/progress_reporting.hpp>
+#include <stern_attack/systematic_decoding.hpp>
 
 #include <utils/benchmark.hpp>
 
 
-std::vector<std::string> ReadLinesFromFile(const std::string& file) {
-    assert(std::filesystem::exists(file));
-
-    std::ifstream ifs(file);
-    std::vector<std::string> lines;
-    std::string line;
-
-    while(std::getline(ifs, line)) {
-        lines.push_back(line);
-    }
-
-    return lines;
-}
-
 int main(int argc, char** argv) {
-    if(argc != 3) {
-        std::cerr << "provide a path to the data and number of errors\n";
+    if(argc != 3 && argc != 4) {
+        std::cerr << "provide a path to the data (a directory of text files or a file in the packed format), "
+                     "number of errors and optionally a memory budget of lists in MiB\n";
         return -1;
     }
 
-    std::string directory(argv[1]);
-    directory += '/';
+    const std::filesystem::path data(argv[1]);
+    const bool isPacked = std::filesystem::is_regular_file(data);
+    // checkpoint and error vector are written next to the data
+    const std::filesystem::path directory = isPacked ? data.parent_path() : data;
     unsigned omega = std::atoi(argv[2]);
-
-    auto inputDataForMatrix = ReadLinesFromFile(directory + "check_matrix.txt");
-    auto inputDataForSyndrome = ReadLinesFromFile(directory + "syndrome.txt");
-
-    BinaryMatrix checkMatrix;
-    for(auto& line: inputDataForMatrix) {
-        std::reverse(line.begin(), line.end());
-        checkMatrix.addRow(line);
+    if(argc == 4) {
+        MemoryAccounting::SetBudget(std::stoull(argv[3]) << 20);
     }
 
-    std::reverse(inputDataForSyndrome.front().begin(), inputDataForSyndrome.front().end());
-    boost::dynamic_bitset<> syndrome(inputDataForSyndrome.front());
-
-    auto launchAndBenchmark = [&checkMatrix, &syndrome, &omega](auto algorithm){
-        std::string name = std::string(algorithm.algorithmName) + std::to_string(checkMatrix.ColumnsSize());
-        Timer timer(name);
-
-        return Decoding(checkMatrix, syndrome, omega, algorithm);
+    // killed attack is resumed from the last checkpoint on restart,
+    // firstInformationSet is the eliminated information set of the instance if it is known
+    const std::string checkpointFile = (directory / "checkpoint.txt").string();
+    auto launchAndBenchmark = [&omega, &checkpointFile](const auto& checkMatrix, const boost::dynamic_bitset<>& syndrome, auto... firstInformationSet){
+        // parameters are chosen for the instance on this machine instead of fixed fractions of its size
+        const auto algorithm = MakeOptimizedAlgorithm<MMTHashAlgorithm>(checkMatrix, syndrome, omega);
+        boost::dynamic_bitset<> errorVector;
+        {
+            std::string name = std::string(algorithm.algorithmName) + std::to_string(checkMatrix.ColumnsSize());
+            Timer timer(name);
+
+            // attack takes hours, so its progress is reported every minute
+            const ProgressOptions progress{.interval = std::chrono::seconds(60)};
+            errorVector = DecodingWithCheckpoints(checkMatrix, syndrome, omega, algorithm, std::move(firstInformationSet)..., checkpointFile,
+                                                  std::chrono::seconds(60), std::numeric_limits<std::uint64_t>::max(), progress);
+        }
+
+        std::cout << "peak memory of lists: " << (algorithm.MemoryOfLists().peakBytes >> 20) << " MiB\n";
+        return errorVector;
     };
 
-    auto launchAndBenchmarkParallel = [&checkMatrix, &syndrome, &omega](auto algorithm){
-        std::string name = algorithm.algorithmName + std::string("(parallel ") + std::to_string(std::thread::hardware_concurrency()) + ")" + std::to_string(checkMatrix.ColumnsSize());
+    // the pool spawns and pins its threads, so it is created only if the attack is parallel
+    auto launchAndBenchmarkParallel = [&omega](BinaryMatrix& checkMatrix, boost::dynamic_bitset<>& syndrome, auto algorithm){
+        DecodingPool pool(std::thread::hardware_concurrency());
+        std::string name = algorithm.algorithmName + std::string("(parallel ") + std::to_string(pool.NumberOfThreads()) + ")" + std::to_string(checkMatrix.ColumnsSize());
         Timer timer(name);
 
-        return DecodingParallel(checkMatrix, syndrome, omega, algorithm, std::thread::hardware_concurrency());
+        const ProgressOptions progress{.interval = std::chrono::seconds(60)};
+        return DecodingParallel(checkMatrix, syndrome, omega, algorithm, pool, progress);
     };
 
-    boost::dynamic_bitset<> errorVectorFromMMT = launchAndBenchmark(MMTHashAlgorithm(checkMatrix.ColumnsSize(), checkMatrix.RowsSize()));
-    std::ofstream ofs(directory + "error_vector.txt");
+    boost::dynamic_bitset<> errorVectorFromMMT;
+    if(isPacked) {
+        // the file is mapped, its stored systematic form [Q' | I] of the unpermuted check matrix is searched
+        // by the first iteration without gauss elimination
+        const auto instance = LoadPackedInstance(data.string());
+        const BinaryMatrix checkMatrix = instance.CheckMatrix();
+        const auto syndrome = instance.syndrome.RowBits(0);
+        if(auto columns = instance.SystematicColumns()) {
+            std::vector<unsigned> identity(checkMatrix.ColumnsSize());
+            std::iota(identity.begin(), identity.end(), 0);
+            errorVectorFromMMT = launchAndBenchmark(checkMatrix, syndrome,
+                                                    EliminatedInformationSet{std::move(identity), std::move(*columns), instance.systematicSyndrome->RowBits(0)});
+        } else {
+            errorVectorFromMMT = launchAndBenchmark(checkMatrix, syndrome);
+        }
+    } else if(auto systematicInstance = LoadSystematicInstance(directory.string())) {
+        // challenge check matrices are [I | Q]: only Q is kept and the first iteration skips gauss elimination
+        errorVectorFromMMT = launchAndBenchmark(systematicInstance->checkMatrix, systematicInstance->syndrome);
+    } else {
+        const auto instance = LoadInstance(directory.string());
+        errorVectorFromMMT = launchAndBenchmark(instance.checkMatrix, instance.syndrome);
+    }
+
+    std::ofstream ofs(directory / "error_vector.txt");
     ofs << errorVectorFromMMT << '\n';
 
     std::cout << "resulting error vector:\n" << errorVectorFromMMT << '\n';
-}
\ No newline at end of file
+}
@@ -0,0 +1,56 @@
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <fstream>
+#include <cassert>
+#include <iostream>
+#include <boost/dynamic_bitset.hpp>
+
+#include <algebra/binary_matrix.hpp>
+#include <instances/text_format.hpp>
+
+#include <stern_attack/hash_mmt_algorithm.hpp>
+#include <stern_attack/distributed_decoding.hpp>
+
+#include <utils/benchmark.hpp>
+
+
+int main(int argc, char** argv) {
+    const std::string mode = argc > 1 ? argv[1] : "";
+    if(!((mode == "coordinator" && argc == 5) || (mode == "worker" && argc == 6))) {
+        std::cerr << "usage:\n"
+                  << "\t" << argv[0] << " coordinator <path to the data> <number of errors> <port>\n"
+                  << "\t" << argv[0] << " worker <path to the data> <number of errors> <host> <port>\n";
+        return -1;
+    }
+
+    std::string directory(argv[2]);
+    directory += '/';
+    unsigned omega = std::atoi(argv[3]);
+
+    BinaryMatrix checkMatrix = ReadTextMatrix(directory + "check_matrix.txt");
+    boost::dynamic_bitset<> syndrome = ReadTextVector(directory + "syndrome.txt");
+
+    if(mode == "worker") {
+        auto numberOfIterations = DecodingWorker(argv[4], std::atoi(argv[5]), checkMatrix, syndrome, omega,
+                                                 MMTHashAlgorithm(checkMatrix.ColumnsSize(), checkMatrix.RowsSize()));
+        std::cout << "worker made " << numberOfIterations << " iterations\n";
+        return 0;
+    }
+
+    DecodingCoordinator coordinator(checkMatrix, syndrome, omega, std::atoi(argv[4]));
+    std::cout << "coordinator listens on port " << coordinator.Port() << '\n';
+
+    boost::dynamic_bitset<> errorVector;
+    {
+        Timer timer("distributed decoding " + std::to_string(checkMatrix.ColumnsSize()));
+        errorVector = coordinator.Run();
+    }
+
+    std::cout << "workers: " << coordinator.NumberOfWorkers() << ",\tnumber of iterations: " << coordinator.NumberOfIterations() << '\n';
+
+    std::ofstream ofs(directory + "error_vector.txt");
+    ofs << errorVector << '\n';
+
+    std::cout << "resulting error vector:\n" << errorVector << '\n';
+}
@@ -0,0 +1,27 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include <instances/instance_generator.hpp>
+
+
+int main(int argc, char** argv) {
+    const bool isRandom = argc > 1 && std::string(argv[argc - 1]) == "--random";
+    const int numberOfArguments = argc - isRandom;
+    if(numberOfArguments != 5 && numberOfArguments != 6) {
+        std::cerr << "usage: " << argv[0] << " <output directory> <n> <k> <number of errors> [seed] [--random]\n"
+                  << "writes check_matrix.txt, syndrome.txt and error_vector.txt of a random instance with planted error,\n"
+                  << "check matrix is [I | Q] unless --random is given\n";
+        return -1;
+    }
+
+    const std::string directory(argv[1]);
+    const unsigned n = std::stoul(argv[2]), k = std::stoul(argv[3]), omega = std::stoul(argv[4]);
+    const std::uint64_t seed = numberOfArguments == 6 ? std::stoull(argv[5]) : 1;
+
+    const auto instance = GenerateInstance(n, k, omega, seed, !isRandom);
+    SaveInstance(instance, directory);
+
+    std::cout << "instance n = " << n << ", k = " << k << ", omega = " << omega << ", seed = " << seed
+              << (isRandom ? ", random" : ", systematic") << " check matrix is written to " << directory << '\n';
+}
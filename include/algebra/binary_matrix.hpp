@@ -33,7 +33,7 @@ public:
         }
     }
 
-    BinaryMatrix applyPermutation(const std::vector<unsigned>& permutation) {
+    BinaryMatrix applyPermutation(const std::vector<unsigned>& permutation) const {
         // assert(permutation.size() == ColumnsSize());
 
         DataType permutedMatrix = getData();
@@ -60,11 +60,15 @@ public:
         return matrix;
     }
 
+    const DataType& getData() const {
+        return matrix;
+    }
+
     BitContainerType& operator[](size_type pos){
         return matrix[pos];
     }
 
-    bool operator==(const BinaryMatrix& rhs){
+    bool operator==(const BinaryMatrix& rhs) const {
         return rhs.matrix == matrix;
     }
 
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <algebra/binary_matrix.hpp>
+
+
+/**
+ * Binary matrix which rows are stored as contiguous 64-bit words.
+ * Bit j of a row lives in word j / 64 at position j % 64, i.e. in the same order
+ * as in boost::dynamic_bitset, so rows can be copied block by block.
+ * The matrix either owns its words or is a view of words owned by somebody else (e.g. a mapped file),
+ * rows of a view may be padded, so consecutive rows are stride words apart
+ */
+class PackedMatrix {
+public:
+    using WordType = std::uint64_t;
+    using size_type = std::size_t;
+
+    static constexpr unsigned bitsPerWord = std::numeric_limits<WordType>::digits;
+
+private:
+    unsigned rows = 0;
+    unsigned cols = 0;
+    size_type wordsPerRow = 0;
+    size_type stride = 0;
+    std::vector<WordType> data;
+    /// Owner of words of a view, empty if the matrix owns its words
+    std::shared_ptr<void> external;
+    WordType* words = nullptr;
+
+    /**
+     * Transposes 64x64 bit block in place (bit c of word r goes to bit r of word c)
+     */
+    static void TransposeBlock(std::array<WordType, bitsPerWord>& block) {
+        WordType mask = 0x00000000FFFFFFFFull;
+
+        for(unsigned width = bitsPerWord / 2; width != 0; width >>= 1, mask ^= (mask << width)) {
+            for(unsigned idx = 0; idx < bitsPerWord; idx = ((idx | width) + 1) & ~width) {
+                WordType swapped = ((block[idx] >> width) ^ block[idx | width]) & mask;
+                block[idx] ^= swapped << width;
+                block[idx | width] ^= swapped;
+            }
+        }
+    }
+
+public:
+    PackedMatrix() = default;
+
+    PackedMatrix(unsigned rows, unsigned cols): rows(rows), cols(cols), wordsPerRow(WordsFor(cols)), stride(wordsPerRow),
+                                                data(rows * wordsPerRow), words(data.data()) {}
+
+    /// Copy of a view owns a copy of its rows, so copies never change the viewed words
+    PackedMatrix(const PackedMatrix& other): PackedMatrix(other.rows, other.cols) {
+        for(unsigned rowIdx = 0; rowIdx < rows; ++rowIdx) {
+            std::copy_n(other.Row(rowIdx), wordsPerRow, Row(rowIdx));
+        }
+    }
+
+    PackedMatrix(PackedMatrix&& other) noexcept {
+        swap(other);
+    }
+
+    PackedMatrix& operator=(PackedMatrix other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    void swap(PackedMatrix& other) noexcept {
+        std::swap(rows, other.rows);
+        std::swap(cols, other.cols);
+        std::swap(wordsPerRow, other.wordsPerRow);
+        std::swap(stride, other.stride);
+        data.swap(other.data);
+        external.swap(other.external);
+        std::swap(words, other.words);
+    }
+
+    /**
+     * Matrix over words which it does not own, nothing is copied
+     * @param words the first word of the first row
+     * @param stride number of words between beginnings of rows, at least WordsFor(cols)
+     * @param owner keeps words alive while the view and its moved instances exist
+     */
+    static PackedMatrix View(WordType* words, unsigned rows, unsigned cols, size_type stride, std::shared_ptr<void> owner) {
+        assert(stride >= WordsFor(cols));
+
+        PackedMatrix view;
+        view.rows = rows;
+        view.cols = cols;
+        view.wordsPerRow = WordsFor(cols);
+        view.stride = stride;
+        view.external = std::move(owner);
+        view.words = words;
+
+        return view;
+    }
+
+    /// Another view of the words of this view which shares their owner, nothing is copied
+    PackedMatrix SharedView() const {
+        assert(IsView());
+        return View(words, rows, cols, stride, external);
+    }
+
+    /**
+     * Packs rows of the matrix, bits are copied by blocks of boost::dynamic_bitset
+     * @param matrix matrix to be packed
+     */
+    explicit PackedMatrix(const BinaryMatrix& matrix): PackedMatrix(matrix.RowsSize(), matrix.RowsSize() ? matrix.ColumnsSize() : 0) {
+        static_assert(sizeof(BinaryMatrix::BitContainerType::block_type) == sizeof(WordType));
+
+        for(unsigned rowIdx = 0; rowIdx < rows; ++rowIdx) {
+            boost::to_block_range(matrix.getData()[rowIdx], Row(rowIdx));
+        }
+    }
+
+    static size_type WordsFor(unsigned bits) {
+        return (bits + bitsPerWord - 1) / bitsPerWord;
+    }
+
+    unsigned RowsSize() const {
+        return rows;
+    }
+
+    unsigned ColumnsSize() const {
+        return cols;
+    }
+
+    size_type WordsPerRow() const {
+        return wordsPerRow;
+    }
+
+    size_type Stride() const {
+        return stride;
+    }
+
+    bool IsView() const {
+        return external != nullptr;
+    }
+
+    WordType* Row(unsigned idx) {
+        return words + idx * stride;
+    }
+
+    const WordType* Row(unsigned idx) const {
+        return words + idx * stride;
+    }
+
+    /// Row as a bitset of ColumnsSize() bits
+    BinaryMatrix::BitContainerType RowBits(unsigned idx) const {
+        BinaryMatrix::BitContainerType row(Row(idx), Row(idx) + wordsPerRow);
+        row.resize(cols);
+        return row;
+    }
+
+    /// Rows as a BinaryMatrix, which algorithms of decoding take
+    BinaryMatrix ToBinaryMatrix() const {
+        BinaryMatrix::DataType matrixRows;
+        matrixRows.reserve(rows);
+        for(unsigned rowIdx = 0; rowIdx < rows; ++rowIdx) {
+            matrixRows.push_back(RowBits(rowIdx));
+        }
+
+        return BinaryMatrix(std::move(matrixRows));
+    }
+
+    bool Get(unsigned row, unsigned col) const {
+        return (Row(row)[col / bitsPerWord] >> (col % bitsPerWord)) & 1;
+    }
+
+    void Set(unsigned row, unsigned col) {
+        Row(row)[col / bitsPerWord] |= WordType(1) << (col % bitsPerWord);
+    }
+
+    /**
+     * Extracts bits [start, start + length) of the row into one word
+     * @param row index of row
+     * @param start index of the first bit
+     * @param length number of bits, should not exceed 64
+     * @return word which bit i is equal to bit (start + i) of the row
+     */
+    WordType Window(unsigned row, unsigned start, unsigned length) const {
+        assert(length <= bitsPerWord && start + length <= cols);
+
+        const WordType* rowWords = Row(row);
+        const size_type word = start / bitsPerWord;
+        const unsigned offset = start % bitsPerWord;
+
+        WordType value = rowWords[word] >> offset;
+        if(offset != 0 && word + 1 < wordsPerRow) {
+            value |= rowWords[word + 1] << (bitsPerWord - offset);
+        }
+
+        return length == bitsPerWord ? value : value & ((WordType(1) << length) - 1);
+    }
+
+    /**
+     * Transposes matrix by 64x64 blocks
+     * @return matrix which row i is the column i of this matrix
+     */
+    PackedMatrix Transposed() const {
+        PackedMatrix transposed(cols, rows);
+        std::array<WordType, bitsPerWord> block;
+
+        for(unsigned rowBlock = 0; rowBlock < rows; rowBlock += bitsPerWord) {
+            const unsigned rowsInBlock = std::min(bitsPerWord, rows - rowBlock);
+
+            for(size_type wordIdx = 0; wordIdx < wordsPerRow; ++wordIdx) {
+                for(unsigned idx = 0; idx < bitsPerWord; ++idx) {
+                    block[idx] = idx < rowsInBlock ? Row(rowBlock + idx)[wordIdx] : 0;
+                }
+
+                TransposeBlock(block);
+
+                const unsigned colBlock = wordIdx * bitsPerWord;
+                const unsigned colsInBlock = std::min(bitsPerWord, cols - colBlock);
+                for(unsigned idx = 0; idx < colsInBlock; ++idx) {
+                    transposed.Row(colBlock + idx)[rowBlock / bitsPerWord] = block[idx];
+                }
+            }
+        }
+
+        return transposed;
+    }
+
+    /// Equal sizes and bits, strides and ownership of words do not matter
+    bool operator==(const PackedMatrix& rhs) const {
+        if(rows != rhs.rows || cols != rhs.cols) {
+            return false;
+        }
+
+        for(unsigned rowIdx = 0; rowIdx < rows; ++rowIdx) {
+            if(!std::equal(Row(rowIdx), Row(rowIdx) + wordsPerRow, rhs.Row(rowIdx))) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+};
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <algebra/binary_matrix.hpp>
+#include <algebra/packed_matrix.hpp>
+
+
+/**
+ * Check matrix in systematic form H = [I | Q] (as challenge instances), only the redundant block Q
+ * of (n - k) x k bits is stored, the identity block is implied. Column j of H is the unit vector e_j
+ * for j < n - k and column j - (n - k) of Q otherwise
+ */
+class SystematicMatrix {
+    PackedMatrix redundancy;
+
+public:
+    SystematicMatrix() = default;
+
+    /// @param redundancy the block Q of (n - k) rows
+    explicit SystematicMatrix(PackedMatrix redundancy): redundancy(std::move(redundancy)) {}
+
+    /**
+     * Q of matrix if its first RowsSize() columns form the identity, i.e. the matrix is [I | Q]
+     * @return empty optional if the matrix is not in systematic form
+     */
+    static std::optional<SystematicMatrix> FromMatrix(const BinaryMatrix& matrix) {
+        const unsigned rows = matrix.RowsSize();
+        if(rows == 0 || rows >= matrix.ColumnsSize()) {
+            return std::nullopt;
+        }
+
+        PackedMatrix redundancy(rows, matrix.ColumnsSize() - rows);
+        for(unsigned rowIdx = 0; rowIdx < rows; ++rowIdx) {
+            const auto& row = matrix.getData()[rowIdx];
+            // the identity block of row holds the only bit rowIdx among the first rows bits
+            auto identity = row;
+            identity.resize(rows);
+            if(identity.count() != 1 || !identity[rowIdx]) {
+                return std::nullopt;
+            }
+
+            auto redundantBits = row >> rows;
+            redundantBits.resize(redundancy.ColumnsSize());
+            boost::to_block_range(redundantBits, redundancy.Row(rowIdx));
+        }
+
+        return SystematicMatrix(std::move(redundancy));
+    }
+
+    unsigned RowsSize() const {
+        return redundancy.RowsSize();
+    }
+
+    unsigned ColumnsSize() const {
+        return redundancy.RowsSize() + redundancy.ColumnsSize();
+    }
+
+    /// The block Q
+    const PackedMatrix& Redundancy() const {
+        return redundancy;
+    }
+
+    /// Row of [I | Q] as a bitset of ColumnsSize() bits
+    BinaryMatrix::BitContainerType RowBits(unsigned idx) const {
+        auto row = redundancy.RowBits(idx);
+        row.resize(ColumnsSize());
+        row <<= RowsSize();
+        row.set(idx);
+        return row;
+    }
+
+    bool Get(unsigned row, unsigned col) const {
+        return col < RowsSize() ? row == col : redundancy.Get(row, col - RowsSize());
+    }
+
+    /// [I | Q] with the identity block
+    BinaryMatrix ToBinaryMatrix() const {
+        std::vector<unsigned> identity(ColumnsSize());
+        std::iota(identity.begin(), identity.end(), 0);
+
+        return applyPermutation(identity);
+    }
+
+    /**
+     * Columns of the permuted check matrix, row colIdx of the result is column permutation[colIdx] of [I | Q].
+     * It is built without [I | Q], so the identity block never exists in memory: columns of Q
+     * are copied word by word, columns of the identity block are unit vectors
+     */
+    PackedMatrix PermutedColumns(const std::vector<unsigned>& permutation) const {
+        assert(permutation.size() == ColumnsSize());
+
+        const unsigned rows = RowsSize();
+        const PackedMatrix columnsOfRedundancy = redundancy.Transposed();
+
+        PackedMatrix permutedColumns(permutation.size(), rows);
+        for(unsigned colIdx = 0; colIdx < permutation.size(); ++colIdx) {
+            if(permutation[colIdx] < rows) {
+                permutedColumns.Set(colIdx, permutation[colIdx]);
+            } else {
+                std::copy_n(columnsOfRedundancy.Row(permutation[colIdx] - rows), columnsOfRedundancy.WordsPerRow(), permutedColumns.Row(colIdx));
+            }
+        }
+
+        return permutedColumns;
+    }
+
+    /**
+     * Permuted check matrix, column colIdx of the result is column permutation[colIdx] of [I | Q].
+     * PermutedColumns are transposed back by 64x64 blocks
+     */
+    BinaryMatrix applyPermutation(const std::vector<unsigned>& permutation) const {
+        return PermutedColumns(permutation).Transposed().ToBinaryMatrix();
+    }
+
+    /**
+     * Permutation which moves the identity block to the last RowsSize() columns, the permuted matrix
+     * [Q | I] is what BinaryMatrix::GaussElimination makes, so the syndrome is not changed
+     */
+    std::vector<unsigned> IdentityLastPermutation() const {
+        std::vector<unsigned> permutation(ColumnsSize());
+        std::iota(permutation.begin(), permutation.begin() + redundancy.ColumnsSize(), RowsSize());
+        std::iota(permutation.begin() + redundancy.ColumnsSize(), permutation.end(), 0);
+
+        return permutation;
+    }
+
+    /// H * x = x[0, n - k) + Q * x[n - k, n)
+    boost::dynamic_bitset<> matVecMul(const boost::dynamic_bitset<>& x) const {
+        assert(x.size() == ColumnsSize());
+
+        boost::dynamic_bitset<> result(x);
+        result.resize(RowsSize());
+        for(auto pos = x.find_next(RowsSize() - 1); pos != boost::dynamic_bitset<>::npos; pos = x.find_next(pos)) {
+            for(unsigned rowIdx = 0; rowIdx < RowsSize(); ++rowIdx) {
+                if(redundancy.Get(rowIdx, pos - RowsSize())) {
+                    result.flip(rowIdx);
+                }
+            }
+        }
+
+        return result;
+    }
+};
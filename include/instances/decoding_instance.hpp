@@ -0,0 +1,16 @@
+#pragma once
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <algebra/binary_matrix.hpp>
+
+
+/**
+ * Instance of syndrome decoding: check matrix H, syndrome s = H * e and the error vector e if it is known
+ */
+struct DecodingInstance {
+    BinaryMatrix checkMatrix;
+    boost::dynamic_bitset<> syndrome;
+    /// Empty if the error vector is unknown, e.g. of challenge instances
+    boost::dynamic_bitset<> errorVector;
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <algebra/binary_matrix.hpp>
+#include <instances/decoding_instance.hpp>
+#include <instances/text_format.hpp>
+#include <utils/philox.hpp>
+
+
+/// Streams of Philox4x32 of one seed, so check matrix of a seed does not depend on the weight of error
+enum class InstanceStream : std::uint64_t {
+    CheckMatrix = 0,
+    ErrorVector = 1
+};
+
+
+/**
+ * Random check matrix of a code of length n and dimension k, i.e. (n - k) x n. Words come from
+ * Philox4x32, so the matrix depends only on the seed and is the same on every platform
+ * @param isSystematic if true, the matrix is [I | Q] as challenge instances, it has full rank;
+ * otherwise all bits are random and the rank may be less than n - k
+ */
+BinaryMatrix GenerateCheckMatrix(unsigned n, unsigned k, std::uint64_t seed, bool isSystematic = true) {
+    if(k >= n) {
+        throw std::invalid_argument("dimension of code should be less than its length");
+    }
+
+    const unsigned rows = n - k;
+    Philox4x32 generator(seed, static_cast<std::uint64_t>(InstanceStream::CheckMatrix));
+
+    BinaryMatrix checkMatrix;
+    for(unsigned rowIdx = 0; rowIdx < rows; ++rowIdx) {
+        BinaryMatrix::BitContainerType row;
+        while(row.size() < n) {
+            // Q of systematic and random matrices of one seed is the same
+            const std::uint64_t low = generator();
+            row.append(static_cast<BinaryMatrix::BitContainerType::block_type>((static_cast<std::uint64_t>(generator()) << 32) | low));
+        }
+        row.resize(n);
+
+        if(isSystematic) {
+            for(unsigned colIdx = 0; colIdx < rows; ++colIdx) {
+                row[colIdx] = colIdx == rowIdx;
+            }
+        }
+
+        checkMatrix.addRow(row);
+    }
+
+    return checkMatrix;
+}
+
+/**
+ * Random error vector of length n and weight omega: the first omega steps of Fisher-Yates shuffle
+ */
+boost::dynamic_bitset<> GenerateErrorVector(unsigned n, unsigned omega, std::uint64_t seed) {
+    if(omega > n) {
+        throw std::invalid_argument("weight of error should not exceed length of code");
+    }
+
+    Philox4x32 generator(seed, static_cast<std::uint64_t>(InstanceStream::ErrorVector));
+    std::vector<unsigned> positions(n);
+    std::iota(positions.begin(), positions.end(), 0);
+
+    boost::dynamic_bitset<> errorVector(n);
+    for(unsigned idx = 0; idx < omega; ++idx) {
+        std::swap(positions[idx], positions[idx + BoundedRandom(generator, n - idx)]);
+        errorVector[positions[idx]] = true;
+    }
+
+    return errorVector;
+}
+
+/**
+ * Instance with planted error: random check matrix, random error vector of weight omega and its syndrome.
+ * For weights below the Gilbert-Varshamov distance the planted error is the only solution,
+ * so decoded error vectors are checked against it
+ * @param n length of code, number of columns
+ * @param k dimension of code, the matrix has n - k rows
+ * @param omega weight of error vector
+ * @param seed the instance is a function of (n, k, omega, seed, isSystematic)
+ * @param isSystematic see GenerateCheckMatrix
+ */
+DecodingInstance GenerateInstance(unsigned n, unsigned k, unsigned omega, std::uint64_t seed, bool isSystematic = true) {
+    DecodingInstance instance{GenerateCheckMatrix(n, k, seed, isSystematic), {}, GenerateErrorVector(n, omega, seed)};
+    instance.syndrome = instance.checkMatrix.matVecMul(instance.errorVector);
+
+    return instance;
+}
+
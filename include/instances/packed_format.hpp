@@ -0,0 +1,376 @@
+#pragma once
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algebra/binary_matrix.hpp>
+#include <algebra/packed_matrix.hpp>
+#include <instances/decoding_instance.hpp>
+
+
+/**
+ * Binary format of instances which is mapped into memory without parsing:
+ *
+ *   header (64 bytes) | matrix | syndrome | error vector (optional) | systematic matrix (optional) | its syndrome (optional)
+ *
+ * Every section begins at a multiple of 64 bytes, rows of matrices are padded to stride words,
+ * which is a multiple of 8, so every row begins at a cache line. Words are little-endian,
+ * bit j of a row is bit j % 64 of word j / 64, as in PackedMatrix
+ */
+namespace packed_format {
+
+inline constexpr std::array<char, 8> magic = {'S', 'D', 'P', 'A', 'C', 'K', 'E', 'D'};
+inline constexpr std::uint32_t version = 1;
+inline constexpr std::size_t alignment = 64;
+inline constexpr std::size_t wordsPerLine = alignment / sizeof(PackedMatrix::WordType);
+
+}
+
+
+/// Which vectors are the packed rows of the matrix section
+enum class PackedLayout : std::uint32_t {
+    /// Rows of the (n - k) x n check matrix
+    Rows = 0,
+    /// Columns of the check matrix, i.e. rows of its transpose, as ISDEngine keeps them
+    Columns = 1
+};
+
+enum PackedFlags : std::uint32_t {
+    HasErrorVector = 1,
+    /// Result of BinaryMatrix::GaussElimination of the check matrix and syndrome, i.e. [Q' | I]
+    HasSystematicForm = 2
+};
+
+struct PackedHeader {
+    std::array<char, 8> magic = packed_format::magic;
+    std::uint32_t version = packed_format::version;
+    PackedLayout layout = PackedLayout::Rows;
+    /// Length of code
+    std::uint64_t n = 0;
+    /// Dimension of code, the check matrix has n - k rows
+    std::uint64_t k = 0;
+    /// Weight of error, zero if unknown
+    std::uint32_t omega = 0;
+    std::uint32_t flags = 0;
+    /// Words between beginnings of packed rows of matrices
+    std::uint64_t strideWords = 0;
+    std::array<std::uint64_t, 2> reserved = {};
+};
+
+static_assert(sizeof(PackedHeader) == packed_format::alignment);
+
+
+/**
+ * Instance in the packed format, matrices of a loaded file are views of the mapping,
+ * so the file is not copied and pages are read on first access
+ */
+struct PackedInstance {
+    PackedHeader header;
+    /// Check matrix in header.layout
+    PackedMatrix matrix;
+    /// 1 x (n - k)
+    PackedMatrix syndrome;
+    /// 1 x n
+    std::optional<PackedMatrix> errorVector;
+    /// Systematic form [Q' | I] of the check matrix in header.layout and the syndrome transformed with it
+    std::optional<PackedMatrix> systematicMatrix;
+    std::optional<PackedMatrix> systematicSyndrome;
+
+    unsigned Rows() const {
+        return header.n - header.k;
+    }
+
+    unsigned Cols() const {
+        return header.n;
+    }
+
+    /// Check matrix as rows, the layout is undone if needed. It copies the matrix
+    BinaryMatrix CheckMatrix() const {
+        return header.layout == PackedLayout::Rows ? matrix.ToBinaryMatrix() : matrix.Transposed().ToBinaryMatrix();
+    }
+
+    /**
+     * Columns of the systematic form as ISDContext keeps them. In the layout of columns they are
+     * a view of the mapping, so nothing is copied, rows are transposed
+     * @return empty optional if the systematic form is not stored
+     */
+    std::optional<PackedMatrix> SystematicColumns() const {
+        if(!systematicMatrix) {
+            return std::nullopt;
+        }
+        if(header.layout == PackedLayout::Rows) {
+            return systematicMatrix->Transposed();
+        }
+        if(systematicMatrix->IsView()) {
+            return systematicMatrix->SharedView();
+        }
+
+        return *systematicMatrix;
+    }
+
+    /// Check matrix, syndrome and error vector (if it is stored) as algorithms of decoding take them
+    DecodingInstance ToDecodingInstance() const {
+        return DecodingInstance{CheckMatrix(), syndrome.RowBits(0), errorVector ? errorVector->RowBits(0) : boost::dynamic_bitset<>()};
+    }
+};
+
+
+struct PackedWriteOptions {
+    PackedLayout layout = PackedLayout::Rows;
+    /// Weight of error to be stored if the instance has no error vector
+    unsigned omega = 0;
+    /// Store systematic form, it is skipped if BinaryMatrix::GaussElimination of the check matrix fails,
+    /// i.e. its last n - k columns are linearly dependent
+    bool withSystematicForm = false;
+};
+
+
+namespace packed_format {
+
+inline std::size_t RoundUp(std::size_t words) {
+    return (words + wordsPerLine - 1) / wordsPerLine * wordsPerLine;
+}
+
+/// Number of packed rows and their length in bits of the matrix section
+inline std::pair<unsigned, unsigned> MatrixShape(const PackedHeader& header) {
+    const unsigned rows = header.n - header.k;
+    return header.layout == PackedLayout::Rows ? std::make_pair(rows, unsigned(header.n)) : std::make_pair(unsigned(header.n), rows);
+}
+
+/// Product of sizes, empty optional if it overflows std::size_t
+inline std::optional<std::size_t> CheckedMultiply(std::size_t lhs, std::size_t rhs) {
+    if(rhs != 0 && lhs > std::numeric_limits<std::size_t>::max() / rhs) {
+        return std::nullopt;
+    }
+    return lhs * rhs;
+}
+
+/// Words of one matrix section, the header should pass FileWords
+inline std::size_t MatrixWords(const PackedHeader& header) {
+    return MatrixShape(header).first * header.strideWords;
+}
+
+/**
+ * Size of the file in words, the header included. Sizes are read from files,
+ * so the sum is checked for overflow
+ * @return empty optional if the size overflows std::size_t
+ */
+inline std::optional<std::size_t> FileWords(const PackedHeader& header) {
+    const auto matrixWords = CheckedMultiply(MatrixShape(header).first, header.strideWords);
+    if(!matrixWords) {
+        return std::nullopt;
+    }
+
+    const std::size_t syndromeWords = RoundUp(PackedMatrix::WordsFor(header.n - header.k));
+    std::vector<std::size_t> sections{wordsPerLine, *matrixWords, syndromeWords};
+    if(header.flags & HasErrorVector) {
+        sections.push_back(RoundUp(PackedMatrix::WordsFor(header.n)));
+    }
+    if(header.flags & HasSystematicForm) {
+        sections.push_back(*matrixWords);
+        sections.push_back(syndromeWords);
+    }
+
+    std::size_t total = 0;
+    for(const auto words: sections) {
+        if(words > std::numeric_limits<std::size_t>::max() - total) {
+            return std::nullopt;
+        }
+        total += words;
+    }
+
+    return total;
+}
+
+inline void WriteMatrix(std::ostream& os, const PackedMatrix& matrix, std::size_t strideWords) {
+    std::vector<PackedMatrix::WordType> row(strideWords);
+    for(unsigned rowIdx = 0; rowIdx < matrix.RowsSize(); ++rowIdx) {
+        std::copy_n(matrix.Row(rowIdx), matrix.WordsPerRow(), row.begin());
+        os.write(reinterpret_cast<const char*>(row.data()), row.size() * sizeof(PackedMatrix::WordType));
+    }
+}
+
+inline void WriteVector(std::ostream& os, const boost::dynamic_bitset<>& bits) {
+    std::vector<PackedMatrix::WordType> words(RoundUp(PackedMatrix::WordsFor(bits.size())));
+    boost::to_block_range(bits, words.begin());
+    os.write(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(PackedMatrix::WordType));
+}
+
+inline PackedMatrix Layout(const BinaryMatrix& checkMatrix, PackedLayout layout) {
+    PackedMatrix rows(checkMatrix);
+    return layout == PackedLayout::Rows ? rows : rows.Transposed();
+}
+
+/// Whole file, mapped privately, so writes to views are copy-on-write and never reach the file
+inline std::shared_ptr<void> MapFile(const std::string& file, std::size_t& size) {
+#ifdef __linux__
+    const int fd = ::open(file.c_str(), O_RDONLY);
+    if(fd < 0) {
+        throw std::runtime_error("file " + file + " cannot be opened");
+    }
+
+    struct stat info;
+    if(::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(PackedHeader))) {
+        ::close(fd);
+        throw std::runtime_error("file " + file + " is not an instance in the packed format");
+    }
+    size = info.st_size;
+
+    void* address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(address == MAP_FAILED) {
+        throw std::runtime_error("file " + file + " cannot be mapped");
+    }
+
+    return std::shared_ptr<void>(address, [size](void* address) {
+        ::munmap(address, size);
+    });
+#else
+    // without mmap the file is read into memory of the same alignment
+    std::ifstream ifs(file, std::ios::binary | std::ios::ate);
+    if(!ifs) {
+        throw std::runtime_error("file " + file + " cannot be opened");
+    }
+    size = ifs.tellg();
+    ifs.seekg(0);
+
+    std::shared_ptr<void> buffer(::operator new(size, std::align_val_t(alignment)), [](void* address) {
+        ::operator delete(address, std::align_val_t(alignment));
+    });
+    ifs.read(static_cast<char*>(buffer.get()), size);
+
+    return buffer;
+#endif
+}
+
+}
+
+
+/**
+ * Writes instance in the packed format
+ * @param instance check matrix, syndrome and, if it is not empty, error vector
+ * @param file path of the file
+ * @param options layout of the matrix, weight of error and whether the systematic form is precomputed
+ */
+void SavePackedInstance(const DecodingInstance& instance, const std::string& file, const PackedWriteOptions& options = {}) {
+    if constexpr(std::endian::native != std::endian::little) {
+        throw std::runtime_error("the packed format is little-endian");
+    }
+
+    const auto& checkMatrix = instance.checkMatrix;
+    if(checkMatrix.RowsSize() == 0 || checkMatrix.RowsSize() >= checkMatrix.ColumnsSize() || instance.syndrome.size() != checkMatrix.RowsSize()) {
+        throw std::invalid_argument("check matrix should be (n - k) x n and syndrome should have n - k bits");
+    }
+
+    PackedHeader header;
+    header.layout = options.layout;
+    header.n = checkMatrix.ColumnsSize();
+    header.k = checkMatrix.ColumnsSize() - checkMatrix.RowsSize();
+    header.omega = instance.errorVector.empty() ? options.omega : instance.errorVector.count();
+    header.flags = instance.errorVector.empty() ? 0 : HasErrorVector;
+    header.strideWords = packed_format::RoundUp(PackedMatrix::WordsFor(packed_format::MatrixShape(header).second));
+
+    BinaryMatrix systematicMatrix = checkMatrix;
+    boost::dynamic_bitset<> systematicSyndrome = instance.syndrome;
+    if(options.withSystematicForm && BinaryMatrix::GaussElimination(systematicMatrix, systematicSyndrome)) {
+        header.flags |= HasSystematicForm;
+    }
+
+    std::ofstream ofs(file, std::ios::binary | std::ios::trunc);
+    if(!ofs) {
+        throw std::runtime_error("file " + file + " cannot be created");
+    }
+
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    packed_format::WriteMatrix(ofs, packed_format::Layout(checkMatrix, header.layout), header.strideWords);
+    packed_format::WriteVector(ofs, instance.syndrome);
+    if(header.flags & HasErrorVector) {
+        packed_format::WriteVector(ofs, instance.errorVector);
+    }
+    if(header.flags & HasSystematicForm) {
+        packed_format::WriteMatrix(ofs, packed_format::Layout(systematicMatrix, header.layout), header.strideWords);
+        packed_format::WriteVector(ofs, systematicSyndrome);
+    }
+
+    if(!ofs) {
+        throw std::runtime_error("file " + file + " cannot be written");
+    }
+}
+
+/**
+ * Maps file in the packed format, matrices of the instance are views of the mapping,
+ * which is unmapped when the last of them is destroyed
+ */
+PackedInstance LoadPackedInstance(const std::string& file) {
+    if constexpr(std::endian::native != std::endian::little) {
+        throw std::runtime_error("the packed format is little-endian");
+    }
+
+    std::size_t size = 0;
+    auto mapping = packed_format::MapFile(file, size);
+    auto* words = static_cast<PackedMatrix::WordType*>(mapping.get());
+
+    PackedInstance instance;
+    std::memcpy(&instance.header, words, sizeof(PackedHeader));
+    const PackedHeader& header = instance.header;
+
+    if(header.magic != packed_format::magic) {
+        throw std::runtime_error("file " + file + " is not an instance in the packed format");
+    }
+    if(header.version != packed_format::version) {
+        throw std::runtime_error("file " + file + " has version " + std::to_string(header.version) + " of the packed format, "
+                                 + std::to_string(packed_format::version) + " is supported");
+    }
+    if(header.k >= header.n || header.n > std::numeric_limits<unsigned>::max() || header.layout > PackedLayout::Columns) {
+        throw std::runtime_error("file " + file + " has invalid header");
+    }
+
+    // stride is at least ceil(packedCols / 64) words, and the sections described by the header fit into the file
+    const auto [packedRows, packedCols] = packed_format::MatrixShape(header);
+    const auto fileWords = packed_format::FileWords(header);
+    if(header.strideWords % packed_format::wordsPerLine != 0 || header.strideWords < PackedMatrix::WordsFor(packedCols)
+       || !fileWords || *fileWords > size / sizeof(PackedMatrix::WordType)) {
+        throw std::runtime_error("file " + file + " is truncated or has invalid header");
+    }
+
+    const unsigned rows = instance.Rows();
+    const std::size_t syndromeWords = packed_format::RoundUp(PackedMatrix::WordsFor(rows));
+    auto* section = words + packed_format::wordsPerLine;
+
+    instance.matrix = PackedMatrix::View(section, packedRows, packedCols, header.strideWords, mapping);
+    section += packed_format::MatrixWords(header);
+    instance.syndrome = PackedMatrix::View(section, 1, rows, syndromeWords, mapping);
+    section += syndromeWords;
+
+    if(header.flags & HasErrorVector) {
+        const std::size_t errorWords = packed_format::RoundUp(PackedMatrix::WordsFor(header.n));
+        instance.errorVector = PackedMatrix::View(section, 1, header.n, errorWords, mapping);
+        section += errorWords;
+    }
+    if(header.flags & HasSystematicForm) {
+        instance.systematicMatrix = PackedMatrix::View(section, packedRows, packedCols, header.strideWords, mapping);
+        section += packed_format::MatrixWords(header);
+        instance.systematicSyndrome = PackedMatrix::View(section, 1, rows, syndromeWords, mapping);
+    }
+
+    return instance;
+}
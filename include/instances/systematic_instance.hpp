@@ -0,0 +1,90 @@
+#pragma once
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <algebra/packed_matrix.hpp>
+#include <algebra/systematic_matrix.hpp>
+#include <instances/text_format.hpp>
+#include <instances/text_parser.hpp>
+
+
+/**
+ * Instance of syndrome decoding which check matrix is [I | Q], only Q is stored
+ */
+struct SystematicInstance {
+    SystematicMatrix checkMatrix;
+    boost::dynamic_bitset<> syndrome;
+    /// Empty if the error vector is unknown
+    boost::dynamic_bitset<> errorVector;
+};
+
+
+/**
+ * Reads instance in the text format (see LoadInstance) which check matrix is [I | Q]. Lines of the
+ * check matrix are packed by TextBitReader and shifted into rows of Q one by one, so neither
+ * the identity block nor the whole text is kept in memory
+ * @param isSystematic if true, the input is accepted as systematic and the identity block is not checked
+ * @return empty optional if the check matrix is not [I | Q]
+ */
+std::optional<SystematicInstance> LoadSystematicInstance(const std::string& directory, bool isSystematic = false) {
+    const std::filesystem::path path(directory);
+    SystematicInstance instance;
+    instance.syndrome = ReadTextVector((path / "syndrome.txt").string());
+    if(std::filesystem::exists(path / "error_vector.txt")) {
+        instance.errorVector = ReadTextVector((path / "error_vector.txt").string());
+    }
+
+    // the syndrome has a bit per row, so the identity block is known before the first row
+    const unsigned rows = instance.syndrome.size();
+    const std::size_t firstWord = rows / TextBitReader::bitsPerWord;
+    const unsigned offset = rows % TextBitReader::bitsPerWord;
+
+    TextBitReader reader((path / "check_matrix.txt").string());
+    std::vector<TextBitReader::WordType> words;
+    PackedMatrix redundancy;
+    unsigned rowIdx = 0;
+    for(std::size_t bits; (bits = reader.NextLine(words)) != 0; ++rowIdx) {
+        if(rowIdx == 0) {
+            if(bits <= rows) {
+                return std::nullopt;
+            }
+            redundancy = PackedMatrix(rows, bits - rows);
+        }
+        if(rowIdx >= rows || bits != rows + redundancy.ColumnsSize()) {
+            throw std::runtime_error("check matrix of " + directory + " does not match its syndrome");
+        }
+
+        if(!isSystematic) {
+            // the first rows bits are the unit vector of rowIdx
+            words[rowIdx / TextBitReader::bitsPerWord] ^= TextBitReader::WordType(1) << (rowIdx % TextBitReader::bitsPerWord);
+            const bool isUnitVector = std::all_of(words.begin(), words.begin() + firstWord, [](auto word) { return word == 0; })
+                && (offset == 0 || (words[firstWord] & ((TextBitReader::WordType(1) << offset) - 1)) == 0);
+            if(!isUnitVector) {
+                return std::nullopt;
+            }
+        }
+
+        // bits [rows, n) are shifted to the beginning of the row of Q
+        auto* row = redundancy.Row(rowIdx);
+        for(std::size_t wordIdx = 0; wordIdx < redundancy.WordsPerRow(); ++wordIdx) {
+            row[wordIdx] = words[firstWord + wordIdx] >> offset;
+            if(offset != 0 && firstWord + wordIdx + 1 < words.size()) {
+                row[wordIdx] |= words[firstWord + wordIdx + 1] << (TextBitReader::bitsPerWord - offset);
+            }
+        }
+    }
+
+    if(rowIdx != rows) {
+        throw std::runtime_error("check matrix of " + directory + " does not match its syndrome");
+    }
+
+    instance.checkMatrix = SystematicMatrix(std::move(redundancy));
+    return instance;
+}
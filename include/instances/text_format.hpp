@@ -0,0 +1,100 @@
+#pragma once
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <algebra/binary_matrix.hpp>
+#include <instances/decoding_instance.hpp>
+#include <instances/packed_format.hpp>
+#include <instances/text_parser.hpp>
+
+
+/// Bits in the text format of instances: one '0'/'1' character per bit, the first character is bit 0
+std::string ToText(const boost::dynamic_bitset<>& bits) {
+    std::string text(bits.size(), '0');
+    for(auto pos = bits.find_first(); pos != boost::dynamic_bitset<>::npos; pos = bits.find_next(pos)) {
+        text[pos] = '1';
+    }
+
+    return text;
+}
+
+/// Bits of a line packed by TextBitReader
+boost::dynamic_bitset<> ToBitset(const std::vector<TextBitReader::WordType>& words, std::size_t bits) {
+    boost::dynamic_bitset<> bitset(words.begin(), words.end());
+    bitset.resize(bits);
+    return bitset;
+}
+
+/// Vector in the first line of file, e.g. syndrome.txt
+boost::dynamic_bitset<> ReadTextVector(const std::string& file) {
+    TextBitReader reader(file);
+    std::vector<TextBitReader::WordType> words;
+    const std::size_t bits = reader.NextLine(words);
+    if(bits == 0) {
+        throw std::runtime_error("file " + file + " is empty");
+    }
+
+    return ToBitset(words, bits);
+}
+
+/// Matrix which rows are lines of file, e.g. check_matrix.txt
+BinaryMatrix ReadTextMatrix(const std::string& file) {
+    TextBitReader reader(file);
+    std::vector<TextBitReader::WordType> words;
+
+    BinaryMatrix matrix;
+    for(std::size_t bits; (bits = reader.NextLine(words)) != 0;) {
+        if(matrix.RowsSize() != 0 && bits != matrix.ColumnsSize()) {
+            throw std::runtime_error("rows of " + file + " have different lengths");
+        }
+        matrix.addRow(ToBitset(words, bits));
+    }
+
+    return matrix;
+}
+
+/**
+ * Reads check_matrix.txt, syndrome.txt and error_vector.txt if it exists from directory
+ * (the format of tests/test_data and examples/decoding_challenge_*), every file is parsed in one pass.
+ * If the path is a file, it is an instance in the packed format (see LoadPackedInstance)
+ */
+DecodingInstance LoadInstance(const std::string& directory) {
+    const std::filesystem::path path(directory);
+    if(std::filesystem::is_regular_file(path)) {
+        return LoadPackedInstance(directory).ToDecodingInstance();
+    }
+
+    DecodingInstance instance;
+    instance.checkMatrix = ReadTextMatrix((path / "check_matrix.txt").string());
+    instance.syndrome = ReadTextVector((path / "syndrome.txt").string());
+    if(std::filesystem::exists(path / "error_vector.txt")) {
+        instance.errorVector = ReadTextVector((path / "error_vector.txt").string());
+    }
+
+    return instance;
+}
+
+/**
+ * Writes instance as check_matrix.txt, syndrome.txt and error_vector.txt (if it is known) to directory,
+ * the format of tests/test_data and examples/decoding_challenge_*
+ */
+void SaveInstance(const DecodingInstance& instance, const std::string& directory) {
+    std::filesystem::create_directories(directory);
+    const std::filesystem::path path(directory);
+
+    std::ofstream matrix(path / "check_matrix.txt");
+    for(const auto& row: instance.checkMatrix.getData()) {
+        matrix << ToText(row) << '\n';
+    }
+
+    std::ofstream(path / "syndrome.txt") << ToText(instance.syndrome) << '\n';
+    if(!instance.errorVector.empty()) {
+        std::ofstream(path / "error_vector.txt") << ToText(instance.errorVector) << '\n';
+    }
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+
+/**
+ * Single pass reader of bits in the text format: one '0'/'1' character per bit, one vector per line,
+ * the first character is bit 0. The file is read in large blocks and every 64 characters are packed
+ * into a word by SIMD comparison and movemask, character i becomes bit i of the word, which is the order
+ * of boost::dynamic_bitset, so lines are neither stored as strings nor reversed
+ */
+class TextBitReader {
+public:
+    using WordType = std::uint64_t;
+
+    static constexpr unsigned bitsPerWord = 64;
+    static constexpr std::size_t blockSize = 1 << 20;
+
+private:
+    std::ifstream ifs;
+    std::string file;
+    /// Unparsed characters are [pos, end), the buffer is 128 bytes longer than a block,
+    /// so loads of 64 characters beyond end stay inside it
+    std::vector<char> buffer;
+    std::size_t pos = 0;
+    std::size_t end = 0;
+    bool isEof = false;
+
+    /// Masks of '1' and of characters which are neither '0' nor '1' among the first count characters
+    struct PackedChars {
+        WordType ones;
+        WordType invalid;
+    };
+
+    static PackedChars Pack(const char* chars, unsigned count) {
+        const WordType mask = count == bitsPerWord ? ~WordType(0) : (WordType(1) << count) - 1;
+        WordType ones = 0, zeros = 0;
+
+#if defined(__AVX2__)
+        const __m256i one = _mm256_set1_epi8('1'), zero = _mm256_set1_epi8('0');
+        for(unsigned half = 0; half < 2; ++half) {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(chars + 32 * half));
+            ones |= WordType(std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, one)))) << (32 * half);
+            zeros |= WordType(std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, zero)))) << (32 * half);
+        }
+#elif defined(__SSE2__)
+        const __m128i one = _mm_set1_epi8('1'), zero = _mm_set1_epi8('0');
+        for(unsigned quarter = 0; quarter < 4; ++quarter) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars + 16 * quarter));
+            ones |= WordType(std::uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(block, one)))) << (16 * quarter);
+            zeros |= WordType(std::uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(block, zero)))) << (16 * quarter);
+        }
+#else
+        for(unsigned idx = 0; idx < count; ++idx) {
+            ones |= WordType(chars[idx] == '1') << idx;
+            zeros |= WordType(chars[idx] == '0') << idx;
+        }
+#endif
+
+        return PackedChars{ones & mask, ~(ones | zeros) & mask};
+    }
+
+    /// Moves unparsed characters to the beginning of the buffer and reads the next block after them
+    void Refill() {
+        std::memmove(buffer.data(), buffer.data() + pos, end - pos);
+        end -= pos;
+        pos = 0;
+
+        ifs.read(buffer.data() + end, blockSize);
+        const auto numberOfRead = static_cast<std::size_t>(ifs.gcount());
+        end += numberOfRead;
+        isEof = numberOfRead < blockSize;
+    }
+
+    /// Packs length characters and appends them to the bits of words
+    void AppendChars(const char* chars, std::size_t length, std::vector<WordType>& words, std::size_t& bits) const {
+        words.resize((bits + length + bitsPerWord - 1) / bitsPerWord);
+
+        for(std::size_t idx = 0; idx < length; idx += bitsPerWord) {
+            const unsigned count = std::min<std::size_t>(bitsPerWord, length - idx);
+            const auto packed = Pack(chars + idx, count);
+            if(packed.invalid != 0) {
+                throw std::runtime_error("file " + file + " has character '" + chars[idx + std::countr_zero(packed.invalid)]
+                                         + "' which is neither '0' nor '1'");
+            }
+
+            // lines are packed from aligned positions, except of continuations of lines split by blocks
+            const std::size_t wordIdx = bits / bitsPerWord;
+            const unsigned offset = bits % bitsPerWord;
+            words[wordIdx] |= packed.ones << offset;
+            if(offset != 0 && offset + count > bitsPerWord) {
+                words[wordIdx + 1] |= packed.ones >> (bitsPerWord - offset);
+            }
+            bits += count;
+        }
+    }
+
+public:
+    explicit TextBitReader(const std::string& file)
+        : ifs(file, std::ios::binary), file(file), buffer(blockSize + 2 * bitsPerWord) {
+        if(!ifs) {
+            throw std::runtime_error("file " + file + " cannot be opened");
+        }
+    }
+
+    /**
+     * Packs the next non-empty line into words, lines may end with "\r\n"
+     * @param words words of the line, bit i of the line is bit i % 64 of word i / 64, they are overwritten
+     * @return number of bits of the line, zero if there are no more lines
+     */
+    std::size_t NextLine(std::vector<WordType>& words) {
+        words.clear();
+        std::size_t bits = 0;
+
+        while(true) {
+            const char* begin = buffer.data() + pos;
+            const auto* newline = static_cast<const char*>(std::memchr(begin, '\n', end - pos));
+            std::size_t length = (newline != nullptr ? newline : buffer.data() + end) - begin;
+            // '\r' of "\r\n" which is split by the end of block stays for the next block
+            if(length > 0 && begin[length - 1] == '\r') {
+                --length;
+            }
+
+            AppendChars(begin, length, words, bits);
+
+            if(newline != nullptr) {
+                pos = newline - buffer.data() + 1;
+                if(bits > 0) {
+                    return bits;
+                }
+            } else if(isEof) {
+                pos = end;
+                return bits;
+            } else {
+                pos += length;
+                Refill();
+            }
+        }
+    }
+};
@@ -3,6 +3,8 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 
 
@@ -19,6 +21,16 @@ std::size_t NumberOfCombinations(int n, int k) {
     return result;
 }
 
+/**
+ * Natural logarithm of number of k-combinations of n, it does not overflow for sizes of real instances
+ * @return -infinity if there are no such combinations
+ */
+double LogNumberOfCombinations(int n, int k) {
+    if (k < 0 || n < 0 || k > n) return -std::numeric_limits<double>::infinity();
+
+    return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0);
+}
+
 
 class Combination {
     int n, k;
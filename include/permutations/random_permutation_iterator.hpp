@@ -2,21 +2,102 @@
 
 #include "permutation_base.hpp"
 #include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
 #include <random>
 
+#include <utils/philox.hpp>
 
+
+/**
+ * Stream of random permutations where permutation i is a pure function of (seed, i),
+ * so threads and processes may take any part of the stream without shared state
+ */
 class RandomPermutation: public PermutationBase {
 
 public:
     using PermutationBase::PermutationBase;
 
+    static std::uint64_t RandomSeed() {
+        std::random_device device;
+        return (static_cast<std::uint64_t>(device()) << 32) | device();
+    }
+
+    /**
+     * Fisher-Yates shuffle of the first count positions, bounded random numbers are drawn
+     * from Philox stream of (seed, index). The first count positions are a uniform random
+     * sample, the rest positions hold other elements in unspecified order. They are the same
+     * as the first count positions of the whole shuffle of (seed, index)
+     * @param permutation permutation to be shuffled
+     * @param count number of positions to be shuffled
+     */
+    static void Shuffle(std::vector<unsigned>& permutation, std::uint64_t seed, std::uint64_t index,
+                        std::size_t count = std::numeric_limits<std::size_t>::max()) {
+        Philox4x32 generator(seed, index);
+
+        const std::size_t size = permutation.size();
+        count = std::min(count, size > 0 ? size - 1 : 0);
+        for(std::size_t position = 0; position < count; ++position) {
+            std::swap(permutation[position], permutation[position + BoundedRandom(generator, size - position)]);
+        }
+    }
+
+    /**
+     * Permutation which is fully determined by seed and its index, so disjoint ranges of indexes
+     * can be given to different workers
+     * @param seed seed of the stream of permutations
+     * @param index index of permutation in the stream
+     * @param count if only the set of the first count elements matters (e.g. an information set),
+     * only count positions are shuffled
+     */
+    std::vector<unsigned> Get(std::uint64_t seed, std::uint64_t index,
+                              std::size_t count = std::numeric_limits<std::size_t>::max()) const {
+        auto permutation = start_permutation;
+        Shuffle(permutation, seed, index, count);
+
+        return permutation;
+    }
+
     class RandomPermutationIterator: public PermutationBase::PermutationBaseIterator {
-        std::mt19937 g;
+        std::uint64_t seed;
+        std::uint64_t index;
+        std::uint64_t stride;
+        std::size_t count;
+
+        void Generate() {
+            std::iota(permutation.begin(), permutation.end(), 0);
+            Shuffle(permutation, seed, index, count);
+        }
+
     public:
-        RandomPermutationIterator(const value_type& permutation): PermutationBase::PermutationBaseIterator(permutation), g(std::random_device()()) {}
+        RandomPermutationIterator(const value_type& permutation): RandomPermutationIterator(permutation, RandomSeed()) {}
+
+        /**
+         * @param permutation initial permutation, only its size is used
+         * @param seed seed of the stream of permutations
+         * @param firstIndex index of the first permutation
+         * @param stride distance between indexes of consecutive permutations, so iterators
+         * with first indexes 0, ..., stride - 1 split one stream without overlaps
+         * @param count number of shuffled positions, see Shuffle
+         */
+        RandomPermutationIterator(const value_type& permutation, std::uint64_t seed, std::uint64_t firstIndex = 0, std::uint64_t stride = 1,
+                                  std::size_t count = std::numeric_limits<std::size_t>::max())
+            : PermutationBase::PermutationBaseIterator(permutation), seed(seed), index(firstIndex), stride(stride), count(count) {
+            Generate();
+        }
+
+        std::uint64_t Seed() const {
+            return seed;
+        }
+
+        std::uint64_t Index() const {
+            return index;
+        }
 
         RandomPermutationIterator& operator++() {
-            std::shuffle(permutation.begin(), permutation.end(), g);
+            index += stride;
+            Generate();
 
             return *this;
         }
@@ -32,4 +113,9 @@ public:
    RandomPermutationIterator begin() {
         return RandomPermutationIterator(start_permutation);
     }
-};  
\ No newline at end of file
+
+   RandomPermutationIterator begin(std::uint64_t seed, std::uint64_t firstIndex = 0, std::uint64_t stride = 1,
+                                   std::size_t count = std::numeric_limits<std::size_t>::max()) {
+        return RandomPermutationIterator(start_permutation, seed, firstIndex, stride, count);
+    }
+};
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <boost/dynamic_bitset.hpp>
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <algebra/binary_matrix.hpp>
+#include <permutations/combination_iterator.hpp>
+#include "base_decoding.hpp"
+#include "isd_engine.hpp"
+#include "list_matching.hpp"
+
+
+/**
+ * Parameters of ball-collision decoding
+ */
+struct BallCollisionParameters {
+    /// Weight of combinations of every half of information set
+    unsigned p;
+    /// Width of the collision window
+    unsigned l;
+    /// Maximal number of errors in every half of the window
+    unsigned q;
+};
+
+
+/**
+ * Enumerator of ball-collision decoding (Bernstein, Lange, Peters): as in Stern algorithm
+ * p-combinations of both halves of information set are enumerated, but every sum is also
+ * shifted by all patterns of at most q errors in its own half of the l-window.
+ * Patterns are columns of identity part, so projected sums collide up to these errors
+ */
+template <ListStore LeftStore, ListStore RightStore>
+class BallCollisionEnumerator {
+protected:
+    int p;
+    int l;
+    int q;
+
+    using PatternType = std::pair<KeyType, std::vector<unsigned>>;
+
+    /**
+     * Patterns of at most q errors on rows [start, start + length) of the window
+     * @param informationSetSize number of columns of Q, column k + i is the unit vector of row i
+     * @return keys of patterns and indexes of corresponding columns of identity part
+     */
+    std::vector<PatternType> WindowPatterns(unsigned informationSetSize, unsigned start, unsigned length) const {
+        std::vector<PatternType> patterns;
+
+        for(unsigned weight = 0; weight <= std::min<unsigned>(q, length); ++weight) {
+            for(auto combinationIter = Combination(weight, length).begin(); combinationIter.CombinationsStillExist(); ++combinationIter) {
+                PatternType pattern(0, *combinationIter);
+
+                for(auto& row: pattern.second) {
+                    pattern.first |= KeyType(1) << (start + row);
+                    row += informationSetSize + start;
+                }
+
+                patterns.push_back(std::move(pattern));
+            }
+        }
+
+        return patterns;
+    }
+
+public:
+    using LeftStoreType = LeftStore;
+    using RightStoreType = RightStore;
+    using ParametersType = BallCollisionParameters;
+
+    /**
+     * Creates an object for ball-collision algorithm
+     * @param cols number of columns in matrix, p will initialize as 0.002 * cols,
+     * l as 0.013 * cols (as in Stern algorithm, l can not exceed width of key) and q as 1
+    */
+    BallCollisionEnumerator(unsigned cols) : p(static_cast<unsigned>(0.002 * cols) > 0 ? 0.002 * cols : 1),
+                                             l(std::min(static_cast<unsigned>(0.013 * cols) > 0 ? static_cast<unsigned>(0.013 * cols) : 1, maxKeyLength)),
+                                             q(1) {}
+
+    /**
+     * Creates an object for ball-collision algorithm with the given parameters (e.g. chosen by ParameterOptimizer)
+     */
+    BallCollisionEnumerator(BallCollisionParameters parameters) : p(std::max(parameters.p, 1u)),
+                                                                  l(std::clamp(parameters.l, 1u, maxKeyLength)),
+                                                                  q(parameters.q) {}
+
+    /**
+     * Parameters which ParameterOptimizer compares: p up to 3, q up to 2 and every width of window
+     * which leaves enough rows for the rest of errors
+     */
+    static std::vector<BallCollisionParameters> ParameterCandidates(unsigned rows, unsigned cols, unsigned omega) {
+        std::vector<BallCollisionParameters> candidates;
+        for(unsigned p = 1; p <= 3 && 2 * p <= omega; ++p) {
+            for(unsigned q = 0; q <= 2; ++q) {
+                for(unsigned l = std::max(2 * q, 1u); l <= maxKeyLength && l + (omega - 2 * p) <= rows; ++l) {
+                    candidates.push_back(BallCollisionParameters{p, l, q});
+                }
+            }
+        }
+
+        return candidates;
+    }
+
+    /**
+     * Every combination is added with every pattern of its half of the window
+     */
+    IterationWork ExpectedWork(unsigned rows, unsigned cols) const {
+        const int halfL = l / 2;
+        const auto numberOfPatterns = [this](int length) {
+            double patterns = 0;
+            for(int weight = 0; weight <= std::min(q, length); ++weight) {
+                patterns += std::exp(LogNumberOfCombinations(length, weight));
+            }
+            return patterns;
+        };
+
+        const double combinations = std::exp(LogNumberOfCombinations((cols - rows) / 2, p));
+        const double leftLength = combinations * numberOfPatterns(halfL), rightLength = combinations * numberOfPatterns(l - halfL);
+
+        return IterationWork{leftLength + rightLength, std::ldexp(leftLength * rightLength, -l),
+                             leftLength * LeftStore::EntryBytes(p + q) + rightLength * RightStore::EntryBytes(p + q)};
+    }
+
+    std::tuple<unsigned, unsigned, unsigned> getParams() const {
+        return std::make_tuple(p, l, q);
+    }
+
+    /**
+     * Expected number of iterations to the error vector: p errors in each half of information set,
+     * at most q errors in each half of the window (as in benchmark/graph.py)
+     */
+    double ExpectedIterations(unsigned rows, unsigned cols, unsigned omega) const {
+        const int k = cols - rows;
+        const int halfL = l / 2;
+
+        // successes of different patterns of the window are summed in linear scale relative to the largest term
+        std::vector<double> logTerms;
+        for(int q1 = 0; q1 <= q; ++q1) {
+            for(int q2 = 0; q2 <= q; ++q2) {
+                logTerms.push_back(2 * LogNumberOfCombinations(k / 2, p) + LogNumberOfCombinations(halfL, q1) + LogNumberOfCombinations(l - halfL, q2)
+                                   + LogNumberOfCombinations(static_cast<int>(rows) - l, static_cast<int>(omega) - 2 * p - q1 - q2));
+            }
+        }
+
+        const double maxLogTerm = *std::max_element(logTerms.begin(), logTerms.end());
+        if(std::isinf(maxLogTerm)) {
+            return ::ExpectedIterations(LogNumberOfCombinations(cols, omega), maxLogTerm);
+        }
+
+        double sum = 0;
+        for(const auto logTerm: logTerms) {
+            sum += std::exp(logTerm - maxLogTerm);
+        }
+
+        return ::ExpectedIterations(LogNumberOfCombinations(cols, omega), maxLogTerm + std::log(sum));
+    }
+
+    void Enumerate(const ISDContext& context, LeftStoreType& left, RightStoreType& right) const {
+        const unsigned colsSizeOfQ = context.InformationSetSize();
+        const unsigned halfColsSizeOfQ = colsSizeOfQ / 2;
+        const unsigned halfL = l / 2;
+
+        const auto columnKeys = context.ColumnKeys(2 * halfColsSizeOfQ, 0, l);
+        const KeyType syndromeKey = context.SyndromeKey(0, l);
+
+        const auto leftPatterns = WindowPatterns(colsSizeOfQ, 0, halfL);
+        const auto rightPatterns = WindowPatterns(colsSizeOfQ, halfL, l - halfL);
+
+        auto combination = Combination(p, halfColsSizeOfQ);
+        left.Reserve(combination.GetNumberOfCombinations() * leftPatterns.size(), p + q);
+        right.Reserve(combination.GetNumberOfCombinations() * rightPatterns.size(), p + q);
+
+        std::vector<unsigned> leftTuple, rightTuple;
+        for(auto combinationIter = combination.begin(); combinationIter.CombinationsStillExist() && !context.StopRequested(); ++combinationIter) {
+            KeyType leftKey = 0, rightKey = syndromeKey;
+
+            leftTuple.assign(combinationIter->begin(), combinationIter->end());
+            rightTuple.resize(p);
+            for(int idx = 0; idx < p; ++idx) {
+                rightTuple[idx] = (*combinationIter)[idx] + halfColsSizeOfQ;
+                leftKey ^= columnKeys[(*combinationIter)[idx]];
+                rightKey ^= columnKeys[rightTuple[idx]];
+            }
+
+            for(const auto& [patternKey, patternColumns]: leftPatterns) {
+                leftTuple.resize(p);
+                leftTuple.insert(leftTuple.end(), patternColumns.begin(), patternColumns.end());
+                left.Add(leftKey ^ patternKey, leftTuple);
+            }
+
+            for(const auto& [patternKey, patternColumns]: rightPatterns) {
+                rightTuple.resize(p);
+                rightTuple.insert(rightTuple.end(), patternColumns.begin(), patternColumns.end());
+                right.Add(rightKey ^ patternKey, rightTuple);
+            }
+        }
+    }
+};
+
+
+struct BallCollisionPolicy {
+    constexpr static const char* algorithmName = "BallCollision";
+
+    using EnumeratorType = BallCollisionEnumerator<SortedList, SortedList>;
+    using MatcherType = SortMergeMatcher;
+    using VerifierType = UnionVerifier;
+};
+
+using BallCollisionAlgorithm = ISDEngine<BallCollisionPolicy>;
@@ -2,27 +2,147 @@
 
 #include <boost/dynamic_bitset.hpp>
 #include <boost/thread.hpp>
-#include <boost/thread/mutex.hpp>
 
 #include <random>
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
 #include <functional>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
 #include <omp.h>
 
 #include <algebra/binary_matrix.hpp>
 #include <permutations/random_permutation_iterator.hpp>
+#include "instrumentation.hpp"
+#include "memory_accounting.hpp"
+#include "progress_reporting.hpp"
+
+
+/// Named counters which algorithms accumulate over many steps of decoding
+using DecodingStatistics = std::map<std::string, std::uint64_t>;
 
 
 class BaseAlgorithm {
 public:
     bool GaussElimination(BinaryMatrix& checkMatrix, boost::dynamic_bitset<>& syndrome) const {
+        const Instrumentation::PhaseTimer timer(DecodingPhase::Elimination);
         return BinaryMatrix::GaussElimination(checkMatrix, syndrome);
     }
 };
 
 
+/**
+ * Number of positions of permutation which are shuffled before a step of algorithm. Algorithms
+ * which depend only on the set of columns of Q (not on their order) declare NumberOfRandomPositions,
+ * so the rest of Fisher-Yates shuffle is skipped. Other algorithms need the whole permutation
+ */
+template <typename DecodingStepAlgorithm, typename MatrixType = BinaryMatrix>
+std::size_t NumberOfRandomPositions(const DecodingStepAlgorithm& algorithm, const MatrixType& checkMatrix) {
+    if constexpr (requires { algorithm.NumberOfRandomPositions(checkMatrix.RowsSize(), checkMatrix.ColumnsSize()); }) {
+        return algorithm.NumberOfRandomPositions(checkMatrix.RowsSize(), checkMatrix.ColumnsSize());
+    } else {
+        return checkMatrix.ColumnsSize();
+    }
+}
+
+
+/**
+ * Expected number of iterations of algorithm which finds the error vector of the iteration
+ * in one of rounds (e.g. windows or splits of Stern algorithm), rounds are treated as independent
+ * @param logNumberOfVectors logarithm of number of all error vectors, i.e. C(n, omega)
+ * @param logNumberOfSuccesses logarithm of number of error vectors which are found in one round
+ * @param rounds number of rounds after one elimination
+ */
+double ExpectedIterations(double logNumberOfVectors, double logNumberOfSuccesses, unsigned rounds = 1) {
+    const double logExpected = logNumberOfVectors - logNumberOfSuccesses;
+    if(!(logExpected > 0)) {
+        return 1;
+    }
+
+    const double probability = std::exp(-logExpected);
+    if(probability == 0) {
+        return std::exp(logExpected) / rounds;
+    }
+
+    // 1 / (1 - (1 - probability)^rounds) without cancellation for small probability
+    return -1 / std::expm1(rounds * std::log1p(-probability));
+}
+
+
+/**
+ * Probability that gauss elimination of a randomly permuted check matrix succeeds, i.e. that its last
+ * rows columns are linearly independent. For a uniformly random matrix it is prod_{i=1}^{rows} (1 - 2^-i),
+ * which tends to 0.2888 quickly
+ */
+double EliminationSuccessProbability(unsigned rows) {
+    double probability = 1;
+    for(unsigned idx = 1; idx <= std::min(rows, 64u); ++idx) {
+        probability *= 1 - std::ldexp(1.0, -static_cast<int>(idx));
+    }
+
+    return probability;
+}
+
+
+/**
+ * Expected number of permutations to solution. ExpectedIterations of algorithms counts information sets,
+ * i.e. permutations which elimination succeeds, while decoding loops count every permutation
+ * @return infinity if algorithm cannot find error vectors of weight omega
+ */
+template <typename DecodingStepAlgorithm>
+double ExpectedPermutations(const DecodingStepAlgorithm& algorithm, unsigned rows, unsigned cols, unsigned omega) {
+    return algorithm.ExpectedIterations(rows, cols, omega) / EliminationSuccessProbability(rows);
+}
+
+
+/**
+ * Expected work of one iteration besides gauss elimination, it is the cost model of ParameterOptimizer
+ */
+struct IterationWork {
+    /// Number of entries added to all lists
+    double listEntries = 0;
+    /// Number of pairs of entries with equal keys, i.e. candidates which are verified
+    double collisions = 0;
+    /// Peak bytes of lists which exist at once, it bounds memory of one thread
+    double listBytes = 0;
+    /// Bytes among listBytes of lists which stop growing on the memory budget (level-2 lists of MMT),
+    /// the rest of lists must fit into the budget for an iteration to run
+    double truncatableListBytes = 0;
+};
+
+
+/**
+ * Starts progress reports of decoding if they are enabled by options. Unless options give
+ * the expected number of iterations, it is the expectation of the algorithm for this instance
+ * converted from information sets to permutations, since reporter counts every permutation
+ * @return reporter or nullptr if reports are disabled
+ */
+template <typename DecodingStepAlgorithm, typename MatrixType = BinaryMatrix>
+std::unique_ptr<ProgressReporter> StartProgress(const ProgressOptions& options, const DecodingStepAlgorithm& algorithm,
+                                                const MatrixType& checkMatrix, unsigned omega, unsigned numThreads) {
+    if(options.interval.count() <= 0) {
+        return nullptr;
+    }
+
+    ProgressOptions optionsOfInstance = options;
+    if constexpr (requires { algorithm.ExpectedIterations(checkMatrix.RowsSize(), checkMatrix.ColumnsSize(), omega); }) {
+        if(optionsOfInstance.expectedIterations <= 0) {
+            optionsOfInstance.expectedIterations = ExpectedPermutations(algorithm, checkMatrix.RowsSize(), checkMatrix.ColumnsSize(), omega);
+        }
+    }
+
+    return std::make_unique<ProgressReporter>(optionsOfInstance, numThreads);
+}
+
+
 /**
  * Algorithm for projecting first end elements of bitset
  * @param bitset bitset
@@ -49,6 +169,58 @@ boost::dynamic_bitset<> Projection(const boost::dynamic_bitset<>& bitset, unsign
 }
 
 
+/**
+ * Checks that one iteration of algorithm fits into the memory budget of MemoryAccounting: lists which
+ * cannot be truncated and a permuted and a packed copy of check matrix. Otherwise truncated lists
+ * would be empty and decoding would never end. Algorithms without ExpectedWork and runs without budget pass
+ * @throws std::runtime_error if one iteration does not fit into the budget
+ */
+template <typename DecodingStepAlgorithm>
+void CheckIterationWithinBudget(const DecodingStepAlgorithm& algorithm, const BinaryMatrix& checkMatrix) {
+    const std::size_t budget = MemoryAccounting::Budget();
+    const unsigned rows = checkMatrix.RowsSize(), cols = checkMatrix.ColumnsSize();
+
+    if constexpr (requires { { algorithm.ExpectedWork(rows, cols) } -> std::same_as<IterationWork>; }) {
+        if(budget != 0) {
+            const auto work = algorithm.ExpectedWork(rows, cols);
+            const double requiredBytes = work.listBytes - work.truncatableListBytes + 2.0 * rows * cols / 8;
+            const std::size_t availableBytes = budget - std::min(budget, MemoryAccounting::GlobalUsage().currentBytes);
+            if(requiredBytes > availableBytes) {
+                throw std::runtime_error(std::string("one iteration of ") + algorithm.algorithmName + " needs "
+                                         + std::to_string(static_cast<std::uint64_t>(requiredBytes)) + " bytes, but only "
+                                         + std::to_string(availableBytes) + " bytes of the memory budget are available");
+            }
+        }
+    }
+}
+
+
+/**
+ * Number of threads of parallel decoding which lists fit into the memory budget of MemoryAccounting together.
+ * Besides lists every thread keeps a permuted and a packed copy of check matrix. Algorithms without
+ * ExpectedWork and runs without budget keep all threads. One thread is run if its truncatable lists
+ * do not fit completely
+ * @param numThreads requested number of threads
+ * @throws std::runtime_error if even one iteration does not fit into the budget
+ */
+template <typename DecodingStepAlgorithm>
+unsigned ThreadsWithinBudget(const DecodingStepAlgorithm& algorithm, const BinaryMatrix& checkMatrix, unsigned numThreads) {
+    const std::size_t budget = MemoryAccounting::Budget();
+    const unsigned rows = checkMatrix.RowsSize(), cols = checkMatrix.ColumnsSize();
+
+    CheckIterationWithinBudget(algorithm, checkMatrix);
+    if constexpr (requires { { algorithm.ExpectedWork(rows, cols) } -> std::same_as<IterationWork>; }) {
+        if(budget != 0) {
+            const double bytesOfThread = algorithm.ExpectedWork(rows, cols).listBytes + 2.0 * rows * cols / 8;
+            const double fittingThreads = std::floor((budget - std::min(budget, MemoryAccounting::GlobalUsage().currentBytes)) / bytesOfThread);
+            return std::clamp<double>(fittingThreads, 1, std::max(numThreads, 1u));
+        }
+    }
+
+    return std::max(numThreads, 1u);
+}
+
+
 /**
  * Base algorithm of decoding that find an error vector e
  * for check matrix H and syndrome s such that H*e = s
@@ -57,21 +229,31 @@ boost::dynamic_bitset<> Projection(const boost::dynamic_bitset<>& bitset, unsign
  * @param syndrome syndrome vector 
  * @param omega number of errors in codeword (i.e. number of ones in error vector)
  * @param algorithm algorithm for decoding 
+ * @param progress periodic reports of progress, disabled by default
  * @return error vector
+ * @throws std::runtime_error if one iteration does not fit into the memory budget
  */
 template <typename DecodingStepAlgorithm>
 boost::dynamic_bitset<> Decoding(BinaryMatrix& checkMatrix, boost::dynamic_bitset<>& syndrome,
-                                 const unsigned omega, const DecodingStepAlgorithm& algorithm){
+                                 const unsigned omega, const DecodingStepAlgorithm& algorithm,
+                                 const ProgressOptions& progress = {}){
     unsigned cols = checkMatrix.ColumnsSize();
+    CheckIterationWithinBudget(algorithm, checkMatrix);
+    const auto reporter = StartProgress(progress, algorithm, checkMatrix, omega, 1);
 
     boost::dynamic_bitset<> errorVector(cols);
     unsigned numberOfIterations = 0;
-    for(auto permutationIter = RandomPermutation(cols).begin(); permutationIter.CanBePermuted(); ++permutationIter, ++numberOfIterations) {
+    auto permutationIter = RandomPermutation(cols).begin(RandomPermutation::RandomSeed(), 0, 1, NumberOfRandomPositions(algorithm, checkMatrix));
+    for(; permutationIter.CanBePermuted(); ++permutationIter) {
         
         BinaryMatrix permutedCheckMatrix = checkMatrix.applyPermutation(*permutationIter);
         auto copiedSyndrome = syndrome;
 
         auto permutedErrorVector = algorithm(permutedCheckMatrix, copiedSyndrome, omega);
+        ++numberOfIterations;
+        if(reporter) {
+            reporter->AddIteration(0);
+        }
 
         if(permutedErrorVector) {
             for(unsigned idx = 0; idx < permutationIter->size(); ++idx){
@@ -88,32 +270,46 @@ boost::dynamic_bitset<> Decoding(BinaryMatrix& checkMatrix, boost::dynamic_bitse
 }
 
 
+/**
+ * Work of one thread of parallel decoding: steps of algorithm on its part of the stream of random permutations
+ * until somebody finds an error vector. The first found error vector is published by compare-and-swap
+ * of isFound, so errorVector is written only once
+ * @param seed seed of the stream of permutations of parallel decoding
+ * @param threadIdx index of thread, thread takes permutations threadIdx, threadIdx + numThreads, ...
+ * @param numThreads number of threads which share the stream
+ * @param isFound stop flag shared by all threads, algorithms which accept it check it inside long phases
+ * @param reporter reports of progress, iterations of the thread are counted if it is not nullptr
+ */
 template <typename DecodingStepAlgorithm>
-void ThreadTask(RandomPermutation::RandomPermutationIterator& permIter, BinaryMatrix& checkMatrix, 
-                boost::dynamic_bitset<>& syndrome, boost::dynamic_bitset<>& errorVector, 
-                unsigned omega, bool& isFinded, const DecodingStepAlgorithm& algorithm, boost::mutex &mx ) {
-    std::optional<boost::dynamic_bitset<>> permutedErrorVector;
-    while  ((!isFinded) && (permIter.CanBePermuted())) {
-        auto my_iter = permIter;
-        {
-            boost::mutex::scoped_lock lock(mx);
-            ++permIter;
-        }
-        BinaryMatrix permutedCheckMatrix = checkMatrix.applyPermutation(*my_iter);
+void ThreadTask(std::uint64_t seed, unsigned threadIdx, unsigned numThreads, const BinaryMatrix& checkMatrix,
+                const boost::dynamic_bitset<>& syndrome, boost::dynamic_bitset<>& errorVector,
+                unsigned omega, std::atomic<bool>& isFound, const DecodingStepAlgorithm& algorithm,
+                ProgressReporter* reporter = nullptr) {
+    const unsigned cols = checkMatrix.ColumnsSize();
 
+    auto permutationIter = RandomPermutation(cols).begin(seed, threadIdx, numThreads, NumberOfRandomPositions(algorithm, checkMatrix));
+
+    for(; !isFound.load(std::memory_order_relaxed) && permutationIter.CanBePermuted(); ++permutationIter) {
+        BinaryMatrix permutedCheckMatrix = checkMatrix.applyPermutation(*permutationIter);
         auto copiedSyndrome = syndrome;
 
-        auto permutedErrorVector = algorithm(permutedCheckMatrix, copiedSyndrome, omega);
+        std::optional<boost::dynamic_bitset<>> permutedErrorVector;
+        if constexpr (requires { algorithm(permutedCheckMatrix, copiedSyndrome, omega, isFound); }) {
+            permutedErrorVector = algorithm(permutedCheckMatrix, copiedSyndrome, omega, isFound);
+        } else {
+            permutedErrorVector = algorithm(permutedCheckMatrix, copiedSyndrome, omega);
+        }
+        if(reporter != nullptr) {
+            reporter->AddIteration(threadIdx);
+        }
 
-        if(permutedErrorVector) {
-            for(unsigned idx = 0; idx < my_iter->size(); ++idx){
-                errorVector[(*my_iter)[idx]] = (*permutedErrorVector)[idx];
+        bool expected = false;
+        if(permutedErrorVector && isFound.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            for(unsigned idx = 0; idx < permutationIter->size(); ++idx){
+                errorVector[(*permutationIter)[idx]] = (*permutedErrorVector)[idx];
             }
-            isFinded = true;
         }
     }
-
-    return;
 }
 
 
@@ -125,24 +321,27 @@ void ThreadTask(RandomPermutation::RandomPermutationIterator& permIter, BinaryMa
  * @param syndrome syndrome vector 
  * @param omega number of errors in codeword (i.e. number of ones in error vector)
  * @param algorithm algorithm for decoding 
- * @param numThreads number of threads 
+ * @param numThreads number of threads, fewer threads are run if their lists do not fit into the memory budget
+ * @param progress periodic reports of progress, disabled by default
  * @return error vector
  */
 template <typename DecodingStepAlgorithm>
 boost::dynamic_bitset<> DecodingParallel(BinaryMatrix& checkMatrix, boost::dynamic_bitset<>& syndrome, 
                                          const unsigned omega, const DecodingStepAlgorithm& algorithm,
-                                         const int &numThreads){
+                                         const int &numThreads, const ProgressOptions& progress = {}){
     unsigned cols = checkMatrix.ColumnsSize();
     boost::dynamic_bitset<> errorVector(cols);
-    bool isFinded = false;
+    std::atomic<bool> isFound = false;
+
+    const std::uint64_t seed = RandomPermutation::RandomSeed();
+    const unsigned numberOfThreads = ThreadsWithinBudget(algorithm, checkMatrix, std::max(numThreads, 1));
+    const auto reporter = StartProgress(progress, algorithm, checkMatrix, omega, numberOfThreads);
 
-    auto permutationIter = RandomPermutation(cols).begin();
-    boost::mutex mx;
     boost::thread_group thr_group;
-    for (int i = 0; i < numThreads; i++) {
-        thr_group.create_thread(boost::bind(ThreadTask<DecodingStepAlgorithm>, boost::ref(permutationIter), boost::ref(checkMatrix),
-                                boost::ref(syndrome), boost::ref(errorVector), omega, boost::ref(isFinded),
-                                boost::ref(algorithm), boost::ref(mx)));
+    for (unsigned i = 0; i < numberOfThreads; i++) {
+        thr_group.create_thread([&, i]() {
+            ThreadTask(seed, i, numberOfThreads, checkMatrix, syndrome, errorVector, omega, isFound, algorithm, reporter.get());
+        });
     }
 
     thr_group.join_all();
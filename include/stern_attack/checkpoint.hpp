@@ -0,0 +1,244 @@
+#pragma once
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <algebra/binary_matrix.hpp>
+#include <permutations/random_permutation_iterator.hpp>
+#include "base_decoding.hpp"
+#include "instrumentation.hpp"
+
+
+/**
+ * State of a long decoding which is enough to resume it: the stream of permutations is
+ * given by seed, so the cursor in it is the index of the next permutation
+ */
+struct DecodingCheckpoint {
+    /// Fingerprint of (check matrix, syndrome, omega), checkpoint of other instance is not loaded
+    std::uint64_t instance = 0;
+    std::uint64_t seed = 0;
+    std::uint64_t nextIndex = 0;
+    std::uint64_t elapsedMilliseconds = 0;
+    DecodingStatistics statistics;
+
+    /**
+     * FNV-1a hash of blocks of rows, syndrome and omega. Rows of SystematicMatrix are the rows of [I | Q],
+     * so a checkpoint of the instance is resumed whichever of both matrices is decoded
+     */
+    template <typename MatrixType = BinaryMatrix>
+    static std::uint64_t Fingerprint(const MatrixType& checkMatrix, const boost::dynamic_bitset<>& syndrome, unsigned omega) {
+        std::uint64_t hash = 14695981039346656037ull;
+        const auto add = [&hash](std::uint64_t value) {
+            hash = (hash ^ value) * 1099511628211ull;
+        };
+
+        const auto addBitset = [&add](const boost::dynamic_bitset<>& bitset) {
+            add(bitset.size());
+            std::vector<boost::dynamic_bitset<>::block_type> blocks(bitset.num_blocks());
+            boost::to_block_range(bitset, blocks.begin());
+            for(const auto block: blocks) {
+                add(block);
+            }
+        };
+
+        for(unsigned rowIdx = 0; rowIdx < checkMatrix.RowsSize(); ++rowIdx) {
+            if constexpr (requires { checkMatrix.getData(); }) {
+                addBitset(checkMatrix.getData()[rowIdx]);
+            } else {
+                addBitset(checkMatrix.RowBits(rowIdx));
+            }
+        }
+        addBitset(syndrome);
+        add(omega);
+
+        return hash;
+    }
+
+    /**
+     * Writes checkpoint to the temporary file and renames it, so the previous checkpoint
+     * stays whole if the process is killed while saving
+     */
+    void Save(const std::string& file) const {
+        const std::string temporaryFile = file + ".tmp";
+        {
+            std::ofstream ofs(temporaryFile, std::ios::trunc);
+            ofs << "instance " << instance << '\n'
+                << "seed " << seed << '\n'
+                << "next_index " << nextIndex << '\n'
+                << "elapsed_ms " << elapsedMilliseconds << '\n';
+
+            for(const auto& [name, value]: statistics) {
+                ofs << "statistics." << name << ' ' << value << '\n';
+            }
+        }
+
+        std::filesystem::rename(temporaryFile, file);
+    }
+
+    /**
+     * @return true if the file exists and contains checkpoint
+     */
+    bool Load(const std::string& file) {
+        std::ifstream ifs(file);
+        if(!ifs) {
+            return false;
+        }
+
+        DecodingCheckpoint loaded;
+        bool hasSeed = false;
+        std::string name;
+        std::uint64_t value;
+        while(ifs >> name >> value) {
+            if(name == "instance") {
+                loaded.instance = value;
+            } else if(name == "seed") {
+                loaded.seed = value;
+                hasSeed = true;
+            } else if(name == "next_index") {
+                loaded.nextIndex = value;
+            } else if(name == "elapsed_ms") {
+                loaded.elapsedMilliseconds = value;
+            } else if(name.starts_with("statistics.")) {
+                loaded.statistics[name.substr(std::string("statistics.").size())] = value;
+            }
+        }
+
+        if(!hasSeed || !ifs.eof()) {
+            return false;
+        }
+
+        *this = std::move(loaded);
+        return true;
+    }
+};
+
+
+namespace detail {
+
+/**
+ * Loop of DecodingWithCheckpoints. If firstStep is not nullptr, it is the iteration 0 instead of the permutation
+ * of index 0: a step to an information set which is already eliminated, it returns the permutation of the step
+ * and the error vector of the permuted check matrix if the step succeeded
+ */
+template <typename DecodingStepAlgorithm, typename MatrixType, typename FirstStepType>
+boost::dynamic_bitset<> DecodingWithCheckpoints(const MatrixType& checkMatrix, const boost::dynamic_bitset<>& syndrome,
+                                                const unsigned omega, const DecodingStepAlgorithm& algorithm,
+                                                const FirstStepType& firstStep, const std::string& checkpointFile,
+                                                std::chrono::milliseconds interval, std::uint64_t maxIterations,
+                                                const ProgressOptions& progress) {
+    const unsigned cols = checkMatrix.ColumnsSize();
+    const auto instance = DecodingCheckpoint::Fingerprint(checkMatrix, syndrome, omega);
+
+    DecodingCheckpoint checkpoint;
+    InstrumentationReport resumedReport;
+    if(checkpoint.Load(checkpointFile) && checkpoint.instance == instance) {
+        resumedReport = InstrumentationReport::Load(checkpoint.statistics);
+        if constexpr (requires { algorithm.LoadStatistics(checkpoint.statistics); }) {
+            algorithm.LoadStatistics(checkpoint.statistics);
+        }
+        std::cout << "Resumed from iteration " << checkpoint.nextIndex << '\n';
+    } else {
+        checkpoint = DecodingCheckpoint();
+        checkpoint.instance = instance;
+        checkpoint.seed = RandomPermutation::RandomSeed();
+    }
+
+    using Clock = std::chrono::steady_clock;
+    auto lastCheckpoint = Clock::now();
+    const auto reportAtStart = Instrumentation::Collect();
+    const auto save = [&]() {
+        const auto now = Clock::now();
+        checkpoint.elapsedMilliseconds += std::chrono::duration_cast<std::chrono::milliseconds>(now - lastCheckpoint).count();
+        lastCheckpoint = now;
+
+        if constexpr (requires { algorithm.SaveStatistics(checkpoint.statistics); }) {
+            algorithm.SaveStatistics(checkpoint.statistics);
+        }
+        if constexpr (Instrumentation::enabled) {
+            (resumedReport + Instrumentation::Collect() - reportAtStart).Save(checkpoint.statistics);
+        }
+        checkpoint.Save(checkpointFile);
+    };
+
+    RandomPermutation permutations(cols);
+    const auto randomPositions = NumberOfRandomPositions(algorithm, checkMatrix);
+    const auto reporter = StartProgress(progress, algorithm, checkMatrix, omega, 1);
+    boost::dynamic_bitset<> errorVector(cols);
+    for(std::uint64_t iteration = 0; iteration < maxIterations; ++iteration) {
+        std::vector<unsigned> permutation;
+        std::optional<boost::dynamic_bitset<>> permutedErrorVector;
+        if constexpr (!std::is_null_pointer_v<FirstStepType>) {
+            if(checkpoint.nextIndex == 0) {
+                std::tie(permutation, permutedErrorVector) = firstStep();
+            }
+        }
+        if(permutation.empty()) {
+            permutation = permutations.Get(checkpoint.seed, checkpoint.nextIndex, randomPositions);
+            BinaryMatrix permutedCheckMatrix = checkMatrix.applyPermutation(permutation);
+            auto copiedSyndrome = syndrome;
+
+            permutedErrorVector = algorithm(permutedCheckMatrix, copiedSyndrome, omega);
+        }
+        ++checkpoint.nextIndex;
+        if(reporter) {
+            reporter->AddIteration(0);
+        }
+
+        if(permutedErrorVector) {
+            for(unsigned idx = 0; idx < cols; ++idx) {
+                errorVector[permutation[idx]] = (*permutedErrorVector)[idx];
+            }
+
+            std::filesystem::remove(checkpointFile);
+            std::cout << "Algorithm: " << algorithm.algorithmName << ",\tsize: " << cols << ",\tnumber of iterations: " << checkpoint.nextIndex << '\n';
+            return errorVector;
+        }
+
+        if(Clock::now() - lastCheckpoint >= interval) {
+            save();
+        }
+    }
+
+    save();
+    return errorVector;
+}
+
+}
+
+/**
+ * Decoding which periodically saves its state and resumes from the saved one. Permutation of
+ * i-th iteration is RandomPermutation::Get(seed, i), so resumed decoding continues the same stream
+ * and repeats no iterations done before the last checkpoint. Checkpoint is removed on success
+ * @tparam DecodingStepAlgorithm type of algorithm (for example, ISD, Stern), algorithms with
+ * SaveStatistics/LoadStatistics also keep their statistics in checkpoint. If instrumentation is enabled,
+ * its report of all runs is kept in checkpoint as well
+ * @param checkMatrix binary check matrix
+ * @param syndrome syndrome vector
+ * @param omega number of errors in codeword (i.e. number of ones in error vector)
+ * @param algorithm algorithm for decoding
+ * @param checkpointFile file of checkpoint, decoding is resumed from it if it exists and belongs to the same instance
+ * @param interval time between checkpoints
+ * @param maxIterations decoding stops after this number of iterations in this run and saves checkpoint
+ * @param progress periodic reports of progress of this run, disabled by default
+ * @return error vector, zero vector if it was not found in maxIterations
+ */
+template <typename DecodingStepAlgorithm>
+boost::dynamic_bitset<> DecodingWithCheckpoints(const BinaryMatrix& checkMatrix, const boost::dynamic_bitset<>& syndrome,
+                                                const unsigned omega, const DecodingStepAlgorithm& algorithm,
+                                                const std::string& checkpointFile,
+                                                std::chrono::milliseconds interval = std::chrono::seconds(60),
+                                                std::uint64_t maxIterations = std::numeric_limits<std::uint64_t>::max(),
+                                                const ProgressOptions& progress = {}) {
+    return detail::DecodingWithCheckpoints(checkMatrix, syndrome, omega, algorithm, nullptr, checkpointFile, interval, maxIterations, progress);
+}
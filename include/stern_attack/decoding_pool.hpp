@@ -0,0 +1,287 @@
+#pragma once
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algebra/binary_matrix.hpp>
+#include "base_decoding.hpp"
+
+
+/**
+ * Cores of every NUMA node which the process is allowed to run on, nodes without such cores are skipped.
+ * Without NUMA information (not Linux or no sysfs) the whole machine is one node, which cores are empty
+ * if they are unknown
+ */
+std::vector<std::vector<int>> NumaNodeCores() {
+    std::vector<std::vector<int>> nodes;
+#ifdef __linux__
+    cpu_set_t allowed;
+    if(pthread_getaffinity_np(pthread_self(), sizeof(allowed), &allowed) != 0) {
+        CPU_ZERO(&allowed);
+    }
+
+    std::error_code error;
+    for(unsigned nodeIdx = 0;; ++nodeIdx) {
+        const std::filesystem::path cpuList = "/sys/devices/system/node/node" + std::to_string(nodeIdx) + "/cpulist";
+        if(!std::filesystem::exists(cpuList, error)) {
+            break;
+        }
+
+        // list of ranges, e.g. 0-3,8-11
+        std::ifstream ifs(cpuList);
+        std::vector<int> cores;
+        int first, last;
+        for(char separator = ','; separator == ',' && ifs >> first; separator = ifs.get()) {
+            last = first;
+            if(ifs.peek() == '-') {
+                ifs.get();
+                ifs >> last;
+            }
+
+            for(int cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu) {
+                if(CPU_ISSET(cpu, &allowed)) {
+                    cores.push_back(cpu);
+                }
+            }
+        }
+
+        if(!cores.empty()) {
+            nodes.push_back(std::move(cores));
+        }
+    }
+
+    if(nodes.empty()) {
+        nodes.emplace_back();
+        for(int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if(CPU_ISSET(cpu, &allowed)) {
+                nodes.back().push_back(cpu);
+            }
+        }
+    }
+#else
+    nodes.emplace_back();
+#endif
+
+    return nodes;
+}
+
+
+/**
+ * Long-lived pool of decoding threads which is reused by many calls of DecodingParallel.
+ * Threads are dedicated std::threads split between NUMA nodes, so all of them decode at once.
+ * Every node keeps its own replica of check matrix and syndrome, which is written by a thread of that node
+ * and is rewritten only when another instance is decoded. Threads of a node are bound to its cores,
+ * with pinThreads every thread is bound to one core
+ */
+class DecodingPool {
+    using TaskType = std::function<void(const BinaryMatrix&, const boost::dynamic_bitset<>&, unsigned)>;
+
+    struct Node {
+        std::vector<int> cores;
+        unsigned numThreads = 0;
+        unsigned firstThreadIdx = 0;
+        BinaryMatrix replicaOfMatrix;
+        boost::dynamic_bitset<> replicaOfSyndrome;
+    };
+
+    std::vector<Node> nodes;
+    unsigned numThreads;
+    std::vector<std::thread> threads;
+
+    /// Calls of Run from different threads take the pool in turn
+    std::mutex runMx;
+    std::mutex mx;
+    std::condition_variable jobIsReady;
+    std::condition_variable jobIsDone;
+    const TaskType* job = nullptr;
+    std::uint64_t generation = 0;
+    unsigned numberOfRunningThreads = 0;
+    bool isStopped = false;
+
+    static void BindToCores(const std::vector<int>& cores) {
+#ifdef __linux__
+        if(cores.empty()) {
+            return;
+        }
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for(const int cpu: cores) {
+            CPU_SET(cpu, &set);
+        }
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+    }
+
+    void Work(unsigned threadIdx, const TaskType& task) {
+        const Node& node = *std::find_if(nodes.begin(), nodes.end(), [threadIdx](const Node& node) {
+            return threadIdx < node.firstThreadIdx + node.numThreads;
+        });
+
+        task(node.replicaOfMatrix, node.replicaOfSyndrome, threadIdx);
+    }
+
+    void Loop(unsigned threadIdx) {
+        std::uint64_t seenGeneration = 0;
+        while(true) {
+            const TaskType* task;
+            {
+                std::unique_lock lock(mx);
+                jobIsReady.wait(lock, [&]() { return isStopped || generation != seenGeneration; });
+                if(isStopped) {
+                    return;
+                }
+                seenGeneration = generation;
+                task = job;
+            }
+
+            Work(threadIdx, *task);
+
+            std::lock_guard lock(mx);
+            if(--numberOfRunningThreads == 0) {
+                jobIsDone.notify_all();
+            }
+        }
+    }
+
+    /// Runs task on every thread of the pool and waits for all of them
+    void Dispatch(const TaskType& task) {
+        std::unique_lock lock(mx);
+        job = &task;
+        numberOfRunningThreads = numThreads;
+        ++generation;
+        jobIsReady.notify_all();
+
+        jobIsDone.wait(lock, [this]() { return numberOfRunningThreads == 0; });
+        job = nullptr;
+    }
+
+public:
+    /**
+     * @param numThreads number of decoding threads, may exceed number of cores
+     * @param pinThreads if true, every thread is pinned to one core of its node
+     */
+    explicit DecodingPool(unsigned numThreads = std::thread::hardware_concurrency(), bool pinThreads = true)
+        : numThreads(std::max(numThreads, 1u)) {
+        auto numaNodes = NumaNodeCores();
+        numaNodes.resize(std::min<std::size_t>(numaNodes.size(), this->numThreads));
+
+        nodes.resize(numaNodes.size());
+        for(std::size_t nodeIdx = 0, firstThreadIdx = 0; nodeIdx < nodes.size(); firstThreadIdx += nodes[nodeIdx++].numThreads) {
+            nodes[nodeIdx].cores = std::move(numaNodes[nodeIdx]);
+            nodes[nodeIdx].numThreads = this->numThreads / nodes.size() + (nodeIdx < this->numThreads % nodes.size());
+            nodes[nodeIdx].firstThreadIdx = firstThreadIdx;
+        }
+
+        for(const auto& node: nodes) {
+            for(unsigned localIdx = 0; localIdx < node.numThreads; ++localIdx) {
+                std::vector<int> cores = node.cores;
+                if(pinThreads && !cores.empty()) {
+                    cores = {node.cores[localIdx % node.cores.size()]};
+                } else if(nodes.size() == 1) {
+                    // there is no memory to keep local, threads are left to the OS scheduler
+                    cores.clear();
+                }
+
+                threads.emplace_back([this, threadIdx = node.firstThreadIdx + localIdx, cores = std::move(cores)]() {
+                    BindToCores(cores);
+                    Loop(threadIdx);
+                });
+            }
+        }
+    }
+
+    ~DecodingPool() {
+        {
+            std::lock_guard lock(mx);
+            isStopped = true;
+        }
+        jobIsReady.notify_all();
+
+        for(auto& thread: threads) {
+            thread.join();
+        }
+    }
+
+    DecodingPool(const DecodingPool&) = delete;
+    DecodingPool& operator=(const DecodingPool&) = delete;
+
+    unsigned NumberOfThreads() const {
+        return numThreads;
+    }
+
+    unsigned NumberOfNodes() const {
+        return nodes.size();
+    }
+
+    /**
+     * Runs task(replica of check matrix, replica of syndrome, index of thread) on every thread of the pool
+     * and waits for all of them. Replicas are shared by threads of one node, they are kept between calls
+     * and are rewritten by the first thread of the node only if checkMatrix or syndrome differ from them
+     */
+    template <typename Task>
+    void Run(const BinaryMatrix& checkMatrix, const boost::dynamic_bitset<>& syndrome, Task&& task) {
+        std::lock_guard runLock(runMx);
+        const TaskType replicate = [&](const BinaryMatrix&, const boost::dynamic_bitset<>&, unsigned threadIdx) {
+            for(auto& node: nodes) {
+                if(threadIdx == node.firstThreadIdx && !(node.replicaOfMatrix == checkMatrix && node.replicaOfSyndrome == syndrome)) {
+                    // copies are made by a thread of the node, so their memory is local for it
+                    node.replicaOfMatrix = checkMatrix;
+                    node.replicaOfSyndrome = syndrome;
+                }
+            }
+        };
+        Dispatch(replicate);
+
+        Dispatch(TaskType(std::ref(task)));
+    }
+};
+
+
+/**
+ * Parallel algorithm of decoding on threads of the pool
+ * @tparam DecodingStepAlgorithm type of algorithm (for example, ISD, Stern)
+ * @param checkMatrix binary check matrix
+ * @param syndrome syndrome vector
+ * @param omega number of errors in codeword (i.e. number of ones in error vector)
+ * @param algorithm algorithm for decoding
+ * @param pool pool of threads, only threads which lists fit into the memory budget decode
+ * @param progress periodic reports of progress, disabled by default
+ * @return error vector
+ */
+template <typename DecodingStepAlgorithm>
+boost::dynamic_bitset<> DecodingParallel(const BinaryMatrix& checkMatrix, const boost::dynamic_bitset<>& syndrome,
+                                         const unsigned omega, const DecodingStepAlgorithm& algorithm,
+                                         DecodingPool& pool, const ProgressOptions& progress = {}) {
+    boost::dynamic_bitset<> errorVector(checkMatrix.ColumnsSize());
+    std::atomic<bool> isFound = false;
+
+    const std::uint64_t seed = RandomPermutation::RandomSeed();
+    const unsigned numberOfThreads = ThreadsWithinBudget(algorithm, checkMatrix, pool.NumberOfThreads());
+    const auto reporter = StartProgress(progress, algorithm, checkMatrix, omega, numberOfThreads);
+
+    pool.Run(checkMatrix, syndrome, [&](const BinaryMatrix& replicaOfMatrix, const boost::dynamic_bitset<>& replicaOfSyndrome, unsigned threadIdx) {
+        if(threadIdx < numberOfThreads) {
+            ThreadTask(seed, threadIdx, numberOfThreads, replicaOfMatrix, replicaOfSyndrome, errorVector, omega, isFound, algorithm, reporter.get());
+        }
+    });
+
+    return errorVector;
+}
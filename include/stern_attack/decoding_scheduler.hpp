@@ -0,0 +1,357 @@
+#pragma once
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/thread.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <algebra/binary_matrix.hpp>
+#include <permutations/random_permutation_iterator.hpp>
+#include "isd_engine.hpp"
+#include "pipelined_decoding.hpp"
+
+
+enum class DecodingJobStatus {
+    Active,
+    Solved,
+    Expired
+};
+
+
+/**
+ * Options of one job of DecodingScheduler
+ */
+struct DecodingJobOptions {
+    /// Share of time of the pool is proportional to priority
+    double priority = 1;
+    /// Job is dropped when deadline is reached
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    /// Expected number of iterations to solution (e.g. from a cost model), needed for ETA
+    double expectedIterations = 0;
+};
+
+
+/**
+ * Progress of one job of DecodingScheduler
+ */
+struct DecodingJobReport {
+    const char* algorithmName;
+    DecodingJobStatus status;
+    std::uint64_t numberOfIterations;
+    double iterationsPerSecond;
+    /// Expected time to solution in seconds, known if the job has expected number of iterations and some rate
+    std::optional<double> etaSeconds;
+    /// Error vector if job is solved, else zero vector
+    boost::dynamic_bitset<> errorVector;
+};
+
+
+/**
+ * Decoding of many instances (H, s) on one set of threads. Every thread repeatedly takes the job
+ * with the least used time divided by priority (stride scheduling), so jobs of different sizes get
+ * shares of time proportional to their priorities.
+ * Jobs with the same check matrix share iterations: the permuted check matrix is eliminated once
+ * together with the matrix of row operations, which transforms syndromes of all these jobs
+ */
+class DecodingScheduler {
+public:
+    using JobId = std::size_t;
+    using Clock = std::chrono::steady_clock;
+
+private:
+    using SearchFunction = std::function<std::optional<boost::dynamic_bitset<>>(const BinaryMatrix&, const boost::dynamic_bitset<>&,
+                                                                                const std::atomic<bool>*)>;
+
+    struct MatrixGroup {
+        BinaryMatrix checkMatrix;
+        std::uint64_t seed;
+        std::uint64_t nextIndex = 0;
+        std::vector<JobId> jobs;
+        /// Average time of one iteration of the group, it is charged to jobs in advance
+        double averageSeconds = 0;
+        std::uint64_t numberOfIterations = 0;
+    };
+
+    struct Job {
+        std::size_t group;
+        boost::dynamic_bitset<> syndrome;
+        const char* algorithmName;
+        SearchFunction search;
+        DecodingJobOptions options;
+
+        DecodingJobStatus status = DecodingJobStatus::Active;
+        std::atomic<bool> isStopped = false;
+        std::uint64_t numberOfIterations = 0;
+        /// Used time divided by priority
+        double virtualTime = 0;
+        /// Time of the first iteration which served the job, its rate is measured from it
+        std::optional<Clock::time_point> start;
+        Clock::time_point finish;
+        boost::dynamic_bitset<> errorVector;
+    };
+
+    unsigned numThreads;
+    std::deque<MatrixGroup> groups;
+    std::deque<Job> jobs;
+    mutable std::mutex mx;
+
+    static double Seconds(Clock::duration duration) {
+        return std::chrono::duration<double>(duration).count();
+    }
+
+    /**
+     * Expires jobs after deadline and takes the group of the active job with the least virtual time.
+     * All active jobs of the group are served by the iteration and charged with its average time.
+     * Submit may push into deques while the iteration runs, so the iteration gets pointers to elements,
+     * which stay valid, instead of indexes into deques. Check matrix, seed, syndromes and search
+     * functions are not changed after Submit, so they are read without the lock
+     * @param servedJobs jobs which are served by the iteration
+     * @return group and permutation index, empty optional if there are no active jobs
+     */
+    std::optional<std::pair<MatrixGroup*, std::uint64_t>> Take(std::vector<Job*>& servedJobs) {
+        std::lock_guard lock(mx);
+        const auto now = Clock::now();
+
+        Job* next = nullptr;
+        for(auto& job: jobs) {
+            if(job.status == DecodingJobStatus::Active && job.options.deadline && now >= *job.options.deadline) {
+                job.status = DecodingJobStatus::Expired;
+                job.finish = now;
+                job.isStopped = true;
+            }
+
+            if(job.status == DecodingJobStatus::Active && (next == nullptr || job.virtualTime < next->virtualTime)) {
+                next = &job;
+            }
+        }
+
+        if(next == nullptr) {
+            return std::nullopt;
+        }
+
+        auto& group = groups[next->group];
+        servedJobs.clear();
+        for(const auto jobId: group.jobs) {
+            if(jobs[jobId].status == DecodingJobStatus::Active) {
+                servedJobs.push_back(&jobs[jobId]);
+            }
+        }
+
+        for(auto* job: servedJobs) {
+            job->virtualTime += group.averageSeconds / servedJobs.size() / job->options.priority;
+            if(!job->start) {
+                job->start = now;
+            }
+        }
+
+        return std::make_pair(&group, group.nextIndex++);
+    }
+
+    /**
+     * Gauss elimination of [I | H], the identity part becomes the matrix U of row operations, so
+     * the eliminated syndrome of every job is U*s
+     * @return eliminated check matrix and U, empty optional if elimination failed
+     */
+    static std::optional<std::pair<BinaryMatrix, BinaryMatrix>> EliminateWithRowOperations(const BinaryMatrix& permutedCheckMatrix) {
+        const unsigned rows = permutedCheckMatrix.RowsSize(), cols = permutedCheckMatrix.ColumnsSize();
+
+        BinaryMatrix augmented;
+        for(unsigned rowIdx = 0; rowIdx < rows; ++rowIdx) {
+            auto row = permutedCheckMatrix.getData()[rowIdx];
+            row.resize(rows + cols);
+            row <<= rows;
+            row.set(rowIdx);
+            augmented.addRow(row);
+        }
+
+        // pivots are the last rows columns, they are the same columns of H
+        boost::dynamic_bitset<> unusedSyndrome(rows);
+        if(!BinaryMatrix::GaussElimination(augmented, unusedSyndrome)) {
+            return std::nullopt;
+        }
+
+        BinaryMatrix eliminated, rowOperations;
+        for(auto& row: augmented.getData()) {
+            auto operations = row;
+            operations.resize(rows);
+            rowOperations.addRow(operations);
+
+            row >>= rows;
+            row.resize(cols);
+            eliminated.addRow(row);
+        }
+
+        return std::make_pair(std::move(eliminated), std::move(rowOperations));
+    }
+
+    void Work() {
+        std::vector<Job*> servedJobs;
+
+        while(auto taken = Take(servedJobs)) {
+            const auto [group, index] = *taken;
+            const unsigned cols = group->checkMatrix.ColumnsSize();
+            const auto begin = Clock::now();
+
+            const auto permutation = RandomPermutation(cols).Get(group->seed, index);
+            BinaryMatrix permutedCheckMatrix = group->checkMatrix.applyPermutation(permutation);
+
+            std::vector<std::optional<boost::dynamic_bitset<>>> permutedErrorVectors(servedJobs.size());
+            if(servedJobs.size() == 1) {
+                auto& job = *servedJobs.front();
+                auto syndrome = job.syndrome;
+
+                if(BinaryMatrix::GaussElimination(permutedCheckMatrix, syndrome)) {
+                    permutedErrorVectors.front() = job.search(permutedCheckMatrix, syndrome, &job.isStopped);
+                }
+            } else if(const auto eliminated = EliminateWithRowOperations(permutedCheckMatrix)) {
+                const auto& [eliminatedCheckMatrix, rowOperations] = *eliminated;
+
+                for(std::size_t servedIdx = 0; servedIdx < servedJobs.size(); ++servedIdx) {
+                    auto& job = *servedJobs[servedIdx];
+                    permutedErrorVectors[servedIdx] = job.search(eliminatedCheckMatrix, rowOperations.matVecMul(job.syndrome), &job.isStopped);
+                }
+            }
+
+            const auto end = Clock::now();
+            const double seconds = Seconds(end - begin);
+
+            std::lock_guard lock(mx);
+            const double chargedSeconds = group->averageSeconds;
+            ++group->numberOfIterations;
+            group->averageSeconds += (seconds - group->averageSeconds) / group->numberOfIterations;
+
+            for(std::size_t servedIdx = 0; servedIdx < servedJobs.size(); ++servedIdx) {
+                auto& job = *servedJobs[servedIdx];
+                job.virtualTime += (seconds - chargedSeconds) / servedJobs.size() / job.options.priority;
+
+                if(job.status != DecodingJobStatus::Active) {
+                    continue;
+                }
+
+                ++job.numberOfIterations;
+                if(permutedErrorVectors[servedIdx]) {
+                    job.errorVector.resize(cols);
+                    for(unsigned idx = 0; idx < cols; ++idx) {
+                        job.errorVector[permutation[idx]] = (*permutedErrorVectors[servedIdx])[idx];
+                    }
+
+                    job.status = DecodingJobStatus::Solved;
+                    job.finish = end;
+                    job.isStopped = true;
+                }
+            }
+        }
+    }
+
+public:
+    /**
+     * @param numThreads number of threads shared by all jobs
+     */
+    explicit DecodingScheduler(unsigned numThreads = std::thread::hardware_concurrency())
+        : numThreads(std::max(numThreads, 1u)) {}
+
+    /**
+     * Adds a job, check matrix is stored once for all jobs which share it
+     * @tparam DecodingStepAlgorithm type of algorithm which step is split into elimination and search (every ISDEngine)
+     * @param checkMatrix binary check matrix
+     * @param syndrome syndrome vector
+     * @param omega number of errors in codeword (i.e. number of ones in error vector)
+     * @param algorithm algorithm for decoding
+     * @param options priority, deadline and expected number of iterations
+     * @return id of job for Report
+     */
+    template <PipelinedAlgorithm DecodingStepAlgorithm>
+    JobId Submit(const BinaryMatrix& checkMatrix, const boost::dynamic_bitset<>& syndrome, const unsigned omega,
+                 const DecodingStepAlgorithm& algorithm, const DecodingJobOptions& options = DecodingJobOptions()) {
+        std::lock_guard lock(mx);
+
+        auto group = std::find_if(groups.begin(), groups.end(), [&checkMatrix](const MatrixGroup& group) {
+            return group.checkMatrix == checkMatrix;
+        });
+        if(group == groups.end()) {
+            group = groups.insert(groups.end(), MatrixGroup{checkMatrix, RandomPermutation::RandomSeed()});
+        }
+
+        const JobId jobId = jobs.size();
+        group->jobs.push_back(jobId);
+
+        auto& job = jobs.emplace_back();
+        job.group = static_cast<std::size_t>(group - groups.begin());
+        job.syndrome = syndrome;
+        job.algorithmName = algorithm.algorithmName;
+        job.search = [algorithm, omega](const BinaryMatrix& eliminatedCheckMatrix, const boost::dynamic_bitset<>& eliminatedSyndrome,
+                                        const std::atomic<bool>* stopFlag) {
+            return algorithm.Search(ISDContext(eliminatedCheckMatrix, eliminatedSyndrome, omega, stopFlag));
+        };
+        job.options = options;
+        job.options.priority = options.priority > 0 ? options.priority : 1;
+
+        // a job which comes later starts from the current virtual time, it does not get the time used before it
+        std::optional<double> currentVirtualTime;
+        for(const auto& other: jobs) {
+            if(&other != &job && other.status == DecodingJobStatus::Active) {
+                currentVirtualTime = std::min(currentVirtualTime.value_or(other.virtualTime), other.virtualTime);
+            }
+        }
+        job.virtualTime = currentVirtualTime.value_or(0);
+
+        return jobId;
+    }
+
+    /**
+     * Decodes all submitted jobs until every job is solved or expired
+     */
+    void Run() {
+        boost::thread_group threads;
+        for(unsigned threadIdx = 0; threadIdx < numThreads; ++threadIdx) {
+            threads.create_thread([this]() {
+                Work();
+            });
+        }
+
+        threads.join_all();
+    }
+
+    /**
+     * Progress of job, may be called while Run is in progress. Rate of a job is measured from its first
+     * iteration, so jobs submitted while Run is in progress are not charged for the time before them
+     */
+    DecodingJobReport Report(JobId jobId) const {
+        std::lock_guard lock(mx);
+        const auto& job = jobs.at(jobId);
+
+        const auto end = job.status == DecodingJobStatus::Active ? Clock::now() : job.finish;
+        const double seconds = job.start ? Seconds(end - *job.start) : 0;
+
+        DecodingJobReport report{job.algorithmName, job.status, job.numberOfIterations,
+                                 seconds > 0 ? job.numberOfIterations / seconds : 0, std::nullopt, job.errorVector};
+
+        // iterations are independent trials, so expected remaining number of iterations does not decrease
+        if(job.status == DecodingJobStatus::Active && job.options.expectedIterations > 0 && report.iterationsPerSecond > 0) {
+            report.etaSeconds = job.options.expectedIterations / report.iterationsPerSecond;
+        }
+
+        return report;
+    }
+
+    std::size_t NumberOfJobs() const {
+        std::lock_guard lock(mx);
+        return jobs.size();
+    }
+
+    /// Number of different check matrices, jobs with the same check matrix share eliminations
+    std::size_t NumberOfMatrices() const {
+        std::lock_guard lock(mx);
+        return groups.size();
+    }
+};
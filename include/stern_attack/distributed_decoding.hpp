@@ -0,0 +1,307 @@
+#pragma once
+
+#include <boost/asio.hpp>
+#include <boost/dynamic_bitset.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <algebra/binary_matrix.hpp>
+#include <permutations/random_permutation_iterator.hpp>
+#include "base_decoding.hpp"
+
+
+/**
+ * Coordinator of distributed decoding with many worker processes connected by TCP.
+ * Every iteration of decoding is a permutation given by (seed, index), the coordinator hands out
+ * disjoint ranges of indexes, so assignment of work costs one message per range. It verifies
+ * every found error vector and stops all workers as soon as one of them is correct.
+ * The protocol consists of text lines:
+ *   worker -> coordinator: "READY <number of iterations made since the last READY>", "FOUND <error vector>"
+ *   coordinator -> worker: "TASK <seed> <first index> <end index>", "STOP"
+ * Stopped worker reports its last READY and disconnects. All sessions are served by one thread, so the coordinator needs no locks
+ */
+class DecodingCoordinator {
+    using tcp = boost::asio::ip::tcp;
+
+    class Session : public std::enable_shared_from_this<Session> {
+        DecodingCoordinator& coordinator;
+        tcp::socket socket;
+        boost::asio::streambuf buffer;
+        std::deque<std::string> outgoing;
+        bool isStopped = false;
+
+    public:
+        Session(DecodingCoordinator& coordinator, tcp::socket socket) : coordinator(coordinator), socket(std::move(socket)) {}
+
+        void Start() {
+            Read();
+        }
+
+        void Stop() {
+            if(!isStopped) {
+                isStopped = true;
+                Send("STOP");
+            }
+        }
+
+    private:
+        void Read() {
+            boost::asio::async_read_until(socket, buffer, '\n', [self = shared_from_this()](boost::system::error_code error, std::size_t) {
+                if(error) {
+                    boost::system::error_code ignored;
+                    self->socket.close(ignored);
+                    return;
+                }
+
+                std::istream input(&self->buffer);
+                std::string line;
+                std::getline(input, line);
+
+                self->Handle(line);
+                self->Read();
+            });
+        }
+
+        void Handle(const std::string& line) {
+            std::istringstream message(line);
+            std::string command;
+            message >> command;
+
+            if(command == "READY") {
+                std::uint64_t numberOfIterations = 0;
+                message >> numberOfIterations;
+                coordinator.numberOfIterations += numberOfIterations;
+
+                if(coordinator.errorVector) {
+                    Stop();
+                } else {
+                    const auto begin = coordinator.nextIndex;
+                    coordinator.nextIndex += coordinator.batchSize;
+                    Send("TASK " + std::to_string(coordinator.seed) + ' ' + std::to_string(begin) + ' ' + std::to_string(coordinator.nextIndex));
+                }
+            } else if(command == "FOUND") {
+                std::string bits;
+                message >> bits;
+                coordinator.Verify(bits);
+            }
+        }
+
+        void Send(std::string message) {
+            outgoing.push_back(std::move(message) + '\n');
+            if(outgoing.size() == 1) {
+                Write();
+            }
+        }
+
+        void Write() {
+            boost::asio::async_write(socket, boost::asio::buffer(outgoing.front()), [self = shared_from_this()](boost::system::error_code error, std::size_t) {
+                self->outgoing.pop_front();
+
+                if(error) {
+                    self->outgoing.clear();
+                } else if(!self->outgoing.empty()) {
+                    self->Write();
+                } else if(self->isStopped) {
+                    // the last READY of the worker is still read, the session ends when the worker disconnects
+                    boost::system::error_code ignored;
+                    self->socket.shutdown(tcp::socket::shutdown_send, ignored);
+                }
+            });
+        }
+    };
+
+    boost::asio::io_context io;
+    tcp::acceptor acceptor;
+    std::vector<std::weak_ptr<Session>> sessions;
+
+    const BinaryMatrix& checkMatrix;
+    const boost::dynamic_bitset<>& syndrome;
+    unsigned omega;
+
+    std::uint64_t seed;
+    std::uint64_t batchSize;
+    std::uint64_t nextIndex = 0;
+    std::uint64_t numberOfIterations = 0;
+    std::optional<boost::dynamic_bitset<>> errorVector;
+
+    void Accept() {
+        acceptor.async_accept([this](boost::system::error_code error, tcp::socket socket) {
+            if(error) {
+                return;
+            }
+
+            auto session = std::make_shared<Session>(*this, std::move(socket));
+            sessions.push_back(session);
+            session->Start();
+
+            Accept();
+        });
+    }
+
+    void Verify(const std::string& bits) {
+        if(errorVector || bits.size() != checkMatrix.ColumnsSize() || bits.find_first_not_of("01") != std::string::npos) {
+            return;
+        }
+
+        boost::dynamic_bitset<> candidate(bits);
+        if(candidate.count() != omega || checkMatrix.matVecMul(candidate) != syndrome) {
+            return;
+        }
+
+        errorVector = std::move(candidate);
+
+        boost::system::error_code ignored;
+        acceptor.close(ignored);
+        for(auto& session: sessions) {
+            if(auto alive = session.lock()) {
+                alive->Stop();
+            }
+        }
+    }
+
+public:
+    /**
+     * @param checkMatrix binary check matrix, workers should use the same one
+     * @param syndrome syndrome vector
+     * @param omega number of errors in codeword (i.e. number of ones in error vector)
+     * @param port port to listen on loopback and other interfaces, 0 for any free port
+     * @param batchSize number of iterations in one task
+     * @param seed seed of permutations, random by default
+     */
+    DecodingCoordinator(const BinaryMatrix& checkMatrix, const boost::dynamic_bitset<>& syndrome, unsigned omega,
+                        unsigned short port = 0, std::uint64_t batchSize = 64, std::uint64_t seed = RandomPermutation::RandomSeed())
+        : acceptor(io, tcp::endpoint(tcp::v4(), port)), checkMatrix(checkMatrix), syndrome(syndrome), omega(omega),
+          seed(seed), batchSize(std::max<std::uint64_t>(batchSize, 1)) {}
+
+    unsigned short Port() const {
+        return acceptor.local_endpoint().port();
+    }
+
+    /**
+     * Serves workers until one of them finds an error vector
+     * @return verified error vector
+     */
+    boost::dynamic_bitset<> Run() {
+        Accept();
+        io.run();
+
+        return errorVector.value_or(boost::dynamic_bitset<>(checkMatrix.ColumnsSize()));
+    }
+
+    /// Number of iterations reported by workers, valid after Run
+    std::uint64_t NumberOfIterations() const {
+        return numberOfIterations;
+    }
+
+    /// Number of iterations handed out to workers, valid after Run
+    std::uint64_t NumberOfAssignedIterations() const {
+        return nextIndex;
+    }
+
+    std::size_t NumberOfWorkers() const {
+        return sessions.size();
+    }
+};
+
+
+/**
+ * Worker of distributed decoding: takes ranges of permutations from the coordinator until it is stopped.
+ * Stop requests are checked between iterations
+ * @tparam DecodingStepAlgorithm type of algorithm (for example, ISD, Stern)
+ * @param host address of coordinator
+ * @param port port of coordinator
+ * @param checkMatrix binary check matrix
+ * @param syndrome syndrome vector
+ * @param omega number of errors in codeword (i.e. number of ones in error vector)
+ * @param algorithm algorithm for decoding
+ * @return number of iterations made by the worker, 0 if coordinator is unreachable
+ */
+template <typename DecodingStepAlgorithm>
+std::uint64_t DecodingWorker(const std::string& host, unsigned short port, const BinaryMatrix& checkMatrix,
+                             const boost::dynamic_bitset<>& syndrome, const unsigned omega, const DecodingStepAlgorithm& algorithm) {
+    using tcp = boost::asio::ip::tcp;
+
+    boost::asio::io_context io;
+    tcp::socket socket(io);
+    boost::system::error_code error;
+
+    // coordinator which is unreachable or has already finished has no work
+    const auto endpoints = tcp::resolver(io).resolve(host, std::to_string(port), error);
+    if(!error) {
+        boost::asio::connect(socket, endpoints, error);
+    }
+    if(error) {
+        return 0;
+    }
+
+    const unsigned cols = checkMatrix.ColumnsSize();
+    RandomPermutation permutations(cols);
+    const auto randomPositions = NumberOfRandomPositions(algorithm, checkMatrix);
+    boost::asio::streambuf buffer;
+
+    const auto send = [&](const std::string& message) {
+        boost::asio::write(socket, boost::asio::buffer(message + '\n'), error);
+    };
+
+    std::uint64_t numberOfIterations = 0, iterationsOfTask = 0;
+    bool isStopped = false;
+    while(!isStopped && !error) {
+        send("READY " + std::to_string(iterationsOfTask));
+        iterationsOfTask = 0;
+
+        boost::asio::read_until(socket, buffer, '\n', error);
+        if(error) {
+            break;
+        }
+
+        std::istream input(&buffer);
+        std::string command;
+        std::uint64_t seed = 0, begin = 0, end = 0;
+        input >> command >> seed >> begin >> end;
+        input.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+        if(command != "TASK") {
+            return numberOfIterations;
+        }
+
+        for(auto index = begin; index < end; ++index) {
+            // the only message which is not an answer is STOP
+            if(buffer.size() > 0 || socket.available(error) > 0 || error) {
+                isStopped = true;
+                break;
+            }
+
+            const auto permutation = permutations.Get(seed, index, randomPositions);
+            BinaryMatrix permutedCheckMatrix = checkMatrix.applyPermutation(permutation);
+            auto copiedSyndrome = syndrome;
+
+            auto permutedErrorVector = algorithm(permutedCheckMatrix, copiedSyndrome, omega);
+            ++numberOfIterations;
+            ++iterationsOfTask;
+
+            if(permutedErrorVector) {
+                boost::dynamic_bitset<> errorVector(cols);
+                for(unsigned idx = 0; idx < cols; ++idx) {
+                    errorVector[permutation[idx]] = (*permutedErrorVector)[idx];
+                }
+
+                std::string bits;
+                boost::to_string(errorVector, bits);
+                send("FOUND " + bits);
+            }
+        }
+    }
+
+    send("READY " + std::to_string(iterationsOfTask));
+
+    return numberOfIterations;
+}
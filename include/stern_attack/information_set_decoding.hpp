@@ -7,10 +7,21 @@
 #include <algorithm>
 #include <cassert>
 #include <optional>
+#include <vector>
 
 #include <algebra/binary_matrix.hpp>
 #include <permutations/combination_iterator.hpp>
 #include "base_decoding.hpp"
+#include "instrumentation.hpp"
+
+
+/**
+ * Parameters of information-set decoding
+ */
+struct InformationSetDecodingParameters {
+    /// Weight of combinations of information set
+    unsigned p;
+};
 
 
 class InformationSetDecoding : public BaseAlgorithm {
@@ -18,17 +29,57 @@ class InformationSetDecoding : public BaseAlgorithm {
 
 public:
     constexpr static const char* algorithmName = "InformationSetDecoding";
+    using ParametersType = InformationSetDecodingParameters;
 
     /**
      * Creates an options object for ISD algorithm
-     * @param cols number of columns in matrix, %p will initialize as 0.003 * cols (it's optimal parameter)
+     * @param cols number of columns in matrix, %p will initialize as 0.003 * cols (rough default, see ParameterOptimizer)
     */
     InformationSetDecoding(unsigned cols) : p(static_cast<unsigned>(0.003 * cols) > 0 ? 0.003 * cols : 1) {}
 
+    /**
+     * Creates an options object for ISD algorithm with the given parameters (e.g. chosen by ParameterOptimizer)
+     */
+    InformationSetDecoding(InformationSetDecodingParameters parameters) : p(std::max(parameters.p, 1u)) {}
+
+    /**
+     * Parameters which ParameterOptimizer compares: p up to 4
+     */
+    static std::vector<InformationSetDecodingParameters> ParameterCandidates(unsigned rows, unsigned cols, unsigned omega) {
+        std::vector<InformationSetDecodingParameters> candidates;
+        for(unsigned p = 1; p <= 4 && p <= omega; ++p) {
+            candidates.push_back(InformationSetDecodingParameters{p});
+        }
+
+        return candidates;
+    }
+
+    /**
+     * Every p-combination of information set is a candidate, there are no lists
+     */
+    IterationWork ExpectedWork(unsigned rows, unsigned cols) const {
+        return IterationWork{0, std::exp(LogNumberOfCombinations(cols - rows, p))};
+    }
+
     unsigned getParams() const {
         return p;
     }
 
+    /**
+     * Expected number of iterations to the error vector: p errors in information set
+     */
+    double ExpectedIterations(unsigned rows, unsigned cols, unsigned omega) const {
+        const double logSuccesses = LogNumberOfCombinations(cols - rows, p) + LogNumberOfCombinations(rows, static_cast<int>(omega) - p);
+        return ::ExpectedIterations(LogNumberOfCombinations(cols, omega), logSuccesses);
+    }
+
+    /**
+     * Step depends only on the set of columns of Q, so only its positions of permutation are shuffled
+     */
+    unsigned NumberOfRandomPositions(unsigned rows, unsigned cols) const {
+        return cols - rows;
+    }
+
     /**
      * Makes one step of information-set decoding to already permuted check matrix
      * @param checkMatrix binary permuted check matrix for which gauss elimination should be applied
@@ -44,7 +95,9 @@ public:
         unsigned cols = checkMatrix.ColumnsSize();
         unsigned colsSizeOfQ = cols - rows;
 
+        const Instrumentation::PhaseTimer timer(DecodingPhase::Verification);
         for(auto combinationIter = Combination(p, colsSizeOfQ).begin(); combinationIter.CombinationsStillExist(); ++combinationIter) {
+            Instrumentation::Count(DecodingCounter::CandidateChecks);
             if((checkMatrix.sumOfColumns(*combinationIter) ^ syndrome).count() == omega - p){
                 boost::dynamic_bitset<> errorVector(cols);
 
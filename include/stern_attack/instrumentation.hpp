@@ -0,0 +1,376 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <utils/perf_events.hpp>
+
+#if defined(STERN_ATTACK_HARDWARE_COUNTERS) && !defined(STERN_ATTACK_INSTRUMENTATION)
+#define STERN_ATTACK_INSTRUMENTATION
+#endif
+
+
+/**
+ * Phases of one step of decoding. Time of nested phases is not counted in the outer one,
+ * e.g. verification of candidates is excluded from matching
+ */
+enum class DecodingPhase : unsigned {
+    Elimination,
+    ListConstruction,
+    SortHash,
+    Matching,
+    Verification,
+};
+
+/**
+ * Events of one step of decoding
+ */
+enum class DecodingCounter : unsigned {
+    /// Number of lists which are matched
+    Lists,
+    /// Total length of matched lists
+    ListEntries,
+    /// Number of pairs of entries with equal keys
+    Collisions,
+    /// Number of candidates which weight is checked
+    CandidateChecks,
+    /// Number of checks which are aborted before the whole residual is summed
+    EarlyAborts,
+};
+
+
+/**
+ * Time of phases and values of counters summed over steps and threads.
+ * Hardware events of phases are summed over threads which could count them
+ */
+struct InstrumentationReport {
+    static constexpr std::size_t numberOfPhases = 5;
+    static constexpr std::size_t numberOfCounters = 5;
+    static constexpr std::size_t numberOfEvents = hardwarePerfEvents.size();
+
+    static constexpr std::array<const char*, numberOfPhases> phaseNames{
+        "elimination", "list_construction", "sort_hash", "matching", "verification"};
+    static constexpr std::array<const char*, numberOfCounters> counterNames{
+        "lists", "list_entries", "collisions", "candidate_checks", "early_aborts"};
+
+    std::array<std::uint64_t, numberOfPhases> nanoseconds{};
+    std::array<std::uint64_t, numberOfCounters> counters{};
+    std::array<std::array<std::uint64_t, numberOfEvents>, numberOfPhases> events{};
+    /// Number of threads which counted the event, events without threads are not supported by the machine
+    std::array<std::uint64_t, numberOfEvents> countingThreads{};
+
+    double Seconds(DecodingPhase phase) const {
+        return nanoseconds[static_cast<unsigned>(phase)] * 1e-9;
+    }
+
+    std::uint64_t Count(DecodingCounter counter) const {
+        return counters[static_cast<unsigned>(counter)];
+    }
+
+    bool IsEventCounted(std::size_t event) const {
+        return countingThreads[event] > 0;
+    }
+
+    /**
+     * @param event index of event in hardwarePerfEvents
+     */
+    std::uint64_t Event(DecodingPhase phase, std::size_t event) const {
+        return events[static_cast<unsigned>(phase)][event];
+    }
+
+    InstrumentationReport& operator+=(const InstrumentationReport& other) {
+        for(std::size_t idx = 0; idx < numberOfPhases; ++idx) {
+            nanoseconds[idx] += other.nanoseconds[idx];
+        }
+        for(std::size_t idx = 0; idx < numberOfCounters; ++idx) {
+            counters[idx] += other.counters[idx];
+        }
+        for(std::size_t event = 0; event < numberOfEvents; ++event) {
+            for(std::size_t phase = 0; phase < numberOfPhases; ++phase) {
+                events[phase][event] += other.events[phase][event];
+            }
+            countingThreads[event] += other.countingThreads[event];
+        }
+
+        return *this;
+    }
+
+    /// Difference of reports collected after and before a run, threads which counted events are kept
+    InstrumentationReport& operator-=(const InstrumentationReport& other) {
+        for(std::size_t idx = 0; idx < numberOfPhases; ++idx) {
+            nanoseconds[idx] -= other.nanoseconds[idx];
+        }
+        for(std::size_t idx = 0; idx < numberOfCounters; ++idx) {
+            counters[idx] -= other.counters[idx];
+        }
+        for(std::size_t event = 0; event < numberOfEvents; ++event) {
+            for(std::size_t phase = 0; phase < numberOfPhases; ++phase) {
+                events[phase][event] -= other.events[phase][event];
+            }
+        }
+
+        return *this;
+    }
+
+    friend InstrumentationReport operator+(InstrumentationReport lhs, const InstrumentationReport& rhs) {
+        return lhs += rhs;
+    }
+
+    friend InstrumentationReport operator-(InstrumentationReport lhs, const InstrumentationReport& rhs) {
+        return lhs -= rhs;
+    }
+
+    /**
+     * Writes report as named statistics, e.g. "time_ns.matching", "count.collisions" and
+     * "events.matching.cycles", only counted hardware events are written
+     */
+    void Save(std::map<std::string, std::uint64_t>& statistics) const {
+        for(std::size_t idx = 0; idx < numberOfPhases; ++idx) {
+            statistics[std::string("time_ns.") + phaseNames[idx]] = nanoseconds[idx];
+        }
+        for(std::size_t idx = 0; idx < numberOfCounters; ++idx) {
+            statistics[std::string("count.") + counterNames[idx]] = counters[idx];
+        }
+        for(std::size_t event = 0; event < numberOfEvents; ++event) {
+            if(!IsEventCounted(event)) {
+                continue;
+            }
+
+            statistics[std::string("event_threads.") + hardwarePerfEvents[event].name] = countingThreads[event];
+            for(std::size_t phase = 0; phase < numberOfPhases; ++phase) {
+                statistics[std::string("events.") + phaseNames[phase] + '.' + hardwarePerfEvents[event].name] = events[phase][event];
+            }
+        }
+    }
+
+    /**
+     * Reads report written by Save, missing statistics are zero
+     */
+    static InstrumentationReport Load(const std::map<std::string, std::uint64_t>& statistics) {
+        InstrumentationReport report;
+
+        const auto value = [&statistics](const std::string& name) {
+            const auto iter = statistics.find(name);
+            return iter != statistics.end() ? iter->second : 0;
+        };
+
+        for(std::size_t idx = 0; idx < numberOfPhases; ++idx) {
+            report.nanoseconds[idx] = value(std::string("time_ns.") + phaseNames[idx]);
+        }
+        for(std::size_t idx = 0; idx < numberOfCounters; ++idx) {
+            report.counters[idx] = value(std::string("count.") + counterNames[idx]);
+        }
+        for(std::size_t event = 0; event < numberOfEvents; ++event) {
+            report.countingThreads[event] = value(std::string("event_threads.") + hardwarePerfEvents[event].name);
+            for(std::size_t phase = 0; phase < numberOfPhases; ++phase) {
+                report.events[phase][event] = value(std::string("events.") + phaseNames[phase] + '.' + hardwarePerfEvents[event].name);
+            }
+        }
+
+        return report;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const InstrumentationReport& report) {
+        for(std::size_t idx = 0; idx < numberOfPhases; ++idx) {
+            os << phaseNames[idx] << ": " << report.nanoseconds[idx] * 1e-9 << " s\n";
+        }
+        for(std::size_t idx = 0; idx < numberOfCounters; ++idx) {
+            os << counterNames[idx] << ": " << report.counters[idx] << '\n';
+        }
+
+        for(std::size_t phase = 0; phase < numberOfPhases; ++phase) {
+            for(std::size_t event = 0; event < numberOfEvents; ++event) {
+                if(report.IsEventCounted(event)) {
+                    os << phaseNames[phase] << '.' << hardwarePerfEvents[event].name << ": " << report.events[phase][event] << '\n';
+                }
+            }
+        }
+
+        const auto lists = report.Count(DecodingCounter::Lists);
+        if(lists > 0) {
+            os << "average length of list: " << report.Count(DecodingCounter::ListEntries) / static_cast<double>(lists) << '\n';
+        }
+
+        return os;
+    }
+};
+
+
+/**
+ * Per-phase instrumentation of decoding steps. It is compiled in only if STERN_ATTACK_INSTRUMENTATION
+ * is defined, otherwise PhaseTimer and Count are empty and Collect returns zero report.
+ * STERN_ATTACK_HARDWARE_COUNTERS also enables hardware events of phases (see PerfEventGroup), every switch
+ * of phase reads them by a system call, so time of short phases is overestimated in this mode.
+ * Every thread accumulates its own record without synchronization (counters are relaxed atomics written
+ * only by the owner), records of all threads, alive and finished, are merged by Collect
+ */
+class Instrumentation {
+public:
+#ifdef STERN_ATTACK_INSTRUMENTATION
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+#ifdef STERN_ATTACK_HARDWARE_COUNTERS
+    static constexpr bool hardwareCounters = true;
+#else
+    static constexpr bool hardwareCounters = false;
+#endif
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr unsigned noPhase = InstrumentationReport::numberOfPhases;
+
+    struct ThreadRecord {
+        std::array<std::atomic<std::uint64_t>, InstrumentationReport::numberOfPhases> nanoseconds{};
+        std::array<std::atomic<std::uint64_t>, InstrumentationReport::numberOfCounters> counters{};
+        unsigned currentPhase = noPhase;
+        Clock::time_point phaseStart;
+#ifdef STERN_ATTACK_HARDWARE_COUNTERS
+        std::array<std::array<std::atomic<std::uint64_t>, InstrumentationReport::numberOfEvents>, InstrumentationReport::numberOfPhases> events{};
+        PerfEventGroup group{hardwarePerfEvents};
+        /// Values of events at the last switch of phase
+        std::array<std::uint64_t, InstrumentationReport::numberOfEvents> eventsAtSwitch{};
+#endif
+
+        ThreadRecord();
+        ~ThreadRecord();
+
+        InstrumentationReport Snapshot() const {
+            InstrumentationReport report;
+            for(std::size_t idx = 0; idx < report.nanoseconds.size(); ++idx) {
+                report.nanoseconds[idx] = nanoseconds[idx].load(std::memory_order_relaxed);
+            }
+            for(std::size_t idx = 0; idx < report.counters.size(); ++idx) {
+                report.counters[idx] = counters[idx].load(std::memory_order_relaxed);
+            }
+#ifdef STERN_ATTACK_HARDWARE_COUNTERS
+            for(std::size_t event = 0; event < InstrumentationReport::numberOfEvents; ++event) {
+                for(std::size_t phase = 0; phase < InstrumentationReport::numberOfPhases; ++phase) {
+                    report.events[phase][event] = events[phase][event].load(std::memory_order_relaxed);
+                }
+                report.countingThreads[event] = group.IsCounted(event);
+            }
+#endif
+
+            return report;
+        }
+
+        /// Time since the last switch of phase goes to the current phase
+        void Switch(unsigned phase, Clock::time_point now) {
+            if(currentPhase != noPhase) {
+                Add(nanoseconds[currentPhase], std::chrono::duration_cast<std::chrono::nanoseconds>(now - phaseStart).count());
+            }
+#ifdef STERN_ATTACK_HARDWARE_COUNTERS
+            std::array<std::uint64_t, InstrumentationReport::numberOfEvents> values;
+            if(group.Read(values)) {
+                for(std::size_t event = 0; currentPhase != noPhase && event < values.size(); ++event) {
+                    // scaled values of multiplexed group may decrease a little
+                    Add(events[currentPhase][event], values[event] > eventsAtSwitch[event] ? values[event] - eventsAtSwitch[event] : 0);
+                }
+                eventsAtSwitch = values;
+            }
+#endif
+            currentPhase = phase;
+            phaseStart = now;
+        }
+    };
+
+    struct Registry {
+        std::mutex mx;
+        std::vector<const ThreadRecord*> records;
+        /// Sum of records of finished threads
+        InstrumentationReport finished;
+    };
+
+    static Registry& GetRegistry() {
+        static Registry registry;
+        return registry;
+    }
+
+    static ThreadRecord& Record() {
+        thread_local ThreadRecord record;
+        return record;
+    }
+
+    /// Only the owner thread writes, so plain load and store are enough
+    static void Add(std::atomic<std::uint64_t>& value, std::uint64_t increment) {
+        value.store(value.load(std::memory_order_relaxed) + increment, std::memory_order_relaxed);
+    }
+
+public:
+    /**
+     * Charges time of its scope to the phase, the phase of outer scope is paused until the end of the scope
+     */
+    class PhaseTimer {
+#ifdef STERN_ATTACK_INSTRUMENTATION
+        unsigned previousPhase;
+
+    public:
+        explicit PhaseTimer(DecodingPhase phase) {
+            auto& record = Record();
+            previousPhase = record.currentPhase;
+            record.Switch(static_cast<unsigned>(phase), Clock::now());
+        }
+
+        ~PhaseTimer() {
+            Record().Switch(previousPhase, Clock::now());
+        }
+#else
+    public:
+        explicit PhaseTimer(DecodingPhase) {}
+#endif
+
+        PhaseTimer(const PhaseTimer&) = delete;
+        PhaseTimer& operator=(const PhaseTimer&) = delete;
+    };
+
+    static void Count([[maybe_unused]] DecodingCounter counter, [[maybe_unused]] std::uint64_t increment = 1) {
+        if constexpr (enabled) {
+            Add(Record().counters[static_cast<unsigned>(counter)], increment);
+        }
+    }
+
+    /**
+     * Sum of records of all threads since the start of program. Measurements of a run are
+     * the difference of reports collected after and before it
+     */
+    static InstrumentationReport Collect() {
+        if constexpr (!enabled) {
+            return InstrumentationReport();
+        }
+
+        auto& registry = GetRegistry();
+        std::lock_guard lock(registry.mx);
+
+        auto report = registry.finished;
+        for(const auto record: registry.records) {
+            report += record->Snapshot();
+        }
+
+        return report;
+    }
+};
+
+
+inline Instrumentation::ThreadRecord::ThreadRecord() {
+    auto& registry = GetRegistry();
+    std::lock_guard lock(registry.mx);
+    registry.records.push_back(this);
+}
+
+inline Instrumentation::ThreadRecord::~ThreadRecord() {
+    auto& registry = GetRegistry();
+    std::lock_guard lock(registry.mx);
+    registry.finished += Snapshot();
+    std::erase(registry.records, this);
+}
@@ -0,0 +1,438 @@
+#pragma once
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <algebra/binary_matrix.hpp>
+#include <algebra/packed_matrix.hpp>
+#include "base_decoding.hpp"
+#include "instrumentation.hpp"
+#include "list_matching.hpp"
+#include "memory_accounting.hpp"
+
+
+/**
+ * Check matrix after gauss elimination shared by all stages of one iteration.
+ * The matrix is in systematic form [Q | I], its columns are packed into words,
+ * so sum of columns is a xor of few contiguous words
+ */
+class ISDContext {
+public:
+    using WordType = PackedMatrix::WordType;
+
+private:
+    PackedMatrix columns;
+    std::vector<WordType> packedSyndrome;
+    unsigned rows;
+    unsigned cols;
+    unsigned omega;
+    const std::atomic<bool>* stopFlag;
+
+public:
+    /**
+     * @param checkMatrix check matrix after gauss elimination
+     * @param syndrome syndrome after gauss elimination
+     * @param omega number of errors in codeword
+     * @param stopFlag flag of cancellation set by other threads, may be null
+     */
+    ISDContext(const BinaryMatrix& checkMatrix, const boost::dynamic_bitset<>& syndrome, const unsigned omega,
+               const std::atomic<bool>* stopFlag = nullptr)
+        : ISDContext(PackedMatrix(checkMatrix).Transposed(), syndrome, omega, stopFlag) {}
+
+    /**
+     * Context of columns which are packed already, e.g. the systematic form of a mapped instance,
+     * a view is kept as it is, so nothing is copied
+     * @param columns columns of check matrix after gauss elimination, i.e. rows of its transpose
+     * @param syndrome syndrome after gauss elimination
+     */
+    ISDContext(PackedMatrix columns, const boost::dynamic_bitset<>& syndrome, const unsigned omega,
+               const std::atomic<bool>* stopFlag = nullptr)
+        : columns(std::move(columns)), packedSyndrome(PackedMatrix::WordsFor(syndrome.size())),
+          rows(syndrome.size()), cols(this->columns.RowsSize()), omega(omega), stopFlag(stopFlag) {
+        assert(this->columns.ColumnsSize() == rows);
+        boost::to_block_range(syndrome, packedSyndrome.begin());
+    }
+
+    /// Cheap enough to be checked for every enumerated entry, enumerators leave lists incomplete on stop
+    bool StopRequested() const {
+        return stopFlag != nullptr && stopFlag->load(std::memory_order_relaxed);
+    }
+
+    unsigned RowsSize() const {
+        return rows;
+    }
+
+    unsigned ColumnsSize() const {
+        return cols;
+    }
+
+    /// Number of columns in Q, i.e. k
+    unsigned InformationSetSize() const {
+        return cols - rows;
+    }
+
+    unsigned Omega() const {
+        return omega;
+    }
+
+    /**
+     * Projections of columns onto rows [start, start + length)
+     * @param endCol columns [0, endCol) are projected
+     * @return vector which i-th element is the key of i-th column
+     */
+    std::vector<KeyType> ColumnKeys(unsigned endCol, unsigned start, unsigned length) const {
+        std::vector<KeyType> keys(endCol);
+
+        for(unsigned col = 0; col < endCol; ++col) {
+            keys[col] = columns.Window(col, start, length);
+        }
+
+        return keys;
+    }
+
+    /**
+     * Identifier of the iteration: hash of the eliminated syndrome and the first word of every column.
+     * Eliminated matrix is a function of the seed of decoding and the index of permutation, so
+     * iterations of different runs, threads and permutations get different identifiers, which seed
+     * random choices of an iteration (e.g. splits of Stern algorithm)
+     */
+    std::uint64_t IterationIdentifier() const {
+        std::uint64_t hash = cols;
+        const auto mix = [&hash](std::uint64_t word) {
+            hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+            hash ^= hash >> 32;
+        };
+
+        for(const auto word: packedSyndrome) {
+            mix(word);
+        }
+        for(unsigned col = 0; col < cols; ++col) {
+            mix(columns.Row(col)[0]);
+        }
+
+        return hash;
+    }
+
+    KeyType SyndromeKey(unsigned start, unsigned length) const {
+        assert(length <= maxKeyLength);
+
+        const std::size_t word = start / PackedMatrix::bitsPerWord;
+        const unsigned offset = start % PackedMatrix::bitsPerWord;
+
+        KeyType value = packedSyndrome[word] >> offset;
+        if(offset != 0 && word + 1 < packedSyndrome.size()) {
+            value |= packedSyndrome[word + 1] << (PackedMatrix::bitsPerWord - offset);
+        }
+
+        return length == maxKeyLength ? value : value & ((KeyType(1) << length) - 1);
+    }
+
+    /**
+     * Checks that columns of Q from indexes together with residual syndrome form an error vector
+     * of weight omega. Columns of identity part are skipped: they are fully determined by the residual.
+     * Weight of residual is accumulated word by word and check is aborted as soon as it exceeds the budget
+     * @param indexes indexes of columns of check matrix without duplicates
+     * @return error vector if success, else empty optional
+     */
+    std::optional<boost::dynamic_bitset<>> ErrorVector(std::span<const unsigned> indexes) const {
+        const unsigned k = InformationSetSize();
+        const auto weightOnQ = static_cast<unsigned>(std::count_if(indexes.begin(), indexes.end(), [k](unsigned idx) {
+            return idx < k;
+        }));
+
+        Instrumentation::Count(DecodingCounter::CandidateChecks);
+        if(weightOnQ > omega) {
+            Instrumentation::Count(DecodingCounter::EarlyAborts);
+            return std::optional<boost::dynamic_bitset<>>();
+        }
+
+        const auto residualWord = [&](std::size_t wordIdx) {
+            WordType residual = packedSyndrome[wordIdx];
+            for(const auto idx: indexes) {
+                if(idx < k) {
+                    residual ^= columns.Row(idx)[wordIdx];
+                }
+            }
+            return residual;
+        };
+
+        const unsigned budget = omega - weightOnQ;
+        unsigned residualWeight = 0;
+        for(std::size_t wordIdx = 0; wordIdx < packedSyndrome.size(); ++wordIdx) {
+            residualWeight += std::popcount(residualWord(wordIdx));
+
+            if(residualWeight > budget) {
+                Instrumentation::Count(DecodingCounter::EarlyAborts);
+                return std::optional<boost::dynamic_bitset<>>();
+            }
+        }
+
+        if(residualWeight != budget) {
+            return std::optional<boost::dynamic_bitset<>>();
+        }
+
+        boost::dynamic_bitset<> errorVector(cols);
+        for(const auto idx: indexes) {
+            if(idx < k) {
+                errorVector.set(idx);
+            }
+        }
+
+        for(std::size_t wordIdx = 0; wordIdx < packedSyndrome.size(); ++wordIdx) {
+            for(WordType residual = residualWord(wordIdx); residual != 0; residual &= residual - 1) {
+                errorVector.set(k + wordIdx * PackedMatrix::bitsPerWord + std::countr_zero(residual));
+            }
+        }
+
+        return std::optional<boost::dynamic_bitset<>>(errorVector);
+    }
+};
+
+
+/**
+ * Verifies union of two disjoint index tuples (Stern-like algorithms)
+ */
+struct UnionVerifier {
+    std::optional<boost::dynamic_bitset<>> operator()(const ISDContext& context, std::span<const unsigned> left, std::span<const unsigned> right) const {
+        std::vector<unsigned> indexColumns;
+        indexColumns.reserve(left.size() + right.size());
+        indexColumns.insert(indexColumns.end(), left.begin(), left.end());
+        indexColumns.insert(indexColumns.end(), right.begin(), right.end());
+
+        return context.ErrorVector(indexColumns);
+    }
+};
+
+
+/**
+ * Verifies symmetric difference of two sorted index tuples (MMT-like algorithms,
+ * where both tuples may contain the same column)
+ */
+struct SymmetricDifferenceVerifier {
+    std::optional<boost::dynamic_bitset<>> operator()(const ISDContext& context, std::span<const unsigned> left, std::span<const unsigned> right) const {
+        std::vector<unsigned> indexColumns;
+        indexColumns.reserve(left.size() + right.size());
+
+        std::set_symmetric_difference(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(indexColumns));
+
+        return context.ErrorVector(indexColumns);
+    }
+};
+
+
+/**
+ * Storage of (key, index tuple) entries
+ */
+template <typename StoreType>
+concept ListStore = std::default_initializable<StoreType> &&
+    requires(StoreType store, const StoreType constStore, KeyType key, std::span<const unsigned> tuple, std::size_t pos) {
+        store.Clear();
+        store.Reserve(pos, pos);
+        store.Add(key, tuple);
+        store.Finalize();
+        { constStore.size() } -> std::convertible_to<std::size_t>;
+        { constStore.Key(pos) } -> std::convertible_to<KeyType>;
+        { constStore.Indexes(pos) } -> std::convertible_to<std::span<const unsigned>>;
+    };
+
+namespace detail {
+    struct CollisionCallbackArchetype {
+        std::optional<boost::dynamic_bitset<>> operator()(std::size_t, std::size_t) const;
+    };
+}
+
+/**
+ * Finds all pairs of entries with equal keys in two finalized lists
+ */
+template <typename MatcherType, typename LeftStoreType, typename RightStoreType>
+concept Matcher = ListStore<LeftStoreType> && ListStore<RightStoreType> &&
+    requires(const MatcherType matcher, const LeftStoreType& left, const RightStoreType& right, detail::CollisionCallbackArchetype onCollision) {
+        { matcher(left, right, onCollision) } -> std::same_as<std::optional<boost::dynamic_bitset<>>>;
+    };
+
+/**
+ * Turns a pair of matched index tuples into an error vector
+ */
+template <typename VerifierType>
+concept Verifier = std::default_initializable<VerifierType> &&
+    requires(const VerifierType verifier, const ISDContext& context, std::span<const unsigned> tuple) {
+        { verifier(context, tuple, tuple) } -> std::same_as<std::optional<boost::dynamic_bitset<>>>;
+    };
+
+/**
+ * Fills two lists which collisions are candidates for an error vector
+ */
+template <typename EnumeratorType>
+concept Enumerator = ListStore<typename EnumeratorType::LeftStoreType> && ListStore<typename EnumeratorType::RightStoreType> &&
+    requires(const EnumeratorType enumerator, const ISDContext& context,
+             typename EnumeratorType::LeftStoreType& left, typename EnumeratorType::RightStoreType& right) {
+        enumerator.Enumerate(context, left, right);
+        enumerator.getParams();
+    };
+
+/**
+ * Enumerator which reuses one elimination for several rounds of matching,
+ * lists of round r are enumerated by Enumerate(context, left, right, r)
+ */
+template <typename EnumeratorType>
+concept MultiRoundEnumerator = Enumerator<EnumeratorType> &&
+    requires(const EnumeratorType enumerator, const ISDContext& context, unsigned round,
+             typename EnumeratorType::LeftStoreType& left, typename EnumeratorType::RightStoreType& right) {
+        { enumerator.NumberOfRounds(context) } -> std::convertible_to<unsigned>;
+        enumerator.Enumerate(context, left, right, round);
+    };
+
+/**
+ * Full description of the algorithm: its name and enumerator, matcher and verifier types
+ */
+template <typename Policy>
+concept DecodingPolicy = requires {
+        { Policy::algorithmName } -> std::convertible_to<const char*>;
+    } &&
+    Enumerator<typename Policy::EnumeratorType> &&
+    Matcher<typename Policy::MatcherType, typename Policy::EnumeratorType::LeftStoreType, typename Policy::EnumeratorType::RightStoreType> &&
+    Verifier<typename Policy::VerifierType>;
+
+
+/**
+ * One step of list-based information-set decoding: gauss elimination, building of lists,
+ * matching them and verification of candidates. Every stage is resolved at compile time,
+ * so one implementation of kernels is inlined into every algorithm.
+ * Multi-round enumerators repeat building and matching of lists after one elimination.
+ * Constructor and parameters are inherited from the enumerator.
+ * Memory of lists is counted for the algorithm and its copies, e.g. all threads of parallel decoding
+ * @tparam Policy type satisfying DecodingPolicy
+ */
+template <DecodingPolicy Policy>
+class ISDEngine : public BaseAlgorithm, public Policy::EnumeratorType {
+    std::shared_ptr<MemoryCounter> memoryOfLists = std::make_shared<MemoryCounter>();
+
+public:
+    using EnumeratorType = typename Policy::EnumeratorType;
+    using LeftStoreType = typename EnumeratorType::LeftStoreType;
+    using RightStoreType = typename EnumeratorType::RightStoreType;
+    using MatcherType = typename Policy::MatcherType;
+    using VerifierType = typename Policy::VerifierType;
+
+    constexpr static const char* algorithmName = Policy::algorithmName;
+
+    using EnumeratorType::EnumeratorType;
+
+    /// Bytes of lists of steps which are running now and the peak of them
+    MemoryUsage MemoryOfLists() const {
+        return memoryOfLists->Usage();
+    }
+
+    /**
+     * Makes one step of decoding to already permuted check matrix
+     * @param checkMatrix binary permuted check matrix for which gauss elimination should be applied
+     * @param syndrome syndrome vector
+     * @param omega number of errors in codeword (i.e. number of ones in error vector)
+     * @return filled std::optional<boost::dynamic_bitset<>> if success, else empty optional
+     */
+    std::optional<boost::dynamic_bitset<>> operator()(BinaryMatrix& checkMatrix, boost::dynamic_bitset<> syndrome, const unsigned omega) const {
+        return Step(checkMatrix, std::move(syndrome), omega, nullptr);
+    }
+
+    /**
+     * Makes one step of decoding which is cancelled as soon as stopFlag is set
+     * @param stopFlag flag of cancellation set by other threads
+     * @return filled std::optional<boost::dynamic_bitset<>> if success, else empty optional
+     */
+    std::optional<boost::dynamic_bitset<>> operator()(BinaryMatrix& checkMatrix, boost::dynamic_bitset<> syndrome, const unsigned omega,
+                                                      const std::atomic<bool>& stopFlag) const {
+        return Step(checkMatrix, std::move(syndrome), omega, &stopFlag);
+    }
+
+    /**
+     * The first stage of a step: gauss elimination of already permuted check matrix and packing of its columns
+     * @param stopFlag flag of cancellation which is checked by Search, may be null
+     * @return context of the step, empty optional if elimination failed
+     */
+    std::optional<ISDContext> Eliminate(BinaryMatrix& checkMatrix, boost::dynamic_bitset<> syndrome, const unsigned omega,
+                                        const std::atomic<bool>* stopFlag = nullptr) const {
+        const Instrumentation::PhaseTimer timer(DecodingPhase::Elimination);
+        if(!GaussElimination(checkMatrix, syndrome)) {
+            return std::optional<ISDContext>();
+        }
+
+        return std::optional<ISDContext>(std::in_place, checkMatrix, syndrome, omega, stopFlag);
+    }
+
+    /**
+     * The second stage of a step: building and matching of lists of all rounds
+     * @param context context made by Eliminate
+     * @return error vector for permuted check matrix if success, else empty optional
+     */
+    std::optional<boost::dynamic_bitset<>> Search(const ISDContext& context) const {
+        const MemoryAccounting::Scope memoryScope(memoryOfLists.get());
+        LeftStoreType left;
+        RightStoreType right;
+        const VerifierType verifier;
+
+        unsigned numberOfRounds = 1;
+        if constexpr (MultiRoundEnumerator<EnumeratorType>) {
+            numberOfRounds = this->NumberOfRounds(context);
+        }
+
+        for(unsigned round = 0; round < numberOfRounds; ++round) {
+            {
+                const Instrumentation::PhaseTimer timer(DecodingPhase::ListConstruction);
+                if constexpr (MultiRoundEnumerator<EnumeratorType>) {
+                    this->Enumerate(context, left, right, round);
+                } else {
+                    this->Enumerate(context, left, right);
+                }
+            }
+
+            if(context.StopRequested()) {
+                break;
+            }
+
+            {
+                const Instrumentation::PhaseTimer timer(DecodingPhase::SortHash);
+                left.Finalize();
+                right.Finalize();
+            }
+
+            Instrumentation::Count(DecodingCounter::Lists, 2);
+            Instrumentation::Count(DecodingCounter::ListEntries, left.size() + right.size());
+
+            const Instrumentation::PhaseTimer timer(DecodingPhase::Matching);
+            auto errorVector = MatcherType()(left, right, [&](std::size_t leftPos, std::size_t rightPos) {
+                Instrumentation::Count(DecodingCounter::Collisions);
+
+                const Instrumentation::PhaseTimer timer(DecodingPhase::Verification);
+                return verifier(context, left.Indexes(leftPos), right.Indexes(rightPos));
+            });
+
+            if(errorVector) {
+                return errorVector;
+            }
+        }
+
+        return std::optional<boost::dynamic_bitset<>>();
+    }
+
+private:
+    std::optional<boost::dynamic_bitset<>> Step(BinaryMatrix& checkMatrix, boost::dynamic_bitset<> syndrome, const unsigned omega,
+                                                const std::atomic<bool>* stopFlag) const {
+        const auto context = Eliminate(checkMatrix, std::move(syndrome), omega, stopFlag);
+        if(!context) {
+            return std::optional<boost::dynamic_bitset<>>();
+        }
+
+        return Search(*context);
+    }
+};
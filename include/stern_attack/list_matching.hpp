@@ -0,0 +1,251 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <utils/radixsort.hpp>
+#include "memory_accounting.hpp"
+
+
+/// Projection of a sum of columns onto a collision window packed into one word
+using KeyType = std::uint64_t;
+
+/// Maximal width of a collision window which fits into KeyType
+constexpr unsigned maxKeyLength = std::numeric_limits<KeyType>::digits;
+
+
+/**
+ * List of (key, tuple of column indexes) entries. Tuples are kept in one flat array
+ * and entries refer to them by id, so only 16-byte entries are moved by sorting.
+ * Memory of lists is counted by MemoryAccounting
+ */
+class UnorderedList {
+protected:
+    struct Entry {
+        KeyType key;
+        std::uint32_t id;
+    };
+
+    AccountedVector<Entry> entries;
+    AccountedVector<unsigned> indexes;
+    AccountedVector<std::uint32_t> offsets{0};
+
+    std::span<const unsigned> Tuple(std::uint32_t id) const {
+        return std::span<const unsigned>(indexes.data() + offsets[id], offsets[id + 1] - offsets[id]);
+    }
+
+public:
+    /// Expected bytes of one entry of reserved list including its tuple
+    static constexpr std::size_t EntryBytes(std::size_t tupleSize) {
+        return sizeof(Entry) + sizeof(std::uint32_t) + tupleSize * sizeof(unsigned);
+    }
+
+    void Clear() {
+        entries.clear();
+        indexes.clear();
+        offsets.resize(1);
+    }
+
+    /**
+     * @param numberOfEntries expected number of entries
+     * @param tupleSize expected number of indexes in one entry
+     */
+    void Reserve(std::size_t numberOfEntries, std::size_t tupleSize) {
+        entries.reserve(numberOfEntries);
+        indexes.reserve(numberOfEntries * tupleSize);
+        offsets.reserve(numberOfEntries + 1);
+    }
+
+    void Add(KeyType key, std::span<const unsigned> tuple) {
+        entries.push_back(Entry{key, static_cast<std::uint32_t>(offsets.size() - 1)});
+        indexes.insert(indexes.end(), tuple.begin(), tuple.end());
+        offsets.push_back(indexes.size());
+    }
+
+    /**
+     * Recomputes keys of all entries, list should be finalized again after it
+     * @param keyOf function which returns key of the index tuple
+     */
+    template <typename KeyFunction>
+    void Rekey(KeyFunction&& keyOf) {
+        for(auto& entry: entries) {
+            entry.key = keyOf(Tuple(entry.id));
+        }
+    }
+
+    /// Prepares list for matching, nothing to do for unordered list
+    void Finalize() {}
+
+    std::size_t size() const {
+        return entries.size();
+    }
+
+    KeyType Key(std::size_t pos) const {
+        return entries[pos].key;
+    }
+
+    std::span<const unsigned> Indexes(std::size_t pos) const {
+        return Tuple(entries[pos].id);
+    }
+};
+
+
+/**
+ * List which entries are sorted by key after finalization
+ */
+class SortedList : public UnorderedList {
+public:
+    /// Buffer of radix sort holds a copy of entries while the list is finalized
+    static constexpr std::size_t EntryBytes(std::size_t tupleSize) {
+        return UnorderedList::EntryBytes(tupleSize) + sizeof(Entry);
+    }
+
+    void Finalize() {
+        RadixsortByKey(entries.begin(), entries.end(), [](const Entry& entry) {
+            return entry.key;
+        }, entries.get_allocator());
+    }
+};
+
+
+/**
+ * List with chained hash index over keys which is built on finalization
+ */
+class HashedList : public UnorderedList {
+    static constexpr std::uint32_t emptyBucket = std::numeric_limits<std::uint32_t>::max();
+
+    AccountedVector<std::uint32_t> buckets;
+    AccountedVector<std::uint32_t> next;
+    unsigned shift = 0;
+
+    std::size_t Bucket(KeyType key) const {
+        // Fibonacci hashing, keys of random sums are close to uniform but may be narrow
+        return (key * 0x9E3779B97F4A7C15ull) >> shift;
+    }
+
+public:
+    /// Index has up to two buckets and one link for every entry
+    static constexpr std::size_t EntryBytes(std::size_t tupleSize) {
+        return UnorderedList::EntryBytes(tupleSize) + 3 * sizeof(std::uint32_t);
+    }
+
+    void Finalize() {
+        const std::size_t numberOfBuckets = std::max<std::size_t>(std::bit_ceil(entries.size()), 2);
+        shift = maxKeyLength - std::countr_zero(numberOfBuckets);
+
+        buckets.assign(numberOfBuckets, emptyBucket);
+        next.resize(entries.size());
+
+        for(std::size_t pos = 0; pos < entries.size(); ++pos) {
+            auto& head = buckets[Bucket(entries[pos].key)];
+            next[pos] = head;
+            head = pos;
+        }
+    }
+
+    /**
+     * Calls callback for every position which key is equal to the given one
+     * @param key key to be found
+     * @param callback callable with position of matched entry, iteration stops on the first truthy result
+     * @return the first truthy result of callback or default-constructed value
+     */
+    template <typename CallbackType>
+    auto ForEachMatch(KeyType key, CallbackType&& callback) const -> std::invoke_result_t<CallbackType, std::size_t> {
+        for(auto pos = buckets[Bucket(key)]; pos != emptyBucket; pos = next[pos]) {
+            if(entries[pos].key == key) {
+                if(auto result = callback(static_cast<std::size_t>(pos))) {
+                    return result;
+                }
+            }
+        }
+
+        return {};
+    }
+};
+
+
+/**
+ * Finds collisions of two sorted lists by one merge pass
+ */
+struct SortMergeMatcher {
+    /**
+     * @param left, right sorted lists
+     * @param onCollision callable with positions of entries with equal keys in left and right lists,
+     * matching stops on the first truthy result
+     * @return the first truthy result of onCollision or default-constructed value
+     */
+    template <typename LeftStoreType, typename RightStoreType, typename CallbackType>
+    auto operator()(const LeftStoreType& left, const RightStoreType& right, CallbackType&& onCollision) const
+        -> std::invoke_result_t<CallbackType, std::size_t, std::size_t>
+        requires std::is_base_of_v<SortedList, LeftStoreType> && std::is_base_of_v<SortedList, RightStoreType>
+    {
+        for(std::size_t leftPos = 0, rightPos = 0; leftPos < left.size() && rightPos < right.size();) {
+            const KeyType key = left.Key(leftPos);
+
+            if(key < right.Key(rightPos)) {
+                ++leftPos;
+            } else if(key > right.Key(rightPos)) {
+                ++rightPos;
+            } else {
+                auto leftEnd = leftPos, rightEnd = rightPos;
+                while(leftEnd < left.size() && left.Key(leftEnd) == key) {
+                    ++leftEnd;
+                }
+                while(rightEnd < right.size() && right.Key(rightEnd) == key) {
+                    ++rightEnd;
+                }
+
+                for(auto leftMatched = leftPos; leftMatched != leftEnd; ++leftMatched) {
+                    for(auto rightMatched = rightPos; rightMatched != rightEnd; ++rightMatched) {
+                        if(auto result = onCollision(leftMatched, rightMatched)) {
+                            return result;
+                        }
+                    }
+                }
+
+                leftPos = leftEnd;
+                rightPos = rightEnd;
+            }
+        }
+
+        return {};
+    }
+};
+
+
+/**
+ * Finds collisions by probing the hashed list with every entry of the other one
+ */
+struct HashJoinMatcher {
+    /**
+     * @param left, right lists, at least one of them should be HashedList
+     * @param onCollision callable with positions of entries with equal keys in left and right lists,
+     * matching stops on the first truthy result
+     * @return the first truthy result of onCollision or default-constructed value
+     */
+    template <typename LeftStoreType, typename RightStoreType, typename CallbackType>
+    auto operator()(const LeftStoreType& left, const RightStoreType& right, CallbackType&& onCollision) const
+        -> std::invoke_result_t<CallbackType, std::size_t, std::size_t>
+        requires std::is_base_of_v<HashedList, LeftStoreType> || std::is_base_of_v<HashedList, RightStoreType>
+    {
+        if constexpr (std::is_base_of_v<HashedList, RightStoreType>) {
+            for(std::size_t leftPos = 0; leftPos < left.size(); ++leftPos) {
+                if(auto result = right.ForEachMatch(left.Key(leftPos), [&](std::size_t rightPos) { return onCollision(leftPos, rightPos); })) {
+                    return result;
+                }
+            }
+        } else {
+            for(std::size_t rightPos = 0; rightPos < right.size(); ++rightPos) {
+                if(auto result = left.ForEachMatch(right.Key(rightPos), [&](std::size_t leftPos) { return onCollision(leftPos, rightPos); })) {
+                    return result;
+                }
+            }
+        }
+
+        return {};
+    }
+};
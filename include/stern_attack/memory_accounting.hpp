@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+/**
+ * Current and peak number of bytes
+ */
+struct MemoryUsage {
+    std::size_t currentBytes = 0;
+    std::size_t peakBytes = 0;
+};
+
+
+/**
+ * Counter of bytes which is shared by threads, e.g. of the whole process or of one algorithm
+ */
+class MemoryCounter {
+    std::atomic<std::size_t> current = 0;
+    std::atomic<std::size_t> peak = 0;
+
+public:
+    void Add(std::size_t bytes) {
+        const std::size_t now = current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+        std::size_t oldPeak = peak.load(std::memory_order_relaxed);
+        while(now > oldPeak && !peak.compare_exchange_weak(oldPeak, now, std::memory_order_relaxed)) {}
+    }
+
+    void Subtract(std::size_t bytes) {
+        current.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    std::size_t CurrentBytes() const {
+        return current.load(std::memory_order_relaxed);
+    }
+
+    MemoryUsage Usage() const {
+        return MemoryUsage{current.load(std::memory_order_relaxed), peak.load(std::memory_order_relaxed)};
+    }
+
+    /// Peak is restarted from the current value
+    void ResetPeak() {
+        peak.store(current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+};
+
+
+/**
+ * Accounting of memory of lists of decoding algorithms which are allocated by AccountedAllocator:
+ * bytes of the whole process, of the calling thread and of the algorithm which step runs on the thread
+ * (see Scope). Counters are updated only when lists grow, i.e. a few times per list, so accounting is always on.
+ * Budget limits bytes of lists of the whole process: parallel decoding runs fewer threads
+ * and ParameterOptimizer rejects parameters which do not fit into it, growing lists of MMT stop on it
+ */
+class MemoryAccounting {
+    struct ThreadRecord {
+        /// Signed, memory may be released by another thread than allocated it
+        std::int64_t current = 0;
+        std::int64_t peak = 0;
+        MemoryCounter* activeCounter = nullptr;
+    };
+
+    static ThreadRecord& Record() {
+        thread_local ThreadRecord record;
+        return record;
+    }
+
+    static MemoryCounter& Global() {
+        static MemoryCounter counter;
+        return counter;
+    }
+
+    static std::atomic<std::size_t>& BudgetBytes() {
+        static std::atomic<std::size_t> budget = 0;
+        return budget;
+    }
+
+public:
+    /**
+     * Counts allocation of lists on the calling thread until destruction, e.g. one step of an algorithm,
+     * and reports bytes to the counter of that algorithm. Scopes may be nested
+     */
+    class Scope {
+        ThreadRecord& record;
+        MemoryCounter* outerCounter;
+        std::int64_t startBytes;
+        std::int64_t outerPeak;
+
+    public:
+        explicit Scope(MemoryCounter* counter = nullptr) : record(Record()), outerCounter(record.activeCounter),
+                                                           startBytes(record.current), outerPeak(record.peak) {
+            record.activeCounter = counter != nullptr ? counter : outerCounter;
+            record.peak = record.current;
+        }
+
+        ~Scope() {
+            record.activeCounter = outerCounter;
+            record.peak = std::max(record.peak, outerPeak);
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        /// Peak bytes of the thread since the scope began
+        std::size_t PeakBytes() const {
+            return std::max<std::int64_t>(record.peak - startBytes, 0);
+        }
+    };
+
+    static void Allocate(std::size_t bytes) {
+        auto& record = Record();
+        record.current += bytes;
+        record.peak = std::max(record.peak, record.current);
+
+        Global().Add(bytes);
+        if(record.activeCounter != nullptr) {
+            record.activeCounter->Add(bytes);
+        }
+    }
+
+    static void Deallocate(std::size_t bytes) {
+        auto& record = Record();
+        record.current -= bytes;
+
+        Global().Subtract(bytes);
+        if(record.activeCounter != nullptr) {
+            record.activeCounter->Subtract(bytes);
+        }
+    }
+
+    /// Bytes of lists of all threads
+    static MemoryUsage GlobalUsage() {
+        return Global().Usage();
+    }
+
+    /// Bytes of lists of the calling thread
+    static MemoryUsage ThreadUsage() {
+        const auto& record = Record();
+        return MemoryUsage{static_cast<std::size_t>(std::max<std::int64_t>(record.current, 0)),
+                           static_cast<std::size_t>(std::max<std::int64_t>(record.peak, 0))};
+    }
+
+    static void ResetPeaks() {
+        Global().ResetPeak();
+        Record().peak = Record().current;
+    }
+
+    /**
+     * @param bytes limit of bytes of lists of all threads, 0 means no limit
+     */
+    static void SetBudget(std::size_t bytes) {
+        BudgetBytes().store(bytes, std::memory_order_relaxed);
+    }
+
+    /// Limit of bytes of lists of all threads, 0 if there is no limit
+    static std::size_t Budget() {
+        return BudgetBytes().load(std::memory_order_relaxed);
+    }
+
+    /// Cheap enough to be checked for every added entry, lists which may be truncated stop growing
+    static bool IsOverBudget() {
+        const std::size_t budget = Budget();
+        return budget != 0 && Global().CurrentBytes() > budget;
+    }
+};
+
+
+/**
+ * Allocator which takes memory from std::allocator and reports it to MemoryAccounting
+ */
+template <typename T>
+struct AccountedAllocator {
+    using value_type = T;
+
+    AccountedAllocator() = default;
+
+    template <typename U>
+    AccountedAllocator(const AccountedAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        T* pointer = std::allocator<T>().allocate(n);
+        MemoryAccounting::Allocate(n * sizeof(T));
+        return pointer;
+    }
+
+    void deallocate(T* pointer, std::size_t n) noexcept {
+        MemoryAccounting::Deallocate(n * sizeof(T));
+        std::allocator<T>().deallocate(pointer, n);
+    }
+
+    template <typename U>
+    bool operator==(const AccountedAllocator<U>&) const noexcept {
+        return true;
+    }
+};
+
+template <typename T>
+using AccountedVector = std::vector<T, AccountedAllocator<T>>;
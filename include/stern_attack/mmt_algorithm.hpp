@@ -1,24 +1,47 @@
 #pragma once
 
 #include <boost/dynamic_bitset.hpp>
-#include <boost/sort/sort.hpp>
 
 #include <iostream>
 #include <algorithm>
 #include <cassert>
-#include <execution>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
 #include <numeric>
 #include <tuple>
+#include <vector>
 
 
 #include <algebra/binary_matrix.hpp>
 #include <permutations/combination_iterator.hpp>
-#include <permutations/primitive_permutation_iterator.hpp>
-#include <permutations/random_permutation_iterator.hpp>
 #include "base_decoding.hpp"
+#include "instrumentation.hpp"
+#include "isd_engine.hpp"
+#include "list_matching.hpp"
+#include "memory_accounting.hpp"
 
 
-class MMTAlgorithm : public BaseAlgorithm {
+/**
+ * Parameters of MMT algorithm
+ */
+struct MMTParameters {
+    /// Weight of combinations of every half of extended information set
+    unsigned p;
+    /// Width of the window of the final matching
+    unsigned l1;
+    /// Width of the window of merging of level-1 lists
+    unsigned l2;
+};
+
+
+/**
+ * Enumerator of MMT algorithm: p-combinations of both halves of information set extended
+ * by l = l1 + l2 columns are merged on rows [l1, l) into two level-2 lists,
+ * keys of level-2 lists are sums projected onto rows [0, l1)
+ */
+template <ListStore LeftStore, ListStore RightStore>
+class MMTEnumerator {
 protected:
     static constexpr std::size_t maxSizeOfProjSumOnLevel2 = 10000000;
     unsigned p;
@@ -27,16 +50,32 @@ protected:
     unsigned l;
     std::size_t expectedLengthLevel1;
     std::size_t expectedLengthLevel2;
-    using IndexType = std::vector<unsigned>;
-    using CollisionType = std::pair<BinaryMatrix::BitContainerType, IndexType>;
-        
+
+    /**
+     * Adds symmetric difference of two sorted tuples to the level-2 list
+     */
+    template <typename StoreType>
+    void AddMerged(StoreType& store, std::span<const unsigned> tuple1, std::span<const unsigned> tuple2,
+                   const std::vector<KeyType>& columnKeys, KeyType syndromeKey, std::vector<unsigned>& buffer) const {
+        buffer.clear();
+        std::set_symmetric_difference(tuple1.begin(), tuple1.end(), tuple2.begin(), tuple2.end(), std::back_inserter(buffer));
+
+        KeyType key = syndromeKey;
+        for(const auto idx: buffer) {
+            key ^= columnKeys[idx];
+        }
+
+        store.Add(key, buffer);
+    }
+
 public:
-    constexpr static const char* algorithmName = "MMT";
-    mutable std::vector<std::size_t> lengthsL2;
+    using LeftStoreType = LeftStore;
+    using RightStoreType = RightStore;
+    using ParametersType = MMTParameters;
 
-    void sizes(){
-        std::cout << "Expected length: " << expectedLengthLevel2 << '\n';
-        std::cout << "Length: " << (std::reduce(lengthsL2.begin(), lengthsL2.end()) / static_cast<float>(lengthsL2.size())) << '\n';
+    /// Expected length of level-2 list, actual one is reported by instrumentation (DecodingCounter::ListEntries)
+    std::size_t ExpectedLengthOfList() const {
+        return expectedLengthLevel2;
     }
 
     auto getParams() const {
@@ -45,216 +84,163 @@ public:
 
     /**
      * Creates an options object for MMT algorithm
-     * @param cols number of columns in matrix, p initializes as 0.006 * cols (it's optimal parameter)
-     * l1 as 0.028 * cols, l2 as 0.006 * cols
+     * @param cols number of columns in matrix, p initializes as 0.002 * cols (rough default, see ParameterOptimizer)
+     * l1 as 0.028 * cols, l2 as 0.006 * cols, both can not exceed width of key
     */
-    MMTAlgorithm(unsigned cols, unsigned rows) : p(static_cast<unsigned>(0.002 * cols) > 0 ? 0.002 * cols : 1),
-                                                 l1(static_cast<unsigned>(0.028 * cols) > 0 ? 0.028 * cols : 1),
-                                                 l2(static_cast<unsigned>(0.006 * cols) > 0 ? 0.006 * cols : 1),
-                                                 l(l1 + l2), expectedLengthLevel1(NumberOfCombinations((cols - rows + l) / 2, p)),
-                                                 expectedLengthLevel2(std::min((expectedLengthLevel1 * expectedLengthLevel1) >> l2, maxSizeOfProjSumOnLevel2) * 1.1)
+    MMTEnumerator(unsigned cols, unsigned rows) : p(static_cast<unsigned>(0.002 * cols) > 0 ? 0.002 * cols : 1),
+                                                  l1(std::min(static_cast<unsigned>(0.028 * cols) > 0 ? static_cast<unsigned>(0.028 * cols) : 1, maxKeyLength)),
+                                                  l2(std::min(static_cast<unsigned>(0.006 * cols) > 0 ? static_cast<unsigned>(0.006 * cols) : 1, maxKeyLength)),
+                                                  l(l1 + l2), expectedLengthLevel1(NumberOfCombinations((cols - rows + l) / 2, p)),
+                                                  expectedLengthLevel2(std::min((expectedLengthLevel1 * expectedLengthLevel1) >> l2, maxSizeOfProjSumOnLevel2) * 1.1)
     {}
 
+    /**
+     * Creates an options object for MMT algorithm with the given parameters (e.g. chosen by ParameterOptimizer)
+     */
+    MMTEnumerator(MMTParameters parameters, unsigned cols, unsigned rows) : p(std::max(parameters.p, 1u)),
+                                                  l1(std::clamp(parameters.l1, 1u, maxKeyLength)),
+                                                  l2(std::clamp(parameters.l2, 1u, maxKeyLength)),
+                                                  l(l1 + l2), expectedLengthLevel1(NumberOfCombinations((cols - rows + l) / 2, p)),
+                                                  expectedLengthLevel2(std::min((expectedLengthLevel1 * expectedLengthLevel1) >> l2, maxSizeOfProjSumOnLevel2) * 1.1)
+    {}
 
     /**
-     * Makes one step of information-set decoding to already permuted check matrix
-     * @param checkMatrix binary permuted check matrix for which gauss elimination should be applied
-     * @param syndrome syndrome vector 
-     * @param omega number of errors in codeword (i.e. number of ones in error vector)
-     * @return filled std::optional<boost::dynamic_bitset<>> if success, else empty optional
+     * Parameters which ParameterOptimizer compares: p up to 3 and every pair of widths
+     * which leaves enough rows for the rest of errors. 2^l2 does not exceed the number C(2p, p)
+     * of representations of 2p errors of a half, otherwise the error vector is lost by merging
+     * more often than ExpectedIterations assumes
      */
-    std::optional<boost::dynamic_bitset<>> operator()(BinaryMatrix& checkMatrix, boost::dynamic_bitset<> syndrome, const unsigned omega) const {
-        if(!GaussElimination(checkMatrix, syndrome)) {
-            return std::optional<boost::dynamic_bitset<>>();
+    static std::vector<MMTParameters> ParameterCandidates(unsigned rows, unsigned cols, unsigned omega) {
+        std::vector<MMTParameters> candidates;
+        for(unsigned p = 1; p <= 3 && 4 * p <= omega; ++p) {
+            const unsigned maxL2 = std::max(static_cast<unsigned>(LogNumberOfCombinations(2 * p, p) / std::log(2.0)), 1u);
+            for(unsigned l1 = 1; l1 <= maxKeyLength; ++l1) {
+                for(unsigned l2 = 1; l2 <= maxL2 && l1 + l2 + (omega - 4 * p) <= rows; ++l2) {
+                    candidates.push_back(MMTParameters{p, l1, l2});
+                }
+            }
         }
 
-        unsigned rows = checkMatrix.RowsSize();
-        unsigned cols = checkMatrix.ColumnsSize();
-        unsigned colsSizeOfQ = cols - rows + l;
-
-        unsigned halfColsSizeOfQ = colsSizeOfQ / 2;
-
-        auto combination = Combination(p, halfColsSizeOfQ);
-        auto numberOfCombs = combination.GetNumberOfCombinations();
+        return candidates;
+    }
 
-        std::vector<CollisionType> projectedSum1, projectedSum2;
-        std::vector<CollisionType> /*projectedSum11,*/ projectedSum12;
-        std::vector<CollisionType> projectedSum21, projectedSum22;
+    /**
+     * Three level-1 lists, two level-2 lists which entries collide on l2 bits and
+     * collisions of level-2 lists on l1 bits. Lists of both levels exist at once,
+     * level-2 lists are truncated by the memory budget
+     */
+    IterationWork ExpectedWork(unsigned rows, unsigned cols) const {
+        const double lengthLevel1 = std::exp(LogNumberOfCombinations((cols - rows + l) / 2, p));
+        const double lengthLevel2 = std::min(std::ldexp(lengthLevel1 * lengthLevel1, -static_cast<int>(l2)), static_cast<double>(maxSizeOfProjSumOnLevel2));
+        const double level2Bytes = lengthLevel2 * (LeftStore::EntryBytes(2 * p) + RightStore::EntryBytes(2 * p));
 
-        projectedSum12.reserve(expectedLengthLevel1);
-        projectedSum21.reserve(expectedLengthLevel1);
-        projectedSum22.reserve(expectedLengthLevel1);
+        return IterationWork{3 * lengthLevel1 + 2 * lengthLevel2, std::ldexp(lengthLevel2 * lengthLevel2, -static_cast<int>(l1)),
+                             3 * lengthLevel1 * SortedList::EntryBytes(p) + level2Bytes, level2Bytes};
+    }
 
-        projectedSum1.reserve(expectedLengthLevel2);
-        projectedSum2.reserve(expectedLengthLevel2);
+    /**
+     * Fraction of merged tuples which are kept in every level-2 list. Lists stop growing at 1.1 times
+     * maxSizeOfProjSumOnLevel2 and when bytes of lists exceed the memory budget of one thread
+     */
+    double KeptFractionOfLevel2(unsigned rows, unsigned cols) const {
+        const double lengthLevel1 = std::exp(LogNumberOfCombinations((cols - rows + l) / 2, p));
+        const double lengthLevel2 = std::ldexp(lengthLevel1 * lengthLevel1, -static_cast<int>(l2));
+        double keptLength = std::min(lengthLevel2, 1.1 * maxSizeOfProjSumOnLevel2);
+
+        if(const std::size_t budget = MemoryAccounting::Budget(); budget != 0) {
+            const double level1Bytes = 3 * lengthLevel1 * SortedList::EntryBytes(p) + 2.0 * rows * cols / 8;
+            const double fittingLength = std::max(budget - level1Bytes, 0.0) / (LeftStore::EntryBytes(2 * p) + RightStore::EntryBytes(2 * p));
+            keptLength = std::min(keptLength, fittingLength);
+        }
 
-        boost::dynamic_bitset<> projectedSyndrome1 = Projection(syndrome, l1);
-        boost::dynamic_bitset<> projectedSyndrome2 = Projection(syndrome, l, l1);
+        return lengthLevel2 > 0 ? std::min(keptLength / lengthLevel2, 1.0) : 1;
+    }
 
-        BinaryMatrix checkMatrixTr = checkMatrix.TransposeMatrix(0, checkMatrix.RowsSize());
-        BinaryMatrix checkMatrixOnL1 = checkMatrix.TransposeMatrix(0, l1);
-        BinaryMatrix checkMatrixOnL2 = checkMatrix.TransposeMatrix(l1, l);
+    /**
+     * Expected number of iterations to the error vector: 2p errors in each half of extended
+     * information set and no errors on the rest rows (as in benchmark/graph.py). Both level-2 tuples
+     * of the error vector have to be kept in truncated lists
+     */
+    double ExpectedIterations(unsigned rows, unsigned cols, unsigned omega) const {
+        const int halfColsSizeOfQ = (cols - rows + l) / 2;
+        const int weight = 2 * p;
+
+        const double logSuccesses = 2 * LogNumberOfCombinations(halfColsSizeOfQ, weight)
+                                    + LogNumberOfCombinations(static_cast<int>(rows) - static_cast<int>(l), static_cast<int>(omega) - 2 * weight)
+                                    + 2 * std::log(KeptFractionOfLevel2(rows, cols));
+        return ::ExpectedIterations(LogNumberOfCombinations(cols, omega), logSuccesses);
+    }
 
-        for(auto combinationIter = combination.begin(); combinationIter.CombinationsStillExist(); ++combinationIter) {
-            /// TODO: projectedSum11 == projectedSum21 ???
-            // projectedSum11.emplace_back(checkMatrix.sumOfColumns(*combinationIter, l1, l), *combinationIter);
-            projectedSum21.emplace_back(checkMatrix.sumOfColumns(*combinationIter, l1, l), *combinationIter);
+    void Enumerate(const ISDContext& context, LeftStoreType& left, RightStoreType& right) const {
+        const unsigned colsSizeOfQ = context.InformationSetSize() + l;
+        const unsigned halfColsSizeOfQ = colsSizeOfQ / 2;
 
-            std::vector<unsigned> shiftedCombination = *combinationIter;
-            std::for_each(shiftedCombination.begin(), shiftedCombination.end(), [&halfColsSizeOfQ](auto& element){
-                element += halfColsSizeOfQ;
-            });
+        const auto columnKeysOnL1 = context.ColumnKeys(2 * halfColsSizeOfQ, 0, l1);
+        const auto columnKeysOnL2 = context.ColumnKeys(2 * halfColsSizeOfQ, l1, l2);
+        const KeyType syndromeKeyOnL1 = context.SyndromeKey(0, l1);
+        const KeyType syndromeKeyOnL2 = context.SyndromeKey(l1, l2);
 
-            projectedSum12.emplace_back(checkMatrixOnL2.sumOfRows(shiftedCombination), shiftedCombination);
-            projectedSum22.emplace_back(checkMatrixOnL2.sumOfRows(shiftedCombination) ^ projectedSyndrome2, shiftedCombination);
-        }
+        auto combination = Combination(p, halfColsSizeOfQ);
 
-        auto compare = [](auto &a, auto& b) {
-            return a.first.to_ulong() < b.first.to_ulong();
-        };
-
-        boost::sort::pdqsort_branchless(projectedSum12.begin(), projectedSum12.end(), compare);
-        boost::sort::pdqsort_branchless(projectedSum21.begin(), projectedSum21.end(), compare);
-        boost::sort::pdqsort_branchless(projectedSum22.begin(), projectedSum22.end(), compare);
-
-        for(auto iter1 = projectedSum12.begin(), iter2 = projectedSum12.begin(); iter1 != projectedSum12.end() && iter2 != projectedSum12.end();) {
-            if(iter1->first < iter2->first){
-                ++iter1;
-            } else if(iter1->first > iter2->first) {
-                ++iter2;
-            } else {
-                auto iterEnd1 = std::find_if(iter1, projectedSum12.end(), [&iter1] (auto &iter) {
-                    return iter.first != iter1->first;
-                });
-
-                auto iterEnd2 = std::find_if(iter2, projectedSum12.end(), [&iter2] (auto &iter) {
-                    return iter.first != iter2->first;
-                });
-
-                for(auto iterBegin1 = iter1; iterBegin1 != iterEnd1; ++iterBegin1){
-                    for(auto iterBegin2 = iter2; iterBegin2 != iterEnd2; ++iterBegin2){
-                        if(iterBegin1->first == iterBegin2->first) {
-                            std::vector<unsigned> indexUnion;
-                            indexUnion.reserve(iterBegin1->second.size() + iterBegin2->second.size());
-                            indexUnion.insert(indexUnion.end(), iterBegin1->second.begin(), iterBegin1->second.end());
-                            indexUnion.insert(indexUnion.end(), iterBegin2->second.begin(), iterBegin2->second.end());
-
-                            /// TODO: is it a need in recomputation of sum of columns???
-                            projectedSum1.emplace_back(checkMatrixOnL1.sumOfRows(indexUnion), indexUnion);
-                        }
-                    }
-                }
+        // level 1: sums of the first half, sums of the second half and the same sums with syndrome on rows [l1, l)
+        SortedList projectedSum21, projectedSum12, projectedSum22;
+        projectedSum21.Reserve(expectedLengthLevel1, p);
+        projectedSum12.Reserve(expectedLengthLevel1, p);
+        projectedSum22.Reserve(expectedLengthLevel1, p);
 
-                if(projectedSum1.size() > expectedLengthLevel2) {
-                    break;
-                }
+        std::vector<unsigned> shiftedCombination(p);
+        for(auto combinationIter = combination.begin(); combinationIter.CombinationsStillExist() && !context.StopRequested(); ++combinationIter) {
+            KeyType key21 = 0, key12 = 0;
 
-                iter1 = iterEnd1;
-                iter2 = iterEnd2;
+            for(unsigned idx = 0; idx < p; ++idx) {
+                shiftedCombination[idx] = (*combinationIter)[idx] + halfColsSizeOfQ;
+                key21 ^= columnKeysOnL2[(*combinationIter)[idx]];
+                key12 ^= columnKeysOnL2[shiftedCombination[idx]];
             }
-        }
 
-        for(auto iter1 = projectedSum21.begin(), iter2 = projectedSum22.begin(); iter1 != projectedSum21.end() && iter2 != projectedSum22.end();) {
-            if(iter1->first < iter2->first){
-                ++iter1;
-            } else if(iter1->first > iter2->first) {
-                ++iter2;
-            } else {
-                auto iterEnd1 = std::find_if(iter1, projectedSum21.end(), [&iter1] (auto &iter) {
-                    return iter.first != iter1->first;
-                });
-
-                auto iterEnd2 = std::find_if(iter2, projectedSum22.end(), [&iter2] (auto &iter) {
-                    return iter.first != iter2->first;
-                });
-
-                for(auto iterBegin1 = iter1; iterBegin1 != iterEnd1; ++iterBegin1){
-                    for(auto iterBegin2 = iter2; iterBegin2 != iterEnd2; ++iterBegin2){
-                        if(iterBegin1->first == iterBegin2->first) {
-                            std::vector<unsigned> indexUnion;
-                            indexUnion.reserve(iterBegin1->second.size() + iterBegin2->second.size());
-                            indexUnion.insert(indexUnion.end(), iterBegin1->second.begin(), iterBegin1->second.end());
-                            indexUnion.insert(indexUnion.end(), iterBegin2->second.begin(), iterBegin2->second.end());
-
-                            /// TODO: is it a need in recomputation of sum of columns???
-                            projectedSum2.emplace_back(checkMatrixOnL1.sumOfRows(indexUnion) ^ projectedSyndrome1, indexUnion);
-                        }
-                    }
-                }
+            projectedSum21.Add(key21, *combinationIter);
+            projectedSum12.Add(key12, shiftedCombination);
+            projectedSum22.Add(key12 ^ syndromeKeyOnL2, shiftedCombination);
+        }
 
-                if(projectedSum2.size() > expectedLengthLevel2) {
-                    break;
-                }
-                
-                iter1 = iterEnd1;
-                iter2 = iterEnd2;
-            }
+        {
+            const Instrumentation::PhaseTimer timer(DecodingPhase::SortHash);
+            projectedSum12.Finalize();
+            projectedSum21.Finalize();
+            projectedSum22.Finalize();
         }
 
-        boost::sort::pdqsort_branchless(projectedSum1.begin(), projectedSum1.end(), compare);
-        boost::sort::pdqsort_branchless(projectedSum2.begin(), projectedSum2.end(), compare);
+        // level 2: merged tuples which sums vanish (left) or are equal to syndrome (right) on rows [l1, l),
+        // lists are truncated instead of exceeding the memory budget
+        left.Reserve(expectedLengthLevel2, 2 * p);
+        right.Reserve(expectedLengthLevel2, 2 * p);
+
+        std::vector<unsigned> buffer;
+        buffer.reserve(2 * p);
 
-        lengthsL2.push_back(projectedSum1.size());
-        lengthsL2.push_back(projectedSum2.size());
-        // indexes of columns should guarantee to be sorted for finding symmetric difference
-        std::for_each(projectedSum1.begin(), projectedSum1.end(), [](CollisionType& element) {
-            std::sort(element.second.begin(), element.second.end());
+        const SortMergeMatcher matcher;
+        matcher(projectedSum12, projectedSum12, [&](std::size_t pos1, std::size_t pos2) {
+            // list is matched with itself, so every unordered pair is taken once
+            if(pos1 < pos2) {
+                AddMerged(left, projectedSum12.Indexes(pos1), projectedSum12.Indexes(pos2), columnKeysOnL1, 0, buffer);
+            }
+            return left.size() > expectedLengthLevel2 || context.StopRequested() || MemoryAccounting::IsOverBudget();
         });
 
-        std::for_each(projectedSum2.begin(), projectedSum2.end(), [](CollisionType& element) {
-            std::sort(element.second.begin(), element.second.end());
+        matcher(projectedSum21, projectedSum22, [&](std::size_t pos1, std::size_t pos2) {
+            AddMerged(right, projectedSum21.Indexes(pos1), projectedSum22.Indexes(pos2), columnKeysOnL1, syndromeKeyOnL1, buffer);
+            return right.size() > expectedLengthLevel2 || context.StopRequested() || MemoryAccounting::IsOverBudget();
         });
+    }
+};
 
-        for(auto iter1 = projectedSum1.begin(), iter2 = projectedSum2.begin(); iter1 != projectedSum1.end() && iter2 != projectedSum2.end();) {
-            if(iter1->first < iter2->first) {
-                ++iter1;
-            } else if(iter1->first > iter2->first) {
-                ++iter2;
-            } else {
-                auto iterEnd1 = std::find_if(iter1, projectedSum1.end(), [&iter1] (auto &iter) {
-                    return iter.first != iter1->first;
-                });
-
-                auto iterEnd2 = std::find_if(iter2, projectedSum2.end(), [&iter2] (auto &iter) {
-                    return iter.first != iter2->first;
-                });
-
-                for(auto iterMatched1 = iter1; iterMatched1 != iterEnd1; ++iterMatched1){
-                    for(auto iterMatched2 = iter2; iterMatched2 != iterEnd2; ++iterMatched2){
-                        std::vector<unsigned> indexColumns;
-                        indexColumns.reserve(iterMatched1->second.size() + iterMatched2->second.size());
-
-                        std::set_symmetric_difference(iterMatched1->second.begin(), iterMatched1->second.end(),
-                                                    iterMatched2->second.begin(), iterMatched2->second.end(),
-                                                    std::back_inserter(indexColumns));
-
-                        if((checkMatrixTr.sumOfRows(indexColumns) ^ syndrome).count() == omega - indexColumns.size()) {
-                            boost::dynamic_bitset<> errorVector(cols);
-
-                            for(const auto& idx : indexColumns) {
-                                errorVector.set(idx);
-                            }
-
-                            const auto matchedSupp = checkMatrix.sumOfColumns(indexColumns) ^ syndrome;
-                            for(boost::dynamic_bitset<>::size_type setBitIdx = 0; setBitIdx < matchedSupp.size(); ++setBitIdx) {
-                                if(matchedSupp[setBitIdx]){
-                                    errorVector.set(setBitIdx + checkMatrix.ColumnsSize() - checkMatrix.RowsSize());
-                                }
-                            }
-                            // std::cout << checkMatrix.matVecMul(errorVector) << '\n';
-                            // std::cout << syndrome << "\n\n";
-                            // assert(checkMatrix.matVecMul(errorVector) == syndrome);
-
-                            return std::optional<boost::dynamic_bitset<>>(errorVector);
-                        }
-                    }
-                }
 
-                iter1 = iterEnd1;
-                iter2 = iterEnd2;
-            }
-        }
+struct MMTPolicy {
+    constexpr static const char* algorithmName = "MMT";
 
-        return std::optional<boost::dynamic_bitset<>>();
-    }
+    using EnumeratorType = MMTEnumerator<SortedList, SortedList>;
+    using MatcherType = SortMergeMatcher;
+    using VerifierType = SymmetricDifferenceVerifier;
 };
+
+using MMTAlgorithm = ISDEngine<MMTPolicy>;
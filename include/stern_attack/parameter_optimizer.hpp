@@ -0,0 +1,392 @@
+#pragma once
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <algebra/binary_matrix.hpp>
+#include <permutations/random_permutation_iterator.hpp>
+#include "base_decoding.hpp"
+#include "memory_accounting.hpp"
+
+
+/**
+ * Algorithm which parameters can be chosen by ParameterOptimizer: it lists candidates of parameters,
+ * can be created from any of them and predicts the number of iterations and work of one iteration
+ */
+template <typename AlgorithmType>
+concept OptimizableAlgorithm = requires(const AlgorithmType algorithm, unsigned rows, unsigned cols, unsigned omega) {
+    typename AlgorithmType::ParametersType;
+    { AlgorithmType::ParameterCandidates(rows, cols, omega) } -> std::same_as<std::vector<typename AlgorithmType::ParametersType>>;
+    { algorithm.ExpectedIterations(rows, cols, omega) } -> std::convertible_to<double>;
+    { algorithm.ExpectedWork(rows, cols) } -> std::same_as<IterationWork>;
+};
+
+
+/**
+ * Creates algorithm from parameters, algorithms which lists depend on the size of check matrix (MMT) take it too
+ */
+template <OptimizableAlgorithm AlgorithmType>
+AlgorithmType MakeAlgorithm(const typename AlgorithmType::ParametersType& parameters, unsigned rows, unsigned cols) {
+    if constexpr (std::is_constructible_v<AlgorithmType, const typename AlgorithmType::ParametersType&>) {
+        return AlgorithmType(parameters);
+    } else {
+        return AlgorithmType(parameters, cols, rows);
+    }
+}
+
+
+/**
+ * Time of one iteration (per information set) as a linear function of its work:
+ * elimination and other fixed costs, cost of an entry of lists and cost of a verified collision
+ */
+struct IterationCostModel {
+    double secondsPerIteration = 0;
+    double secondsPerEntry = 0;
+    double secondsPerCollision = 0;
+
+    double Seconds(const IterationWork& work) const {
+        return secondsPerIteration + secondsPerEntry * work.listEntries + secondsPerCollision * work.collisions;
+    }
+};
+
+
+/**
+ * Measured time of one iteration with parameters of the given work
+ */
+struct CalibrationPoint {
+    IterationWork work;
+    double seconds;
+};
+
+
+/**
+ * Fits cost model to calibration points by least squares of relative errors (times of points
+ * differ by orders of magnitude), all coefficients are non-negative: every subset of coefficients
+ * is fitted and the best one without negative coefficients is taken
+ * @return model, zero if there are no points
+ */
+IterationCostModel FitCostModel(const std::vector<CalibrationPoint>& points) {
+    constexpr unsigned numberOfCoefficients = 3;
+    const auto feature = [](const CalibrationPoint& point, unsigned idx) {
+        return std::array<double, numberOfCoefficients>{1, point.work.listEntries, point.work.collisions}[idx];
+    };
+
+    // features are normalized for conditioning of normal equations
+    std::array<double, numberOfCoefficients> scale{};
+    for(const auto& point: points) {
+        for(unsigned idx = 0; idx < numberOfCoefficients; ++idx) {
+            scale[idx] = std::max(scale[idx], feature(point, idx));
+        }
+    }
+
+    std::optional<std::array<double, numberOfCoefficients>> best;
+    double bestResidual = std::numeric_limits<double>::infinity();
+
+    for(unsigned mask = 1; mask < (1u << numberOfCoefficients); ++mask) {
+        // features which are zero in all points can not be fitted
+        std::array<unsigned, numberOfCoefficients> used{};
+        std::size_t size = 0;
+        bool isFittable = true;
+        for(unsigned idx = 0; idx < numberOfCoefficients; ++idx) {
+            if(mask >> idx & 1) {
+                used[size++] = idx;
+                isFittable &= scale[idx] > 0;
+            }
+        }
+
+        if(!isFittable || size > points.size()) {
+            continue;
+        }
+
+        // normal equations of weighted least squares, augmented by the right side,
+        // the first size rows and size + 1 columns are used
+        std::array<std::array<double, numberOfCoefficients + 1>, numberOfCoefficients> system{};
+        for(const auto& point: points) {
+            const double weight = 1 / (point.seconds * point.seconds);
+            for(std::size_t row = 0; row < size; ++row) {
+                const double x = feature(point, used[row]) / scale[used[row]];
+                for(std::size_t col = 0; col < size; ++col) {
+                    system[row][col] += weight * x * feature(point, used[col]) / scale[used[col]];
+                }
+                system[row][size] += weight * x * point.seconds;
+            }
+        }
+
+        bool isSingular = false;
+        for(std::size_t col = 0; col < size && !isSingular; ++col) {
+            std::size_t pivot = col;
+            for(std::size_t row = col + 1; row < size; ++row) {
+                if(std::abs(system[row][col]) > std::abs(system[pivot][col])) {
+                    pivot = row;
+                }
+            }
+
+            std::swap(system[col], system[pivot]);
+            if(std::abs(system[col][col]) < 1e-12) {
+                isSingular = true;
+                break;
+            }
+
+            for(std::size_t row = 0; row < size; ++row) {
+                if(row != col) {
+                    const double factor = system[row][col] / system[col][col];
+                    for(std::size_t idx = col; idx <= size; ++idx) {
+                        system[row][idx] -= factor * system[col][idx];
+                    }
+                }
+            }
+        }
+
+        if(isSingular) {
+            continue;
+        }
+
+        std::array<double, numberOfCoefficients> coefficients{};
+        bool isNegative = false;
+        for(std::size_t row = 0; row < size; ++row) {
+            coefficients[used[row]] = system[row][size] / system[row][row] / scale[used[row]];
+            isNegative |= coefficients[used[row]] < 0;
+        }
+
+        if(isNegative) {
+            continue;
+        }
+
+        double residual = 0;
+        for(const auto& point: points) {
+            double predicted = 0;
+            for(unsigned idx = 0; idx < numberOfCoefficients; ++idx) {
+                predicted += coefficients[idx] * feature(point, idx);
+            }
+            residual += std::pow((predicted - point.seconds) / point.seconds, 2);
+        }
+
+        if(residual < bestResidual) {
+            bestResidual = residual;
+            best = coefficients;
+        }
+    }
+
+    if(!best) {
+        return IterationCostModel{};
+    }
+
+    return IterationCostModel{(*best)[0], (*best)[1], (*best)[2]};
+}
+
+
+struct OptimizerOptions {
+    /// Number of parameter candidates which are run on the instance to calibrate the cost model
+    unsigned calibrationPoints = 6;
+    /// Number of information sets (successful eliminations) measured for every calibration point
+    unsigned calibrationIterations = 4;
+    /// Only candidates with at most so much work per iteration are calibrated, so calibration is short
+    double maxCalibrationWork = 1 << 18;
+    /// Candidates which lists are longer are rejected, it bounds memory of one thread
+    double maxListEntries = 1 << 26;
+    /// Candidates which lists take more bytes are rejected, 0 means the share of one thread in the budget of MemoryAccounting
+    double maxListBytes = 0;
+    /// Number of threads which share the budget of MemoryAccounting
+    unsigned numberOfThreads = 1;
+    /// Seed of permutations of calibration, the same seed gives the same points
+    std::uint64_t seed = 1;
+};
+
+
+/**
+ * Parameters with their projected cost
+ */
+template <typename ParametersType>
+struct OptimizedParameters {
+    ParametersType parameters;
+    double expectedIterations;
+    double secondsPerIteration;
+    /// Expected time to solution of one thread
+    double expectedSeconds;
+};
+
+
+/**
+ * Chooses parameters of algorithm for the instance: expected number of iterations of every candidate
+ * is multiplied by the time of one iteration predicted by the cost model, and the least product wins.
+ * The cost model is calibrated on the instance itself, i.e. on the machine, by several cheap candidates
+ * @tparam MatrixType BinaryMatrix or SystematicMatrix, i.e. any check matrix which permuted matrices are built from
+ */
+template <OptimizableAlgorithm AlgorithmType, typename MatrixType = BinaryMatrix>
+class ParameterOptimizer {
+public:
+    using ParametersType = typename AlgorithmType::ParametersType;
+
+private:
+    const MatrixType& checkMatrix;
+    const boost::dynamic_bitset<>& syndrome;
+    unsigned omega;
+    OptimizerOptions options;
+    std::vector<CalibrationPoint> points;
+    IterationCostModel model;
+
+    unsigned RowsSize() const {
+        return checkMatrix.RowsSize();
+    }
+
+    unsigned ColumnsSize() const {
+        return checkMatrix.ColumnsSize();
+    }
+
+    static double TotalWork(const IterationWork& work) {
+        return work.listEntries + work.collisions;
+    }
+
+    /**
+     * Seconds per information set of algorithm. Iterations which elimination failed are counted
+     * in time only, so the model includes their cost. Algorithms without Eliminate are measured per permutation
+     */
+    double MeasureIteration(const AlgorithmType& algorithm) const {
+        const unsigned maxPermutations = 16 * options.calibrationIterations;
+        unsigned numberOfIterations = 0, numberOfPermutations = 0;
+
+        const auto start = std::chrono::steady_clock::now();
+        auto permutationIter = RandomPermutation(ColumnsSize()).begin(options.seed, 0, 1, NumberOfRandomPositions(algorithm, checkMatrix));
+        for(; numberOfIterations < options.calibrationIterations && numberOfPermutations < maxPermutations; ++permutationIter) {
+            ++numberOfPermutations;
+            BinaryMatrix permutedCheckMatrix = checkMatrix.applyPermutation(*permutationIter);
+
+            if constexpr (requires { algorithm.Eliminate(permutedCheckMatrix, syndrome, omega); }) {
+                const auto context = algorithm.Eliminate(permutedCheckMatrix, syndrome, omega);
+                if(context) {
+                    ++numberOfIterations;
+                    algorithm.Search(*context);
+                }
+            } else {
+                ++numberOfIterations;
+                algorithm(permutedCheckMatrix, syndrome, omega);
+            }
+        }
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return seconds / std::max(numberOfIterations, 1u);
+    }
+
+public:
+    ParameterOptimizer(const MatrixType& checkMatrix, const boost::dynamic_bitset<>& syndrome, unsigned omega,
+                       OptimizerOptions options = {}) : checkMatrix(checkMatrix), syndrome(syndrome), omega(omega), options(options) {}
+
+    /**
+     * Runs cheap candidates spread over logarithm of their work and fits the cost model
+     */
+    const IterationCostModel& Calibrate() {
+        std::vector<std::pair<double, ParametersType>> affordable;
+        for(const auto& parameters: AlgorithmType::ParameterCandidates(RowsSize(), ColumnsSize(), omega)) {
+            const double work = TotalWork(MakeAlgorithm<AlgorithmType>(parameters, RowsSize(), ColumnsSize()).ExpectedWork(RowsSize(), ColumnsSize()));
+            if(work <= options.maxCalibrationWork) {
+                affordable.emplace_back(work, parameters);
+            }
+        }
+
+        std::stable_sort(affordable.begin(), affordable.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.first < rhs.first;
+        });
+
+        points.clear();
+        const std::size_t numberOfPoints = std::min<std::size_t>(options.calibrationPoints, affordable.size());
+        for(std::size_t point = 0; point < numberOfPoints; ++point) {
+            const std::size_t idx = numberOfPoints == 1 ? 0 : point * (affordable.size() - 1) / (numberOfPoints - 1);
+            const auto algorithm = MakeAlgorithm<AlgorithmType>(affordable[idx].second, RowsSize(), ColumnsSize());
+            points.push_back(CalibrationPoint{algorithm.ExpectedWork(RowsSize(), ColumnsSize()), MeasureIteration(algorithm)});
+        }
+
+        model = FitCostModel(points);
+        return model;
+    }
+
+    /**
+     * Uses the given cost model instead of calibration, e.g. the one of a previous run on the same machine
+     */
+    void SetCostModel(const IterationCostModel& costModel) {
+        model = costModel;
+    }
+
+    const IterationCostModel& CostModel() const {
+        return model;
+    }
+
+    const std::vector<CalibrationPoint>& CalibrationPoints() const {
+        return points;
+    }
+
+    /// Limit of bytes of lists of one thread, infinite if there is neither limit nor budget
+    double MaxListBytes() const {
+        if(options.maxListBytes > 0) {
+            return options.maxListBytes;
+        }
+
+        const std::size_t budget = MemoryAccounting::Budget();
+        return budget != 0 ? static_cast<double>(budget) / std::max(options.numberOfThreads, 1u) : std::numeric_limits<double>::infinity();
+    }
+
+    /**
+     * Candidate with the least expected time to solution, candidates which lists exceed maxListEntries
+     * or the limit of memory are skipped, so a small budget degrades parameters instead of exhausting memory
+     * @throw std::invalid_argument if there is no suitable candidate
+     */
+    OptimizedParameters<ParametersType> Best() const {
+        std::optional<OptimizedParameters<ParametersType>> best;
+        const double maxListBytes = MaxListBytes();
+
+        for(const auto& parameters: AlgorithmType::ParameterCandidates(RowsSize(), ColumnsSize(), omega)) {
+            const auto algorithm = MakeAlgorithm<AlgorithmType>(parameters, RowsSize(), ColumnsSize());
+            const auto work = algorithm.ExpectedWork(RowsSize(), ColumnsSize());
+            const double expectedIterations = algorithm.ExpectedIterations(RowsSize(), ColumnsSize(), omega);
+            if(work.listEntries > options.maxListEntries || work.listBytes > maxListBytes || !std::isfinite(expectedIterations)) {
+                continue;
+            }
+
+            const double secondsPerIteration = model.Seconds(work);
+            const double expectedSeconds = expectedIterations * secondsPerIteration;
+            if(!best || expectedSeconds < best->expectedSeconds) {
+                best = OptimizedParameters<ParametersType>{parameters, expectedIterations, secondsPerIteration, expectedSeconds};
+            }
+        }
+
+        if(!best) {
+            throw std::invalid_argument(std::string("there are no suitable parameters of ") + AlgorithmType::algorithmName);
+        }
+
+        return *best;
+    }
+};
+
+
+/**
+ * Creates algorithm with parameters chosen for the instance by ParameterOptimizer
+ * @param checkMatrix binary check matrix, BinaryMatrix or SystematicMatrix
+ * @param syndrome syndrome vector
+ * @param omega number of errors in codeword (i.e. number of ones in error vector)
+ * @param options options of calibration and limits of candidates
+ * @return algorithm
+ */
+template <OptimizableAlgorithm AlgorithmType, typename MatrixType = BinaryMatrix>
+AlgorithmType MakeOptimizedAlgorithm(const MatrixType& checkMatrix, const boost::dynamic_bitset<>& syndrome, unsigned omega,
+                                     OptimizerOptions options = {}) {
+    ParameterOptimizer<AlgorithmType, MatrixType> optimizer(checkMatrix, syndrome, omega, options);
+    optimizer.Calibrate();
+    const auto best = optimizer.Best();
+
+    std::cerr << "Parameters of " << AlgorithmType::algorithmName << " are optimized: expected iterations " << best.expectedIterations
+              << ", time of iteration " << best.secondsPerIteration * 1e6 << " us, expected time " << best.expectedSeconds << " s\n";
+
+    return MakeAlgorithm<AlgorithmType>(best.parameters, checkMatrix.RowsSize(), checkMatrix.ColumnsSize());
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/thread.hpp>
+
+#include <oneapi/tbb/concurrent_queue.h>
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <algebra/binary_matrix.hpp>
+#include <permutations/random_permutation_iterator.hpp>
+#include "base_decoding.hpp"
+#include "isd_engine.hpp"
+
+
+/**
+ * Algorithm which step is split into elimination and search of lists (every ISDEngine)
+ */
+template <typename AlgorithmType>
+concept PipelinedAlgorithm = requires(const AlgorithmType algorithm, BinaryMatrix& checkMatrix, boost::dynamic_bitset<> syndrome,
+                                      unsigned omega, const std::atomic<bool>* stopFlag, const ISDContext& context) {
+        { algorithm.Eliminate(checkMatrix, syndrome, omega, stopFlag) } -> std::same_as<std::optional<ISDContext>>;
+        { algorithm.Search(context) } -> std::same_as<std::optional<boost::dynamic_bitset<>>>;
+    };
+
+
+/**
+ * Options of pipelined decoding
+ */
+struct PipelineOptions {
+    /// Maximal number of eliminated matrices which wait for search, producers are blocked when it is reached
+    std::size_t queueDepth = 2;
+    /// Number of threads which permute check matrix and make gauss elimination
+    unsigned numberOfProducers = 1;
+    /// Number of threads which build and match lists
+    unsigned numberOfConsumers = 1;
+};
+
+
+/**
+ * Pipelined algorithm of decoding that find an error vector e for check matrix H and syndrome s such that H*e = s.
+ * Producers permute the check matrix and eliminate it, consumers build and match lists of eliminated matrices,
+ * so memory-bound elimination of the next iterations overlaps with the search of the current one.
+ * Stages are connected by a bounded queue, the first found error vector stops both stages:
+ * producers stop eliminating and consumers skip the rest of queue
+ * @tparam DecodingStepAlgorithm type of algorithm (for example, Stern, MMT)
+ * @param checkMatrix binary check matrix
+ * @param syndrome syndrome vector
+ * @param omega number of errors in codeword (i.e. number of ones in error vector)
+ * @param algorithm algorithm for decoding
+ * @param options depth of queue and number of threads of stages
+ * @return error vector
+ */
+template <PipelinedAlgorithm DecodingStepAlgorithm>
+boost::dynamic_bitset<> DecodingPipelined(const BinaryMatrix& checkMatrix, const boost::dynamic_bitset<>& syndrome,
+                                          const unsigned omega, const DecodingStepAlgorithm& algorithm,
+                                          const PipelineOptions& options = PipelineOptions()) {
+    /// Item of queue, item without context marks the end of stream for one consumer
+    struct EliminatedPermutation {
+        std::vector<unsigned> permutation;
+        std::optional<ISDContext> context;
+    };
+
+    const unsigned cols = checkMatrix.ColumnsSize();
+    const unsigned numberOfProducers = std::max(options.numberOfProducers, 1u);
+    // consumers hold lists, so only consumers which fit into the memory budget are run
+    const unsigned numberOfConsumers = ThreadsWithinBudget(algorithm, checkMatrix, options.numberOfConsumers);
+
+    boost::dynamic_bitset<> errorVector(cols);
+    std::atomic<bool> isFound = false;
+    std::atomic<std::uint64_t> numberOfIterations = 0;
+    std::atomic<unsigned> runningProducers = numberOfProducers;
+
+    tbb::concurrent_bounded_queue<EliminatedPermutation> queue;
+    queue.set_capacity(static_cast<std::ptrdiff_t>(std::max<std::size_t>(options.queueDepth, 1)));
+
+    const std::uint64_t seed = RandomPermutation::RandomSeed();
+    const auto randomPositions = NumberOfRandomPositions(algorithm, checkMatrix);
+
+    const auto produce = [&](unsigned producerIdx) {
+        RandomPermutation permutations(cols);
+
+        for(std::uint64_t index = producerIdx; !isFound.load(std::memory_order_relaxed); index += numberOfProducers) {
+            EliminatedPermutation item{permutations.Get(seed, index, randomPositions), std::nullopt};
+
+            BinaryMatrix permutedCheckMatrix = checkMatrix.applyPermutation(item.permutation);
+            item.context = algorithm.Eliminate(permutedCheckMatrix, syndrome, omega, &isFound);
+
+            if(!item.context) {
+                ++numberOfIterations;
+                continue;
+            }
+
+            // consumers drain queue until the end of stream, so blocked push always returns
+            queue.push(std::move(item));
+        }
+
+        if(runningProducers.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            for(unsigned consumerIdx = 0; consumerIdx < numberOfConsumers; ++consumerIdx) {
+                queue.push(EliminatedPermutation());
+            }
+        }
+    };
+
+    const auto consume = [&]() {
+        while(true) {
+            EliminatedPermutation item;
+            queue.pop(item);
+
+            if(!item.context) {
+                break;
+            }
+            if(isFound.load(std::memory_order_relaxed)) {
+                continue;
+            }
+
+            auto permutedErrorVector = algorithm.Search(*item.context);
+            ++numberOfIterations;
+
+            bool expected = false;
+            if(permutedErrorVector && isFound.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                for(unsigned idx = 0; idx < cols; ++idx) {
+                    errorVector[item.permutation[idx]] = (*permutedErrorVector)[idx];
+                }
+            }
+        }
+    };
+
+    boost::thread_group stages;
+    for(unsigned producerIdx = 0; producerIdx < numberOfProducers; ++producerIdx) {
+        stages.create_thread([&produce, producerIdx]() {
+            produce(producerIdx);
+        });
+    }
+    for(unsigned consumerIdx = 0; consumerIdx < numberOfConsumers; ++consumerIdx) {
+        stages.create_thread(consume);
+    }
+
+    stages.join_all();
+
+    std::cout << "Algorithm: " << algorithm.algorithmName << ",\tsize: " << cols << ",\tnumber of iterations: " << numberOfIterations << '\n';
+    return errorVector;
+}
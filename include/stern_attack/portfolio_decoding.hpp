@@ -0,0 +1,252 @@
+#pragma once
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/thread.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <algebra/binary_matrix.hpp>
+#include <permutations/random_permutation_iterator.hpp>
+#include "base_decoding.hpp"
+
+
+/**
+ * Progress of one algorithm of DecodingPortfolio
+ */
+struct PortfolioMemberReport {
+    const char* algorithmName;
+    std::uint64_t numberOfIterations;
+    double secondsPerIteration;
+    double expectedIterations;
+    /// Expected time to solution of one thread, the best algorithm has the least one
+    double projectedSeconds;
+    /// Number of threads which are running iterations of the algorithm now
+    unsigned numberOfThreads;
+};
+
+
+/**
+ * Decoding which races several algorithms on one instance. Threads are split between algorithms
+ * until each of them makes warmupIterations, then every thread takes the algorithm with the least
+ * projected time to solution, i.e. expected number of iterations times measured time of one iteration.
+ * Projection is updated after every iteration, the first found error vector stops all threads
+ */
+class DecodingPortfolio {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    using StepFunction = std::function<std::optional<boost::dynamic_bitset<>>(BinaryMatrix&, const boost::dynamic_bitset<>&,
+                                                                              const std::atomic<bool>&)>;
+
+    struct Member {
+        const char* algorithmName;
+        StepFunction step;
+        double expectedIterations;
+        std::uint64_t seed;
+        std::size_t randomPositions;
+
+        std::uint64_t nextIndex = 0;
+        std::uint64_t numberOfIterations = 0;
+        double seconds = 0;
+        unsigned numberOfThreads = 0;
+
+        double SecondsPerIteration() const {
+            return numberOfIterations > 0 ? seconds / numberOfIterations : 0;
+        }
+    };
+
+    const BinaryMatrix& checkMatrix;
+    const boost::dynamic_bitset<>& syndrome;
+    unsigned omega;
+    unsigned numThreads;
+    std::uint64_t warmupIterations;
+
+    std::deque<Member> members;
+    std::atomic<bool> isFound = false;
+    std::optional<std::size_t> winner;
+    boost::dynamic_bitset<> errorVector;
+    mutable std::mutex mx;
+
+    /**
+     * Algorithm for the next iteration: the one with the least started iterations during warmup,
+     * the one with the least projected time to solution after it
+     */
+    std::size_t Choose() const {
+        const auto started = [](const Member& member) {
+            return member.numberOfIterations + member.numberOfThreads;
+        };
+
+        const auto warming = std::min_element(members.begin(), members.end(), [&started](const Member& lhs, const Member& rhs) {
+            return started(lhs) < started(rhs);
+        });
+        const bool isMeasured = std::any_of(members.begin(), members.end(), [](const Member& member) {
+            return member.numberOfIterations > 0;
+        });
+        if(started(*warming) < warmupIterations || !isMeasured) {
+            return warming - members.begin();
+        }
+
+        // algorithms without complete iterations are not projected yet
+        const auto best = std::min_element(members.begin(), members.end(), [](const Member& lhs, const Member& rhs) {
+            if(rhs.numberOfIterations == 0) {
+                return lhs.numberOfIterations != 0;
+            }
+            return lhs.numberOfIterations != 0 && lhs.expectedIterations * lhs.SecondsPerIteration() < rhs.expectedIterations * rhs.SecondsPerIteration();
+        });
+        return best - members.begin();
+    }
+
+    void Work() {
+        const unsigned cols = checkMatrix.ColumnsSize();
+        RandomPermutation permutations(cols);
+
+        while(!isFound.load(std::memory_order_relaxed)) {
+            // Add may push into members meanwhile, so the member is taken by pointer, which stays valid,
+            // its step, seed and randomPositions are not changed after Add and are read without the lock
+            std::size_t memberIdx;
+            Member* chosen;
+            std::uint64_t index;
+            {
+                std::lock_guard lock(mx);
+                memberIdx = Choose();
+                chosen = &members[memberIdx];
+                index = chosen->nextIndex++;
+                ++chosen->numberOfThreads;
+            }
+
+            auto& member = *chosen;
+            const auto begin = Clock::now();
+
+            const auto permutation = permutations.Get(member.seed, index, member.randomPositions);
+            BinaryMatrix permutedCheckMatrix = checkMatrix.applyPermutation(permutation);
+            const auto permutedErrorVector = member.step(permutedCheckMatrix, syndrome, isFound);
+
+            const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+            std::lock_guard lock(mx);
+            --member.numberOfThreads;
+
+            bool expected = false;
+            if(permutedErrorVector && isFound.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                errorVector.resize(cols);
+                for(unsigned idx = 0; idx < cols; ++idx) {
+                    errorVector[permutation[idx]] = (*permutedErrorVector)[idx];
+                }
+                winner = memberIdx;
+            }
+
+            // iterations interrupted by the found error vector are not complete measurements
+            if(permutedErrorVector || !isFound.load(std::memory_order_relaxed)) {
+                ++member.numberOfIterations;
+                member.seconds += seconds;
+            }
+        }
+    }
+
+public:
+    /**
+     * @param checkMatrix binary check matrix, it should outlive the portfolio
+     * @param syndrome syndrome vector, it should outlive the portfolio
+     * @param omega number of errors in codeword (i.e. number of ones in error vector)
+     * @param numThreads number of threads shared by all algorithms
+     * @param warmupIterations number of iterations of every algorithm before time to solution is projected
+     */
+    DecodingPortfolio(const BinaryMatrix& checkMatrix, const boost::dynamic_bitset<>& syndrome, const unsigned omega,
+                      unsigned numThreads = std::thread::hardware_concurrency(), std::uint64_t warmupIterations = 4)
+        : checkMatrix(checkMatrix), syndrome(syndrome), omega(omega), numThreads(std::max(numThreads, 1u)),
+          warmupIterations(std::max<std::uint64_t>(warmupIterations, 1)) {}
+
+    /**
+     * Adds algorithm to the race
+     * @param expectedIterations expected number of permutations to solution, by default it is given
+     * by ExpectedPermutations of algorithm
+     */
+    template <typename DecodingStepAlgorithm>
+    void Add(const DecodingStepAlgorithm& algorithm, std::optional<double> expectedIterations = std::nullopt) {
+        if(!expectedIterations) {
+            if constexpr (requires { algorithm.ExpectedIterations(checkMatrix.RowsSize(), checkMatrix.ColumnsSize(), omega); }) {
+                expectedIterations = ExpectedPermutations(algorithm, checkMatrix.RowsSize(), checkMatrix.ColumnsSize(), omega);
+            } else {
+                throw std::invalid_argument(std::string("expected number of iterations of ") + algorithm.algorithmName + " is unknown");
+            }
+        }
+
+        StepFunction step = [algorithm, omega = omega](BinaryMatrix& permutedCheckMatrix, const boost::dynamic_bitset<>& syndrome,
+                                                       const std::atomic<bool>& stopFlag) {
+            if constexpr (requires { algorithm(permutedCheckMatrix, syndrome, omega, stopFlag); }) {
+                return algorithm(permutedCheckMatrix, syndrome, omega, stopFlag);
+            } else {
+                return algorithm(permutedCheckMatrix, syndrome, omega);
+            }
+        };
+
+        std::lock_guard lock(mx);
+        members.push_back(Member{algorithm.algorithmName, std::move(step), *expectedIterations,
+                                 RandomPermutation::RandomSeed(), NumberOfRandomPositions(algorithm, checkMatrix)});
+    }
+
+    /**
+     * Races added algorithms until one of them finds an error vector
+     * @return error vector
+     */
+    boost::dynamic_bitset<> Run() {
+        {
+            std::lock_guard lock(mx);
+            if(members.empty()) {
+                throw std::logic_error("portfolio has no algorithms");
+            }
+        }
+
+        isFound = false;
+        boost::thread_group threads;
+        for(unsigned threadIdx = 0; threadIdx < numThreads; ++threadIdx) {
+            threads.create_thread([this]() {
+                Work();
+            });
+        }
+
+        threads.join_all();
+
+        std::cout << "Portfolio winner: " << Winner() << ",\tsize: " << checkMatrix.ColumnsSize() << '\n';
+        return errorVector;
+    }
+
+    /**
+     * Name of the algorithm which found the error vector, nullptr before it
+     */
+    const char* Winner() const {
+        std::lock_guard lock(mx);
+        return winner ? members[*winner].algorithmName : nullptr;
+    }
+
+    /**
+     * Progress of all algorithms in order of adding, may be called while Run is in progress
+     */
+    std::vector<PortfolioMemberReport> Report() const {
+        std::lock_guard lock(mx);
+
+        std::vector<PortfolioMemberReport> reports;
+        for(const auto& member: members) {
+            const double projectedSeconds = member.numberOfIterations > 0 ? member.expectedIterations * member.SecondsPerIteration()
+                                                                          : std::numeric_limits<double>::infinity();
+            reports.push_back(PortfolioMemberReport{member.algorithmName, member.numberOfIterations, member.SecondsPerIteration(),
+                                                    member.expectedIterations, projectedSeconds, member.numberOfThreads});
+        }
+
+        return reports;
+    }
+};
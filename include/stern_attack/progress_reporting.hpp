@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/**
+ * Options of periodic progress reports of long decoding, default options disable reports
+ */
+struct ProgressOptions {
+    /// Time between reports, zero disables reports
+    std::chrono::milliseconds interval{0};
+    /// Reports are appended to this file as JSON lines, empty means human readable lines on stderr
+    std::string metricsFile;
+    /// Expected number of iterations to solution, zero means the expectation of the algorithm.
+    /// Iterations are permutations including ones which elimination failed
+    double expectedIterations = 0;
+};
+
+
+/**
+ * Progress of decoding since the reporter was started
+ */
+struct ProgressReport {
+    double elapsedSeconds = 0;
+    /// Number of permutations including ones which elimination failed
+    std::uint64_t numberOfIterations = 0;
+    double iterationsPerSecond = 0;
+    std::vector<double> threadIterationsPerSecond;
+    /// Zero if unknown
+    double expectedIterations = 0;
+    /// Probability that the error vector is found in numberOfIterations iterations
+    double successProbability = 0;
+    /// Expected time to solution, iterations are independent trials, so it depends only on the rate
+    std::optional<double> etaSeconds;
+    /// The last report, written when decoding is over
+    bool isFinal = false;
+};
+
+
+/**
+ * Periodic reports of number of iterations, their rate and ETA of decoding threads. Every thread
+ * counts its iterations in its own cache line with relaxed stores, the reports are made by
+ * a separate thread which sleeps between them, so the decoding threads never wait for it
+ */
+class ProgressReporter {
+    using Clock = std::chrono::steady_clock;
+
+    struct alignas(64) ThreadCounter {
+        std::atomic<std::uint64_t> iterations = 0;
+    };
+
+    ProgressOptions options;
+    std::vector<ThreadCounter> counters;
+    const Clock::time_point start;
+
+    std::ofstream metrics;
+    std::mutex mx;
+    std::condition_variable wakeUp;
+    bool isStopped = false;
+    std::thread reporter;
+
+    static std::string FormatDuration(double seconds) {
+        const auto total = static_cast<std::uint64_t>(seconds);
+        std::ostringstream text;
+        text << std::setfill('0') << total / 3600 << ':' << std::setw(2) << total / 60 % 60 << ':' << std::setw(2) << total % 60;
+        return text.str();
+    }
+
+    void Write(const ProgressReport& report) {
+        std::ostringstream line;
+        if(metrics.is_open()) {
+            line << "{\"elapsed_seconds\": " << report.elapsedSeconds << ", \"iterations\": " << report.numberOfIterations
+                 << ", \"iterations_per_second\": " << report.iterationsPerSecond << ", \"thread_iterations_per_second\": [";
+            for(std::size_t threadIdx = 0; threadIdx < report.threadIterationsPerSecond.size(); ++threadIdx) {
+                line << (threadIdx > 0 ? ", " : "") << report.threadIterationsPerSecond[threadIdx];
+            }
+            line << "], \"expected_iterations\": " << report.expectedIterations << ", \"success_probability\": " << report.successProbability
+                 << ", \"eta_seconds\": ";
+            if(report.etaSeconds) {
+                line << *report.etaSeconds;
+            } else {
+                line << "null";
+            }
+            line << ", \"final\": " << (report.isFinal ? "true" : "false") << "}\n";
+
+            metrics << line.str() << std::flush;
+            return;
+        }
+
+        line << "progress: " << FormatDuration(report.elapsedSeconds) << " elapsed, " << report.numberOfIterations << " iterations, "
+             << std::fixed << std::setprecision(1) << report.iterationsPerSecond << " it/s";
+        if(report.threadIterationsPerSecond.size() > 1) {
+            line << " (per thread";
+            for(const double rate: report.threadIterationsPerSecond) {
+                line << ' ' << rate;
+            }
+            line << ')';
+        }
+        if(report.expectedIterations > 0) {
+            line << ", " << std::setprecision(1) << 100 * report.successProbability << "% chance of success so far";
+        }
+        if(report.etaSeconds) {
+            line << ", ETA " << FormatDuration(*report.etaSeconds);
+        }
+        line << (report.isFinal ? ", done\n" : "\n");
+
+        std::cerr << line.str();
+    }
+
+    void Loop() {
+        std::unique_lock lock(mx);
+        while(!wakeUp.wait_for(lock, options.interval, [this]() { return isStopped; })) {
+            Write(Report());
+        }
+    }
+
+public:
+    /**
+     * Starts the thread of reports
+     * @param options interval, destination and expected number of iterations
+     * @param numThreads number of decoding threads, thread threadIdx counts by AddIteration(threadIdx)
+     */
+    ProgressReporter(const ProgressOptions& options, unsigned numThreads)
+        : options(options), counters(std::max(numThreads, 1u)), start(Clock::now()) {
+        if(!options.metricsFile.empty()) {
+            metrics.open(options.metricsFile, std::ios::app);
+            if(!metrics) {
+                throw std::runtime_error("metrics file " + options.metricsFile + " cannot be opened");
+            }
+        }
+
+        if(options.interval.count() > 0) {
+            reporter = std::thread([this]() {
+                Loop();
+            });
+        }
+    }
+
+    ~ProgressReporter() {
+        Stop();
+    }
+
+    ProgressReporter(const ProgressReporter&) = delete;
+    ProgressReporter& operator=(const ProgressReporter&) = delete;
+
+    /// The counter of thread has only one writer, so it is increased without read-modify-write
+    void AddIteration(unsigned threadIdx) {
+        auto& iterations = counters[threadIdx].iterations;
+        iterations.store(iterations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    ProgressReport Report() const {
+        ProgressReport report;
+        report.elapsedSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        for(const auto& counter: counters) {
+            const std::uint64_t iterations = counter.iterations.load(std::memory_order_relaxed);
+            report.numberOfIterations += iterations;
+            report.threadIterationsPerSecond.push_back(report.elapsedSeconds > 0 ? iterations / report.elapsedSeconds : 0);
+        }
+        report.iterationsPerSecond = report.elapsedSeconds > 0 ? report.numberOfIterations / report.elapsedSeconds : 0;
+
+        report.expectedIterations = std::isfinite(options.expectedIterations) ? options.expectedIterations : 0;
+        if(report.expectedIterations > 0) {
+            // 1 - (1 - 1 / expected)^iterations
+            report.successProbability = report.expectedIterations > 1
+                ? -std::expm1(report.numberOfIterations * std::log1p(-1 / report.expectedIterations))
+                : (report.numberOfIterations > 0 ? 1 : 0);
+            if(report.iterationsPerSecond > 0) {
+                report.etaSeconds = report.expectedIterations / report.iterationsPerSecond;
+            }
+        }
+
+        return report;
+    }
+
+    /// Stops the thread of reports and writes the final report, later calls do nothing
+    void Stop() {
+        {
+            std::lock_guard lock(mx);
+            if(isStopped) {
+                return;
+            }
+            isStopped = true;
+        }
+
+        if(reporter.joinable()) {
+            wakeUp.notify_one();
+            reporter.join();
+
+            auto report = Report();
+            report.isFinal = true;
+            Write(report);
+        }
+    }
+};
@@ -2,119 +2,230 @@
 
 #include <boost/dynamic_bitset.hpp>
 #include <iostream>
-#include <random>
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <numeric>
+#include <span>
+#include <vector>
 
 #include <algebra/binary_matrix.hpp>
 #include <permutations/combination_iterator.hpp>
-#include <permutations/primitive_permutation_iterator.hpp>
 #include <permutations/random_permutation_iterator.hpp>
-#include <utils/cartesian_product.hpp>
 #include "base_decoding.hpp"
-
-
-class SternAlgorithm : public BaseAlgorithm {
+#include "isd_engine.hpp"
+#include "list_matching.hpp"
+
+
+/**
+ * Parameters of Stern-like algorithms
+ */
+struct SternParameters {
+    /// Weight of combinations of every half of information set
+    unsigned p;
+    /// Width of the collision window
+    unsigned l;
+};
+
+
+/**
+ * Enumerator of Stern-like algorithms: p-combinations of the first and the second half
+ * of information set, keys are sums of columns projected onto l rows of the collision window
+ * (with syndrome added for the second half).
+ * Several disjoint windows [0, l), [l, 2l), ... are tried after one elimination: lists are
+ * enumerated once and only their keys are recomputed for every next window.
+ * Besides the fixed split of information set into halves, several random bipartitions
+ * may be tried after one elimination, only lists are rebuilt for each of them
+ * @tparam ExtendedInformationSet if true, information set is extended by l columns
+ * of identity part as in FS-ISD
+ */
+template <ListStore LeftStore, ListStore RightStore, bool ExtendedInformationSet = false>
+class SternEnumerator {
+protected:
     int p;
     int l;
+    unsigned numberOfWindows;
+    unsigned numberOfSplits;
+
+    /**
+     * Projections of columns of (extended) information set onto rows of the window.
+     * Extension columns of FS-ISD are unit vectors of the current window
+     */
+    std::vector<KeyType> WindowKeys(const ISDContext& context, unsigned window, unsigned endCol) const {
+        const unsigned k = context.InformationSetSize();
+        auto keys = context.ColumnKeys(std::min(endCol, k), window * l, l);
+
+        keys.resize(endCol);
+        for(unsigned col = k; col < endCol; ++col) {
+            keys[col] = KeyType(1) << (col - k);
+        }
+
+        return keys;
+    }
+
+    /// Windows which do not fit into rows of check matrix are skipped
+    unsigned WindowsFor(const ISDContext& context) const {
+        return std::clamp(context.RowsSize() / l, 1u, numberOfWindows);
+    }
+
+    /**
+     * Order of columns of (extended) information set, the first half of it goes to the left list.
+     * The first split keeps columns in place, others are shuffled by Philox stream split of the iteration,
+     * so splits differ between iterations and threads and are reproduced by the same seed of decoding
+     */
+    std::vector<unsigned> SplitOrder(const ISDContext& context, unsigned colsSizeOfQ, unsigned split) const {
+        std::vector<unsigned> order(colsSizeOfQ);
+        std::iota(order.begin(), order.end(), 0);
+
+        if(split != 0) {
+            RandomPermutation::Shuffle(order, context.IterationIdentifier(), split);
+        }
+
+        return order;
+    }
 
 public:
-    constexpr static const char* algorithmName = "Stern";
+    using LeftStoreType = LeftStore;
+    using RightStoreType = RightStore;
+    using ParametersType = SternParameters;
 
     /**
      * Creates an object for Stern algorithm
-     * @param cols number of columns in matrix, p will initialize as 0.003 * cols
-     * l as 0.013 * cols  (it's optimal parameters)
+     * @param cols number of columns in matrix, p will initialize as 0.002 * cols
+     * l as 0.013 * cols (rough defaults, see ParameterOptimizer), l can not exceed width of key
+     * @param numberOfWindows number of disjoint l-windows checked after one elimination
+     * @param numberOfSplits number of bipartitions of information set checked after one elimination
     */
-    SternAlgorithm(unsigned cols) : p(static_cast<unsigned>(0.002 * cols) > 0 ? 0.002 * cols : 1),
-                                l(static_cast<unsigned>(0.013 * cols) > 0 ? 0.013 * cols : 1) {}
+    SternEnumerator(unsigned cols, unsigned numberOfWindows = 1, unsigned numberOfSplits = 1) :
+                                     p(static_cast<unsigned>(0.002 * cols) > 0 ? 0.002 * cols : 1),
+                                     l(std::min(static_cast<unsigned>(0.013 * cols) > 0 ? static_cast<unsigned>(0.013 * cols) : 1, maxKeyLength)),
+                                     numberOfWindows(std::max(numberOfWindows, 1u)),
+                                     numberOfSplits(std::max(numberOfSplits, 1u)) {}
+
+    /**
+     * Creates an object for Stern algorithm with the given parameters (e.g. chosen by ParameterOptimizer)
+     */
+    SternEnumerator(SternParameters parameters, unsigned numberOfWindows = 1, unsigned numberOfSplits = 1) :
+                                     p(std::max(parameters.p, 1u)),
+                                     l(std::clamp(parameters.l, 1u, maxKeyLength)),
+                                     numberOfWindows(std::max(numberOfWindows, 1u)),
+                                     numberOfSplits(std::max(numberOfSplits, 1u)) {}
+
+    /**
+     * Parameters which ParameterOptimizer compares: p up to 4 and every width of window
+     * which leaves enough rows for the rest of errors
+     */
+    static std::vector<SternParameters> ParameterCandidates(unsigned rows, unsigned cols, unsigned omega) {
+        std::vector<SternParameters> candidates;
+        for(unsigned p = 1; p <= 4 && 2 * p <= omega; ++p) {
+            for(unsigned l = 1; l <= maxKeyLength && l + (omega - 2 * p) <= rows; ++l) {
+                candidates.push_back(SternParameters{p, l});
+            }
+        }
+
+        return candidates;
+    }
 
     std::pair<unsigned, unsigned> getParams() const {
         return std::make_pair(p, l);
     }
 
+    unsigned getNumberOfWindows() const {
+        return numberOfWindows;
+    }
+
+    unsigned getNumberOfSplits() const {
+        return numberOfSplits;
+    }
+
     /**
-     * Makes one step of Stern algorithm to already permuted check matrix
-     * @param checkMatrix binary permuted check matrix for which gauss elimination should be applied
-     * @param syndrome syndrome vector 
-     * @param omega number of errors in codeword (i.e. number of ones in error vector)
-     * @return filled std::optional<boost::dynamic_bitset<>> if success, else empty optional
+     * Expected number of iterations to the error vector: p errors in each half of (extended) information set
+     * and no errors in the window, every window and split is one more chance (as in benchmark/graph.py)
      */
-    std::optional<boost::dynamic_bitset<>> operator()(BinaryMatrix& checkMatrix, boost::dynamic_bitset<> syndrome, const unsigned omega) const {
-        if(!GaussElimination(checkMatrix, syndrome)) {
-            return std::optional<boost::dynamic_bitset<>>();
-        }
-        unsigned rows = checkMatrix.RowsSize();
-        unsigned cols = checkMatrix.ColumnsSize();
-        unsigned colsSizeOfQ = cols - rows;
-        unsigned halfColsSizeOfQ = colsSizeOfQ / 2;
+    double ExpectedIterations(unsigned rows, unsigned cols, unsigned omega) const {
+        const int k = cols - rows;
+        const int halfColsSizeOfQ = (k + (ExtendedInformationSet ? l : 0)) / 2;
+        const unsigned windows = std::clamp(rows / l, 1u, numberOfWindows);
 
-        using CollisionType = std::pair<boost::dynamic_bitset<>, std::vector<unsigned>>;
+        const double logSuccesses = 2 * LogNumberOfCombinations(halfColsSizeOfQ, p) + LogNumberOfCombinations(static_cast<int>(rows) - l, static_cast<int>(omega) - 2 * p);
+        return ::ExpectedIterations(LogNumberOfCombinations(cols, omega), logSuccesses, windows * numberOfSplits);
+    }
 
-        std::vector<CollisionType> projectedSum1, projectedSum2;
-        boost::dynamic_bitset<> projectedSyndrome = Projection(syndrome, l);
+    /**
+     * Lists of every split are enumerated once and rekeyed for every window, pairs of random
+     * sums collide on l bits with probability 2^-l. The same two lists are reused by all rounds
+     */
+    IterationWork ExpectedWork(unsigned rows, unsigned cols) const {
+        const int halfColsSizeOfQ = (cols - rows + (ExtendedInformationSet ? l : 0)) / 2;
+        const double lengthOfList = std::exp(LogNumberOfCombinations(halfColsSizeOfQ, p));
+        const unsigned rounds = std::clamp(rows / l, 1u, numberOfWindows) * numberOfSplits;
 
-        for(auto combinationIter = Combination(p, halfColsSizeOfQ).begin(); combinationIter.CombinationsStillExist(); ++combinationIter) {
-            projectedSum1.emplace_back(checkMatrix.sumOfColumns(*combinationIter, l), *combinationIter);
+        return IterationWork{2 * lengthOfList * rounds, rounds * std::ldexp(lengthOfList * lengthOfList, -l),
+                             lengthOfList * (LeftStore::EntryBytes(p) + RightStore::EntryBytes(p))};
+    }
 
-            std::vector<unsigned> shiftedCombination = *combinationIter;
-            std::for_each(shiftedCombination.begin(), shiftedCombination.end(), [&halfColsSizeOfQ](auto& element){
-                element += halfColsSizeOfQ;
-            });
+    /// Every split is matched on every window
+    unsigned NumberOfRounds(const ISDContext& context) const {
+        return numberOfSplits * WindowsFor(context);
+    }
 
-            projectedSum2.emplace_back(checkMatrix.sumOfColumns(shiftedCombination, l) ^ projectedSyndrome, shiftedCombination);
-        }
+    void Enumerate(const ISDContext& context, LeftStoreType& left, RightStoreType& right, unsigned round = 0) const {
+        const unsigned colsSizeOfQ = context.InformationSetSize() + (ExtendedInformationSet ? l : 0);
+        const unsigned halfColsSizeOfQ = colsSizeOfQ / 2;
+        const unsigned windows = WindowsFor(context);
+        const unsigned window = round % windows, split = round / windows;
 
+        const auto columnKeys = WindowKeys(context, window, colsSizeOfQ);
+        const KeyType syndromeKey = context.SyndromeKey(window * l, l);
 
-        std::sort(projectedSum1.begin(), projectedSum1.end());
-        std::sort(projectedSum2.begin(), projectedSum2.end());
-
-        for(auto iter1 = projectedSum1.begin(), iter2 = projectedSum2.begin(); iter1 != projectedSum1.end() && iter2 != projectedSum2.end();) {
-            if(iter1->first < iter2->first) {
-                ++iter1;
-            } else if(iter1->first > iter2->first) {
-                ++iter2;
-            } else {
-                auto iterEnd1 = std::find_if(iter1, projectedSum1.end(), [&iter1] (auto &iter) {
-                    return iter.first != iter1->first;
-                });
-
-                auto iterEnd2 = std::find_if(iter2, projectedSum2.end(), [&iter2] (auto &iter) {
-                    return iter.first != iter2->first;
-                });
-
-                std::vector<std::tuple<CollisionType, CollisionType>> matchedResults;
-                cartesian_product(
-                    std::back_inserter(matchedResults),
-                    std::make_pair(iter1, iterEnd1),
-                    std::make_pair(iter2, iterEnd2)
-                );
-
-                for(const auto&[iter1, iter2] : matchedResults){
-                    if((checkMatrix.sumOfColumns(iter1.second) ^ checkMatrix.sumOfColumns(iter2.second) ^ syndrome).count() == omega - 2 * p) {
-                        boost::dynamic_bitset<> errorVector(cols);
-
-                        for(unsigned setBitIdx = 0; setBitIdx < p; ++setBitIdx) {
-                            errorVector.set(iter1.second[setBitIdx]);
-                            errorVector.set(iter2.second[setBitIdx]);
-                        }
-
-                        const auto matchedSupp = checkMatrix.sumOfColumns(iter1.second) ^ checkMatrix.sumOfColumns(iter2.second) ^ syndrome;
-                        for(boost::dynamic_bitset<>::size_type setBitIdx = 0; setBitIdx < matchedSupp.size(); ++setBitIdx) {
-                            if(matchedSupp[setBitIdx]){
-                                errorVector.set(setBitIdx + colsSizeOfQ);
-                            }
-                        }
-
-                        return std::optional<boost::dynamic_bitset<>>(errorVector);
-                    }
-                }
-
-                iter1 = iterEnd1;
-                iter2 = iterEnd2;
+        const auto sumKey = [&columnKeys](std::span<const unsigned> tuple) {
+            KeyType key = 0;
+            for(const auto idx: tuple) {
+                key ^= columnKeys[idx];
             }
+            return key;
+        };
+
+        if(window != 0) {
+            left.Rekey(sumKey);
+            right.Rekey([&](std::span<const unsigned> tuple) {
+                return sumKey(tuple) ^ syndromeKey;
+            });
+
+            return;
         }
 
-        return std::optional<boost::dynamic_bitset<>>();
+        const auto order = SplitOrder(context, colsSizeOfQ, split);
+        auto combination = Combination(p, halfColsSizeOfQ);
+        left.Clear();
+        right.Clear();
+        left.Reserve(combination.GetNumberOfCombinations(), p);
+        right.Reserve(combination.GetNumberOfCombinations(), p);
+
+        std::vector<unsigned> leftCombination(p), rightCombination(p);
+        for(auto combinationIter = combination.begin(); combinationIter.CombinationsStillExist() && !context.StopRequested(); ++combinationIter) {
+            KeyType leftKey = 0, rightKey = syndromeKey;
+
+            for(int idx = 0; idx < p; ++idx) {
+                leftCombination[idx] = order[(*combinationIter)[idx]];
+                rightCombination[idx] = order[(*combinationIter)[idx] + halfColsSizeOfQ];
+                leftKey ^= columnKeys[leftCombination[idx]];
+                rightKey ^= columnKeys[rightCombination[idx]];
+            }
+
+            left.Add(leftKey, leftCombination);
+            right.Add(rightKey, rightCombination);
+        }
     }
-};
\ No newline at end of file
+};
+
+
+struct SternPolicy {
+    constexpr static const char* algorithmName = "Stern";
+
+    using EnumeratorType = SternEnumerator<SortedList, SortedList>;
+    using MatcherType = SortMergeMatcher;
+    using VerifierType = UnionVerifier;
+};
+
+using SternAlgorithm = ISDEngine<SternPolicy>;
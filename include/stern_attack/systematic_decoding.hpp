@@ -0,0 +1,171 @@
+#pragma once
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <algebra/binary_matrix.hpp>
+#include <algebra/packed_matrix.hpp>
+#include <algebra/systematic_matrix.hpp>
+#include <permutations/random_permutation_iterator.hpp>
+#include "base_decoding.hpp"
+#include "checkpoint.hpp"
+#include "isd_engine.hpp"
+#include "progress_reporting.hpp"
+
+
+/**
+ * Information set which check matrix is already eliminated, e.g. the systematic form stored with an instance
+ * or the columns of Q of [I | Q]
+ */
+struct EliminatedInformationSet {
+    /// Column idx of the eliminated check matrix is column permutation[idx] of the check matrix
+    std::vector<unsigned> permutation;
+    /// Columns of the eliminated check matrix [Q' | I] as ISDContext keeps them
+    PackedMatrix columns;
+    /// Syndrome of the eliminated check matrix
+    boost::dynamic_bitset<> syndrome;
+};
+
+
+/**
+ * The first information set of [I | Q]: the columns of Q. The identity block is moved to the last columns,
+ * the permuted matrix [Q | I] is what BinaryMatrix::GaussElimination makes, so the syndrome is not changed
+ */
+EliminatedInformationSet FirstInformationSet(const SystematicMatrix& checkMatrix, const boost::dynamic_bitset<>& syndrome) {
+    auto permutation = checkMatrix.IdentityLastPermutation();
+    auto columns = checkMatrix.PermutedColumns(permutation);
+
+    return EliminatedInformationSet{std::move(permutation), std::move(columns), syndrome};
+}
+
+
+/**
+ * Step of algorithm to the information set without gauss elimination. Algorithms of ISDEngine search
+ * its columns, other algorithms eliminate the unpacked check matrix, which changes nothing
+ * @return error vector of the eliminated check matrix if success, else empty optional
+ */
+template <typename DecodingStepAlgorithm>
+std::optional<boost::dynamic_bitset<>> EliminatedStep(const DecodingStepAlgorithm& algorithm, EliminatedInformationSet informationSet,
+                                                      const unsigned omega) {
+    if constexpr (requires(const ISDContext& context) { algorithm.Search(context); }) {
+        return algorithm.Search(ISDContext(std::move(informationSet.columns), informationSet.syndrome, omega));
+    } else {
+        BinaryMatrix eliminatedCheckMatrix = informationSet.columns.Transposed().ToBinaryMatrix();
+        return algorithm(eliminatedCheckMatrix, informationSet.syndrome, omega);
+    }
+}
+
+
+/**
+ * Decoding of check matrix [I | Q] of which only Q is stored. The first information set is the columns
+ * of Q: the identity block is moved to the last columns, the permuted matrix [Q | I] is already eliminated,
+ * so the first iteration skips gauss elimination. Other iterations are random as in Decoding,
+ * their permuted check matrices are built from Q
+ * @param checkMatrix check matrix [I | Q]
+ * @param syndrome syndrome vector
+ * @param omega number of errors in codeword (i.e. number of ones in error vector)
+ * @param algorithm algorithm for decoding
+ * @param progress periodic reports of progress, disabled by default
+ * @return error vector
+ */
+template <typename DecodingStepAlgorithm>
+boost::dynamic_bitset<> Decoding(const SystematicMatrix& checkMatrix, const boost::dynamic_bitset<>& syndrome,
+                                 const unsigned omega, const DecodingStepAlgorithm& algorithm,
+                                 const ProgressOptions& progress = {}) {
+    const unsigned cols = checkMatrix.ColumnsSize();
+    const auto reporter = StartProgress(progress, algorithm, checkMatrix, omega, 1);
+
+    boost::dynamic_bitset<> errorVector(cols);
+    const auto restore = [&errorVector](const std::vector<unsigned>& permutation, const boost::dynamic_bitset<>& permutedErrorVector) {
+        for(unsigned idx = 0; idx < permutation.size(); ++idx) {
+            errorVector[permutation[idx]] = permutedErrorVector[idx];
+        }
+    };
+
+    // every step is counted, including the successful one
+    unsigned numberOfIterations = 0;
+    auto informationSet = FirstInformationSet(checkMatrix, syndrome);
+    const auto identityLast = informationSet.permutation;
+    auto permutedErrorVector = EliminatedStep(algorithm, std::move(informationSet), omega);
+    ++numberOfIterations;
+    if(reporter) {
+        reporter->AddIteration(0);
+    }
+
+    if(permutedErrorVector) {
+        restore(identityLast, *permutedErrorVector);
+    } else {
+        auto permutationIter = RandomPermutation(cols).begin(RandomPermutation::RandomSeed(), 0, 1, NumberOfRandomPositions(algorithm, checkMatrix));
+        for(; permutationIter.CanBePermuted(); ++permutationIter) {
+            BinaryMatrix permutedCheckMatrix = checkMatrix.applyPermutation(*permutationIter);
+            auto copiedSyndrome = syndrome;
+
+            permutedErrorVector = algorithm(permutedCheckMatrix, copiedSyndrome, omega);
+            ++numberOfIterations;
+            if(reporter) {
+                reporter->AddIteration(0);
+            }
+
+            if(permutedErrorVector) {
+                restore(*permutationIter, *permutedErrorVector);
+                break;
+            }
+        }
+    }
+
+    std::cout << "Algorithm: " << algorithm.algorithmName << ",\tsize: " << cols << ",\tnumber of iterations: " << numberOfIterations << '\n';
+    return errorVector;
+}
+
+
+/**
+ * DecodingWithCheckpoints which iteration 0 is the step to the information set without gauss elimination
+ * instead of the permutation of index 0, e.g. to the systematic form stored with an instance
+ * @param informationSet eliminated information set of the check matrix
+ * @return error vector, zero vector if it was not found in maxIterations
+ */
+template <typename DecodingStepAlgorithm>
+boost::dynamic_bitset<> DecodingWithCheckpoints(const BinaryMatrix& checkMatrix, const boost::dynamic_bitset<>& syndrome,
+                                                const unsigned omega, const DecodingStepAlgorithm& algorithm,
+                                                EliminatedInformationSet informationSet, const std::string& checkpointFile,
+                                                std::chrono::milliseconds interval = std::chrono::seconds(60),
+                                                std::uint64_t maxIterations = std::numeric_limits<std::uint64_t>::max(),
+                                                const ProgressOptions& progress = {}) {
+    const auto firstStep = [&]() {
+        auto permutation = informationSet.permutation;
+        return std::make_pair(std::move(permutation), EliminatedStep(algorithm, std::move(informationSet), omega));
+    };
+
+    return detail::DecodingWithCheckpoints(checkMatrix, syndrome, omega, algorithm, firstStep, checkpointFile, interval, maxIterations, progress);
+}
+
+/**
+ * DecodingWithCheckpoints of check matrix [I | Q] of which only Q is stored. Iteration 0 is the first
+ * information set of Decoding of [I | Q], which skips gauss elimination, permuted check matrices
+ * of other iterations are built from Q
+ * @param checkMatrix check matrix [I | Q]
+ * @return error vector, zero vector if it was not found in maxIterations
+ */
+template <typename DecodingStepAlgorithm>
+boost::dynamic_bitset<> DecodingWithCheckpoints(const SystematicMatrix& checkMatrix, const boost::dynamic_bitset<>& syndrome,
+                                                const unsigned omega, const DecodingStepAlgorithm& algorithm,
+                                                const std::string& checkpointFile,
+                                                std::chrono::milliseconds interval = std::chrono::seconds(60),
+                                                std::uint64_t maxIterations = std::numeric_limits<std::uint64_t>::max(),
+                                                const ProgressOptions& progress = {}) {
+    const auto firstStep = [&]() {
+        auto informationSet = FirstInformationSet(checkMatrix, syndrome);
+        auto permutation = informationSet.permutation;
+        return std::make_pair(std::move(permutation), EliminatedStep(algorithm, std::move(informationSet), omega));
+    };
+
+    return detail::DecodingWithCheckpoints(checkMatrix, syndrome, omega, algorithm, firstStep, checkpointFile, interval, maxIterations, progress);
+}
@@ -1,7 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
 
 class Timer {
 public: 
@@ -38,4 +45,205 @@ private:
     std::string nameOfProgram;
     unsigned numberOfIterations;
     bool printDuration;
-};
\ No newline at end of file
+};
+
+/**
+ * Prevents compiler from removing computation of value which is not used otherwise
+ */
+template <typename ValueType>
+void DoNotOptimize(const ValueType& value) {
+    asm volatile("" : : "m"(value) : "memory");
+}
+
+
+/**
+ * Distribution of time of one call of benchmarked function
+ */
+struct BenchmarkStatistics {
+    std::size_t samples;
+    /// Number of calls in one sample
+    std::uint64_t batch;
+    double minNs;
+    double medianNs;
+    double meanNs;
+    double p90Ns;
+    double p99Ns;
+    double maxNs;
+};
+
+
+/**
+ * Harness for microbenchmarks of kernels: nanosecond timing, warmup and repeated samples.
+ * Fast functions are called in batches long enough to be measured precisely,
+ * statistics are computed over time of one call
+ */
+class MicroBenchmark {
+    using Clock = std::chrono::steady_clock;
+
+    unsigned samples;
+    unsigned warmupSamples;
+    std::chrono::nanoseconds minSampleTime;
+
+    static double Percentile(const std::vector<double>& sorted, double fraction) {
+        const double position = fraction * (sorted.size() - 1);
+        const auto lower = static_cast<std::size_t>(position);
+        const auto upper = std::min(lower + 1, sorted.size() - 1);
+
+        return sorted[lower] + (sorted[upper] - sorted[lower]) * (position - lower);
+    }
+
+    static BenchmarkStatistics Statistics(std::vector<double> times, std::uint64_t batch) {
+        std::sort(times.begin(), times.end());
+
+        double sum = 0;
+        for(const auto time: times) {
+            sum += time;
+        }
+
+        return BenchmarkStatistics{times.size(), batch, times.front(), Percentile(times, 0.5), sum / times.size(),
+                                   Percentile(times, 0.9), Percentile(times, 0.99), times.back()};
+    }
+
+    template <typename FunctionType>
+    static double Sample(FunctionType& function, std::uint64_t batch) {
+        const auto start = Clock::now();
+        for(std::uint64_t call = 0; call < batch; ++call) {
+            function();
+        }
+        const auto end = Clock::now();
+
+        return std::chrono::duration<double, std::nano>(end - start).count() / batch;
+    }
+
+public:
+    /**
+     * @param samples number of measured samples
+     * @param warmupSamples number of samples which are made before measurement and dropped
+     * @param minSampleTime minimal duration of one sample of fast function
+     */
+    MicroBenchmark(unsigned samples = 31, unsigned warmupSamples = 3, std::chrono::nanoseconds minSampleTime = std::chrono::milliseconds(1))
+        : samples(std::max(samples, 1u)), warmupSamples(warmupSamples), minSampleTime(minSampleTime) {}
+
+    /**
+     * Benchmarks function which can be called repeatedly on the same data
+     */
+    template <typename FunctionType>
+    BenchmarkStatistics Run(FunctionType&& function) const {
+        // batch is doubled until one sample is long enough
+        std::uint64_t batch = 1;
+        while(Sample(function, batch) * batch < minSampleTime.count() && batch < (std::uint64_t(1) << 30)) {
+            batch *= 2;
+        }
+
+        for(unsigned sample = 0; sample < warmupSamples; ++sample) {
+            Sample(function, batch);
+        }
+
+        std::vector<double> times;
+        times.reserve(samples);
+        for(unsigned sample = 0; sample < samples; ++sample) {
+            times.push_back(Sample(function, batch));
+        }
+
+        return Statistics(std::move(times), batch);
+    }
+
+    /**
+     * Benchmarks function which changes its data (e.g. gauss elimination in place):
+     * setup restores data before every call and is not measured
+     */
+    template <typename SetupType, typename FunctionType>
+    BenchmarkStatistics Run(SetupType&& setup, FunctionType&& function) const {
+        for(unsigned sample = 0; sample < warmupSamples; ++sample) {
+            setup();
+            Sample(function, 1);
+        }
+
+        std::vector<double> times;
+        times.reserve(samples);
+        for(unsigned sample = 0; sample < samples; ++sample) {
+            setup();
+            times.push_back(Sample(function, 1));
+        }
+
+        return Statistics(std::move(times), 1);
+    }
+};
+
+
+/**
+ * Summary of independent samples (e.g. number of iterations of runs of decoding) with 95% confidence intervals
+ */
+struct SampleSummary {
+    std::size_t count = 0;
+    double mean = 0;
+    double standardDeviation = 0;
+    /// Student's t interval of the mean
+    double meanLow = 0;
+    double meanHigh = 0;
+    double median = 0;
+    /// Distribution-free interval of the median by order statistics, it suits skewed samples such as geometric ones
+    double medianLow = 0;
+    double medianHigh = 0;
+};
+
+
+/**
+ * 0.975-quantile of Student's t-distribution with the given degrees of freedom
+ */
+double StudentQuantile975(std::size_t degreesOfFreedom) {
+    static constexpr std::array<double, 30> table{
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+
+    if(degreesOfFreedom == 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    if(degreesOfFreedom <= table.size()) {
+        return table[degreesOfFreedom - 1];
+    }
+
+    // Cornish-Fisher expansion around the normal quantile
+    constexpr double z = 1.959964;
+    return z + (z * z * z + z) / (4.0 * degreesOfFreedom);
+}
+
+
+SampleSummary Summarize(std::vector<double> samples) {
+    SampleSummary summary;
+    summary.count = samples.size();
+    if(samples.empty()) {
+        return summary;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const std::size_t n = samples.size();
+
+    double sum = 0;
+    for(const auto sample: samples) {
+        sum += sample;
+    }
+    summary.mean = sum / n;
+
+    double squares = 0;
+    for(const auto sample: samples) {
+        squares += (sample - summary.mean) * (sample - summary.mean);
+    }
+    summary.standardDeviation = n > 1 ? std::sqrt(squares / (n - 1)) : 0;
+
+    const double halfWidth = n > 1 ? StudentQuantile975(n - 1) * summary.standardDeviation / std::sqrt(n) : 0;
+    summary.meanLow = summary.mean - halfWidth;
+    summary.meanHigh = summary.mean + halfWidth;
+
+    summary.median = n % 2 == 1 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+
+    // ranks n/2 -+ 1.96 * sqrt(n)/2 by normal approximation of binomial distribution
+    const double rankHalfWidth = 1.959964 * std::sqrt(n) / 2;
+    const auto lowRank = static_cast<std::ptrdiff_t>(std::floor(n / 2.0 - rankHalfWidth));
+    const auto highRank = static_cast<std::ptrdiff_t>(std::ceil(n / 2.0 + rankHalfWidth));
+    summary.medianLow = samples[std::clamp<std::ptrdiff_t>(lowRank - 1, 0, n - 1)];
+    summary.medianHigh = samples[std::clamp<std::ptrdiff_t>(highRank - 1, 0, n - 1)];
+
+    return summary;
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+/**
+ * Event of perf_event_open: type and config as in perf_event_attr
+ */
+struct PerfEventDescription {
+    const char* name;
+    std::uint32_t type;
+    std::uint64_t config;
+};
+
+
+#ifdef __linux__
+namespace detail {
+    constexpr std::uint64_t CacheMissConfig(std::uint64_t cache) {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+}
+
+/// Hardware events which explain time of phases of decoding: memory-bound or branch-bound
+constexpr std::array<PerfEventDescription, 6> hardwarePerfEvents{{
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"l1d_misses", PERF_TYPE_HW_CACHE, detail::CacheMissConfig(PERF_COUNT_HW_CACHE_L1D)},
+    {"llc_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {"dtlb_misses", PERF_TYPE_HW_CACHE, detail::CacheMissConfig(PERF_COUNT_HW_CACHE_DTLB)},
+    {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+}};
+#else
+constexpr std::array<PerfEventDescription, 6> hardwarePerfEvents{{
+    {"cycles", 0, 0}, {"instructions", 0, 0}, {"l1d_misses", 0, 0},
+    {"llc_misses", 0, 0}, {"dtlb_misses", 0, 0}, {"branch_misses", 0, 0},
+}};
+#endif
+
+
+/**
+ * Group of counters of the calling thread (user space only), all of them are read by one system call.
+ * Events which are not supported by the machine or not permitted (see perf_event_paranoid) are skipped,
+ * so the group may be empty, e.g. in virtual machines without PMU or on other systems than Linux.
+ * If the group does not fit into the PMU, the kernel multiplexes it and values are scaled
+ */
+class PerfEventGroup {
+    std::vector<int> descriptors;
+    /// Index of event in the description list for every opened descriptor
+    std::vector<std::size_t> opened;
+
+public:
+    explicit PerfEventGroup([[maybe_unused]] std::span<const PerfEventDescription> events) {
+#ifdef __linux__
+        for(std::size_t event = 0; event < events.size(); ++event) {
+            perf_event_attr attributes{};
+            attributes.size = sizeof(attributes);
+            attributes.type = events[event].type;
+            attributes.config = events[event].config;
+            attributes.disabled = descriptors.empty();
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            const int leader = descriptors.empty() ? -1 : descriptors.front();
+            const int descriptor = syscall(SYS_perf_event_open, &attributes, 0, -1, leader, 0);
+            if(descriptor >= 0) {
+                descriptors.push_back(descriptor);
+                opened.push_back(event);
+            }
+        }
+
+        if(!descriptors.empty()) {
+            ioctl(descriptors.front(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(descriptors.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    ~PerfEventGroup() {
+#ifdef __linux__
+        for(auto descriptor = descriptors.rbegin(); descriptor != descriptors.rend(); ++descriptor) {
+            close(*descriptor);
+        }
+#endif
+    }
+
+    PerfEventGroup(const PerfEventGroup&) = delete;
+    PerfEventGroup& operator=(const PerfEventGroup&) = delete;
+
+    bool IsCounted(std::size_t event) const {
+        return std::find(opened.begin(), opened.end(), event) != opened.end();
+    }
+
+    std::size_t NumberOfCounted() const {
+        return opened.size();
+    }
+
+    /**
+     * Values of events since the group was opened in order of descriptions, events which are not counted are zero
+     * @param values span of size of the description list
+     * @return false if the group is empty or it has not been scheduled on the PMU yet
+     */
+    bool Read(std::span<std::uint64_t> values) const {
+        std::fill(values.begin(), values.end(), 0);
+
+#ifdef __linux__
+        if(descriptors.empty()) {
+            return false;
+        }
+
+        // nr, time_enabled, time_running, value of every event
+        std::array<std::uint64_t, 3 + hardwarePerfEvents.size()> buffer{};
+        std::vector<std::uint64_t> largeBuffer;
+        std::uint64_t* data = buffer.data();
+        if(3 + opened.size() > buffer.size()) {
+            largeBuffer.resize(3 + opened.size());
+            data = largeBuffer.data();
+        }
+
+        const auto size = (3 + opened.size()) * sizeof(std::uint64_t);
+        if(read(descriptors.front(), data, size) != static_cast<ssize_t>(size) || data[2] == 0) {
+            return false;
+        }
+
+        const double scale = static_cast<double>(data[1]) / data[2];
+        for(std::size_t idx = 0; idx < opened.size() && idx < data[0]; ++idx) {
+            values[opened[idx]] = static_cast<std::uint64_t>(data[3 + idx] * scale);
+        }
+
+        return true;
+#else
+        return false;
+#endif
+    }
+};
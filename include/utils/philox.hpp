@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+
+/**
+ * Counter-based generator Philox4x32-10 (Salmon, Moraes, Dror, Shaw, "Parallel random numbers: as easy as 1, 2, 3").
+ * A block of four words is a pure function of 128-bit counter and 64-bit key, so the generator for
+ * (seed, stream) needs no state besides the position in the stream and any stream can be started at once
+ */
+class Philox4x32 {
+public:
+    using result_type = std::uint32_t;
+    using CounterType = std::array<std::uint32_t, 4>;
+    using KeyType = std::array<std::uint32_t, 2>;
+
+private:
+    static constexpr std::uint32_t multiplier0 = 0xD2511F53;
+    static constexpr std::uint32_t multiplier1 = 0xCD9E8D57;
+    static constexpr std::uint32_t weyl0 = 0x9E3779B9;
+    static constexpr std::uint32_t weyl1 = 0xBB67AE85;
+    static constexpr unsigned numberOfRounds = 10;
+
+    KeyType key;
+    CounterType counter;
+    CounterType block;
+    unsigned position = block.size();
+
+public:
+    static CounterType Block(CounterType counter, KeyType key) {
+        for(unsigned round = 0; round < numberOfRounds; ++round) {
+            const std::uint64_t product0 = static_cast<std::uint64_t>(multiplier0) * counter[0];
+            const std::uint64_t product1 = static_cast<std::uint64_t>(multiplier1) * counter[2];
+
+            counter = {static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0], static_cast<std::uint32_t>(product1),
+                       static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1], static_cast<std::uint32_t>(product0)};
+
+            key[0] += weyl0;
+            key[1] += weyl1;
+        }
+
+        return counter;
+    }
+
+    /**
+     * @param seed key of generator
+     * @param stream index of stream, streams of one seed do not overlap
+     */
+    Philox4x32(std::uint64_t seed, std::uint64_t stream)
+        : key{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)},
+          counter{0, 0, static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32)} {}
+
+    static constexpr result_type min() {
+        return 0;
+    }
+
+    static constexpr result_type max() {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()() {
+        if(position == block.size()) {
+            block = Block(counter, key);
+            position = 0;
+
+            // the lower half of counter is the index of block in the stream
+            if(++counter[0] == 0) {
+                ++counter[1];
+            }
+        }
+
+        return block[position++];
+    }
+};
+
+
+/**
+ * Uniform random number in [0, range) by Lemire's multiply-shift method,
+ * division is needed only for rare rejections
+ * @param generator generator of uniform 32-bit words
+ * @param range upper bound, should be positive
+ */
+template <typename GeneratorType>
+std::uint32_t BoundedRandom(GeneratorType& generator, std::uint32_t range) {
+    std::uint64_t product = static_cast<std::uint64_t>(generator()) * range;
+    auto low = static_cast<std::uint32_t>(product);
+
+    if(low < range) {
+        const std::uint32_t threshold = -range % range;
+        while(low < threshold) {
+            product = static_cast<std::uint64_t>(generator()) * range;
+            low = static_cast<std::uint32_t>(product);
+        }
+    }
+
+    return product >> 32;
+}
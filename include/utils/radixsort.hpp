@@ -6,6 +6,12 @@
 #include <iterator>
 #include <iostream>
 #include <functional>
+#include <memory>
+#include <bit>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
 
 
 using CollisionType = std::pair<boost::dynamic_bitset<>, std::vector<unsigned>>;
@@ -20,7 +26,8 @@ void Radixsort(IteratorType begin, IteratorType end, ArgumentType argument = Arg
 
     std::vector<ValueType> tempVec(end - begin);
 
-    for(int bitIdx = keyLength - 1; bitIdx >= 0; --bitIdx) {
+    // least significant digit first, bit 0 is the lowest bit of boost::dynamic_bitset
+    for(unsigned bitIdx = 0; bitIdx < keyLength; ++bitIdx) {
         std::array<long int, 2> count = {0, std::count_if(begin, end, [&argument, &bitIdx](auto& val){
                                 return argument(val)[bitIdx] == false;
                             })};
@@ -39,4 +46,53 @@ void Radixsort(IteratorType begin, IteratorType end, ArgumentType argument = Arg
             std::swap(*iter, tempVec[tempIdx++]);
         }
     }
+}
+
+
+/**
+ * LSD radix sort of elements by unsigned integral key, keys are processed by digits of radixBits bits
+ * and only digits below the highest set bit among all keys are passed
+ * @param begin, end range of elements
+ * @param key function which returns integral key of element
+ * @param allocator allocator of the buffer of the size of the range
+ */
+template <typename IteratorType, typename KeyFunction, unsigned radixBits = 11,
+          typename AllocatorType = std::allocator<typename IteratorType::value_type>>
+void RadixsortByKey(IteratorType begin, IteratorType end, KeyFunction key, const AllocatorType& allocator = AllocatorType()) {
+    using ValueType = IteratorType::value_type;
+    using KeyType = std::make_unsigned_t<std::decay_t<decltype(key(*begin))>>;
+
+    constexpr std::size_t numberOfBuckets = std::size_t(1) << radixBits;
+    constexpr KeyType digitMask = numberOfBuckets - 1;
+
+    const std::size_t n = end - begin;
+    if(n < 2) {
+        return;
+    }
+
+    KeyType allBits = 0;
+    for(auto iter = begin; iter != end; ++iter) {
+        allBits |= key(*iter);
+    }
+
+    std::vector<ValueType, AllocatorType> tempVec(n, allocator);
+    std::array<std::size_t, numberOfBuckets> count;
+
+    for(unsigned shift = 0; shift < static_cast<unsigned>(std::bit_width(allBits)); shift += radixBits) {
+        count.fill(0);
+        for(auto iter = begin; iter != end; ++iter) {
+            ++count[(key(*iter) >> shift) & digitMask];
+        }
+
+        std::size_t offset = 0;
+        for(auto& bucketSize: count) {
+            offset += std::exchange(bucketSize, offset);
+        }
+
+        for(auto iter = begin; iter != end; ++iter) {
+            tempVec[count[(key(*iter) >> shift) & digitMask]++] = std::move(*iter);
+        }
+
+        std::move(tempVec.begin(), tempVec.end(), begin);
+    }
 }
\ No newline at end of file
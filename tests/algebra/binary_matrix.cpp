@@ -3,7 +3,7 @@
 #include <algebra/binary_matrix.hpp>
 
 BOOST_AUTO_TEST_CASE(PermutationApplyingCheck1) {
-    BinaryMatrix matrix = BinaryMatrix({std::string("010"), std::string("110")}).applyPermutation({2, 3, 1});
+    BinaryMatrix matrix = BinaryMatrix({std::string("010"), std::string("110")}).applyPermutation({2, 0, 1});
     BinaryMatrix permutedMatrix({std::string("100"), std::string("101")});
 
     BOOST_CHECK(matrix == permutedMatrix);    
@@ -0,0 +1,93 @@
+#define BOOST_TEST_MODULE PackedMatrixModule
+#include <boost/test/included/unit_test.hpp>
+#include <algebra/binary_matrix.hpp>
+#include <algebra/packed_matrix.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+
+BinaryMatrix GenerateRandomMatrix(unsigned rows, unsigned cols) {
+    std::mt19937 gen(rows * cols);
+    std::bernoulli_distribution d(0.5);
+    BinaryMatrix matrix;
+
+    for(unsigned rowIdx = 0; rowIdx < rows; ++rowIdx) {
+        BinaryMatrix::BitContainerType row(cols);
+        for(unsigned colIdx = 0; colIdx < cols; ++colIdx) {
+            row[colIdx] = d(gen);
+        }
+        matrix.addRow(row);
+    }
+
+    return matrix;
+}
+
+BOOST_AUTO_TEST_CASE(PackingRows) {
+    BinaryMatrix matrix = GenerateRandomMatrix(5, 130);
+    PackedMatrix packed(matrix);
+
+    BOOST_CHECK_EQUAL(packed.RowsSize(), 5);
+    BOOST_CHECK_EQUAL(packed.ColumnsSize(), 130);
+    BOOST_CHECK_EQUAL(packed.WordsPerRow(), 3);
+
+    for(unsigned rowIdx = 0; rowIdx < matrix.RowsSize(); ++rowIdx) {
+        for(unsigned colIdx = 0; colIdx < matrix.ColumnsSize(); ++colIdx) {
+            BOOST_CHECK_EQUAL(packed.Get(rowIdx, colIdx), matrix[rowIdx][colIdx]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(TransposingPackedMatrix) {
+    for(auto [rows, cols]: {std::pair{3u, 5u}, {64u, 64u}, {70u, 129u}, {200u, 100u}}) {
+        BinaryMatrix matrix = GenerateRandomMatrix(rows, cols);
+
+        BOOST_CHECK(PackedMatrix(matrix).Transposed() == PackedMatrix(matrix.TransposeMatrix(0, rows)));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(WindowOfRow) {
+    BinaryMatrix matrix = GenerateRandomMatrix(2, 200);
+    PackedMatrix packed(matrix);
+
+    for(auto [start, length]: {std::pair{0u, 10u}, {60u, 10u}, {64u, 64u}, {100u, 64u}, {190u, 10u}}) {
+        auto window = packed.Window(1, start, length);
+
+        for(unsigned idx = 0; idx < length; ++idx) {
+            BOOST_CHECK_EQUAL((window >> idx) & 1, matrix[1][start + idx]);
+        }
+        BOOST_CHECK_EQUAL(length == 64 ? 0 : window >> length, 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ViewOfPaddedRows) {
+    BinaryMatrix matrix = GenerateRandomMatrix(3, 100);
+    PackedMatrix packed(matrix);
+
+    // rows are padded to 8 words, as in mapped files
+    auto words = std::make_shared<std::vector<PackedMatrix::WordType>>(3 * 8, ~PackedMatrix::WordType(0));
+    for(unsigned rowIdx = 0; rowIdx < 3; ++rowIdx) {
+        std::copy_n(packed.Row(rowIdx), packed.WordsPerRow(), words->data() + rowIdx * 8);
+    }
+
+    auto view = PackedMatrix::View(words->data(), 3, 100, 8, words);
+    BOOST_TEST(view.IsView());
+    BOOST_CHECK_EQUAL(view.Stride(), 8);
+    BOOST_TEST((view == packed));
+    BOOST_TEST((view.ToBinaryMatrix() == matrix));
+    BOOST_TEST((view.Transposed() == packed.Transposed()));
+
+    // copy owns its rows, so writes to it do not reach the viewed words
+    PackedMatrix copy = view;
+    BOOST_TEST(!copy.IsView());
+    copy.Row(0)[0] ^= 1;
+    BOOST_TEST(!(copy == view));
+    BOOST_TEST((view == packed));
+
+    // moved view still refers to the same words
+    const auto* first = view.Row(1);
+    PackedMatrix moved = std::move(view);
+    BOOST_CHECK_EQUAL(moved.Row(1), first);
+}
@@ -0,0 +1,87 @@
+#define BOOST_TEST_MODULE InstanceGenerator
+#include <boost/test/included/unit_test.hpp>
+#include <algebra/binary_matrix.hpp>
+#include <instances/instance_generator.hpp>
+#include <stern_attack/base_decoding.hpp>
+#include <stern_attack/stern_algorithm.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+
+BOOST_AUTO_TEST_CASE(InstanceHasPlantedError) {
+    const unsigned n = 200, k = 120, omega = 9;
+    const auto instance = GenerateInstance(n, k, omega, 7);
+
+    BOOST_CHECK_EQUAL(instance.checkMatrix.RowsSize(), n - k);
+    BOOST_CHECK_EQUAL(instance.checkMatrix.ColumnsSize(), n);
+    BOOST_CHECK_EQUAL(instance.errorVector.size(), n);
+    BOOST_CHECK_EQUAL(instance.errorVector.count(), omega);
+    BOOST_TEST(instance.checkMatrix.matVecMul(instance.errorVector) == instance.syndrome);
+
+    // systematic matrix is [I | Q]
+    for(unsigned rowIdx = 0; rowIdx < n - k; ++rowIdx) {
+        for(unsigned colIdx = 0; colIdx < n - k; ++colIdx) {
+            BOOST_TEST(instance.checkMatrix.getData()[rowIdx][colIdx] == (rowIdx == colIdx));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(InstanceIsDeterminedBySeed) {
+    const auto instance = GenerateInstance(300, 200, 10, 42);
+    const auto same = GenerateInstance(300, 200, 10, 42);
+    const auto other = GenerateInstance(300, 200, 10, 43);
+
+    BOOST_TEST((instance.checkMatrix == same.checkMatrix));
+    BOOST_TEST(instance.errorVector == same.errorVector);
+    BOOST_TEST(instance.syndrome == same.syndrome);
+    BOOST_TEST(!(instance.checkMatrix == other.checkMatrix));
+    BOOST_TEST(instance.errorVector != other.errorVector);
+
+    // matrix of a seed does not depend on weight of error, random matrix has the same Q
+    BOOST_TEST((GenerateInstance(300, 200, 20, 42).checkMatrix == instance.checkMatrix));
+    const auto random = GenerateCheckMatrix(300, 200, 42, false);
+    for(unsigned rowIdx = 0; rowIdx < 100; ++rowIdx) {
+        for(unsigned colIdx = 100; colIdx < 300; ++colIdx) {
+            BOOST_TEST(random.getData()[rowIdx][colIdx] == instance.checkMatrix.getData()[rowIdx][colIdx]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(WrongSizesAreRejected) {
+    BOOST_CHECK_THROW(GenerateCheckMatrix(100, 100, 1), std::invalid_argument);
+    BOOST_CHECK_THROW(GenerateErrorVector(100, 101, 1), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(SavedInstanceIsInTextFormat) {
+    const auto directory = std::filesystem::temp_directory_path() / "stern_attack_generated";
+    std::filesystem::remove_all(directory);
+
+    const auto instance = GenerateInstance(40, 13, 4, 3);
+    SaveInstance(instance, directory.string());
+
+    // the first character of line is bit 0, as in tests/test_data
+    std::ifstream matrix(directory / "check_matrix.txt");
+    BinaryMatrix loaded;
+    for(std::string line; std::getline(matrix, line);) {
+        std::reverse(line.begin(), line.end());
+        loaded.addRow(line);
+    }
+    BOOST_TEST((loaded == instance.checkMatrix));
+
+    std::string errorVector;
+    std::ifstream(directory / "error_vector.txt") >> errorVector;
+    std::reverse(errorVector.begin(), errorVector.end());
+    BOOST_TEST(boost::dynamic_bitset<>(errorVector) == instance.errorVector);
+
+    std::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_CASE(DecodingFindsPlantedError) {
+    auto instance = GenerateInstance(150, 75, 6, 5);
+    const SternAlgorithm stern(instance.checkMatrix.ColumnsSize());
+
+    BOOST_TEST(Decoding(instance.checkMatrix, instance.syndrome, 6, stern) == instance.errorVector);
+}
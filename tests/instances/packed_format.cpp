@@ -0,0 +1,183 @@
+#define BOOST_TEST_MODULE PackedFormat
+#include <boost/test/included/unit_test.hpp>
+#include <algebra/binary_matrix.hpp>
+#include <algebra/packed_matrix.hpp>
+#include <instances/instance_generator.hpp>
+#include <instances/packed_format.hpp>
+#include <instances/text_format.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#define STR(x) #x
+#define RETURN_STR_MACRO(x) STR(x)
+
+
+std::string TemporaryFile(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("stern_attack_" + name + ".bin")).string();
+}
+
+
+BOOST_AUTO_TEST_CASE(RoundTripOfRows) {
+    const auto instance = GenerateInstance(300, 180, 11, 5);
+    const auto file = TemporaryFile("rows");
+    SavePackedInstance(instance, file);
+
+    const auto packed = LoadPackedInstance(file);
+    BOOST_CHECK_EQUAL(packed.header.n, 300);
+    BOOST_CHECK_EQUAL(packed.header.k, 180);
+    BOOST_CHECK_EQUAL(packed.header.omega, 11);
+    BOOST_TEST((packed.header.layout == PackedLayout::Rows));
+
+    // rows are views of the mapping which begin at cache lines
+    BOOST_TEST(packed.matrix.IsView());
+    BOOST_CHECK_EQUAL(packed.matrix.Stride() % 8, 0);
+    for(unsigned rowIdx = 0; rowIdx < packed.matrix.RowsSize(); ++rowIdx) {
+        BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(packed.matrix.Row(rowIdx)) % 64, 0);
+    }
+
+    BOOST_TEST((packed.matrix == PackedMatrix(instance.checkMatrix)));
+    const auto loaded = packed.ToDecodingInstance();
+    BOOST_TEST((loaded.checkMatrix == instance.checkMatrix));
+    BOOST_TEST(loaded.syndrome == instance.syndrome);
+    BOOST_TEST(loaded.errorVector == instance.errorVector);
+    BOOST_TEST(!packed.systematicMatrix.has_value());
+
+    std::filesystem::remove(file);
+}
+
+BOOST_AUTO_TEST_CASE(RoundTripOfColumns) {
+    const auto instance = LoadInstance(RETURN_STR_MACRO(TEST_DATA) + std::string("/medium1/"));
+    const auto file = TemporaryFile("columns");
+    SavePackedInstance(instance, file, PackedWriteOptions{.layout = PackedLayout::Columns});
+
+    const auto packed = LoadPackedInstance(file);
+    BOOST_TEST((packed.header.layout == PackedLayout::Columns));
+    BOOST_CHECK_EQUAL(packed.matrix.RowsSize(), instance.checkMatrix.ColumnsSize());
+    BOOST_TEST((packed.matrix == PackedMatrix(instance.checkMatrix).Transposed()));
+    BOOST_TEST((packed.CheckMatrix() == instance.checkMatrix));
+    BOOST_TEST(packed.ToDecodingInstance().errorVector == instance.errorVector);
+
+    std::filesystem::remove(file);
+}
+
+BOOST_AUTO_TEST_CASE(SystematicForm) {
+    const auto file = TemporaryFile("systematic");
+
+    // the last n - k columns of random matrices are invertible for some seeds only
+    unsigned numberOfSystematic = 0;
+    for(std::uint64_t seed = 1; seed <= 8; ++seed) {
+        const auto instance = GenerateInstance(200, 100, 6, seed, false);
+        for(auto layout: {PackedLayout::Rows, PackedLayout::Columns}) {
+            SavePackedInstance(instance, file, PackedWriteOptions{.layout = layout, .withSystematicForm = true});
+            const auto packed = LoadPackedInstance(file);
+
+            BinaryMatrix systematicMatrix = instance.checkMatrix;
+            auto systematicSyndrome = instance.syndrome;
+            const bool isSystematic = BinaryMatrix::GaussElimination(systematicMatrix, systematicSyndrome);
+            BOOST_REQUIRE_EQUAL(packed.systematicMatrix.has_value(), isSystematic);
+            BOOST_REQUIRE_EQUAL(packed.systematicSyndrome.has_value(), isSystematic);
+            if(!isSystematic) {
+                continue;
+            }
+
+            ++numberOfSystematic;
+            const PackedMatrix rows(systematicMatrix);
+            BOOST_TEST((*packed.systematicMatrix == (layout == PackedLayout::Rows ? rows : rows.Transposed())));
+            BOOST_TEST(packed.systematicSyndrome->RowBits(0) == systematicSyndrome);
+            BOOST_TEST((packed.CheckMatrix() == instance.checkMatrix));
+
+            // columns of the systematic form in the layout of columns are the mapped words themselves
+            const auto columns = packed.SystematicColumns();
+            BOOST_TEST((*columns == rows.Transposed()));
+            BOOST_CHECK_EQUAL(columns->IsView(), layout == PackedLayout::Columns);
+            if(layout == PackedLayout::Columns) {
+                BOOST_TEST(columns->Row(0) == packed.systematicMatrix->Row(0));
+            }
+        }
+    }
+    BOOST_TEST(numberOfSystematic > 0);
+
+    std::filesystem::remove(file);
+}
+
+BOOST_AUTO_TEST_CASE(LoadInstanceOfPackedFile) {
+    const auto instance = GenerateInstance(300, 180, 11, 5);
+    const auto file = TemporaryFile("load");
+    SavePackedInstance(instance, file, PackedWriteOptions{.layout = PackedLayout::Columns});
+
+    const auto loaded = LoadInstance(file);
+    BOOST_TEST((loaded.checkMatrix == instance.checkMatrix));
+    BOOST_TEST(loaded.syndrome == instance.syndrome);
+    BOOST_TEST(loaded.errorVector == instance.errorVector);
+
+    std::filesystem::remove(file);
+}
+
+BOOST_AUTO_TEST_CASE(WritesToViewsDoNotReachFile) {
+    const auto instance = GenerateInstance(128, 64, 5, 3);
+    const auto file = TemporaryFile("private");
+    SavePackedInstance(instance, file);
+
+    {
+        auto packed = LoadPackedInstance(file);
+        packed.matrix.Row(0)[0] ^= 1;
+    }
+
+    BOOST_TEST((LoadPackedInstance(file).CheckMatrix() == instance.checkMatrix));
+    std::filesystem::remove(file);
+}
+
+BOOST_AUTO_TEST_CASE(InstanceWithoutErrorVector) {
+    auto instance = GenerateInstance(100, 50, 4, 9);
+    instance.errorVector.clear();
+    const auto file = TemporaryFile("omega");
+    SavePackedInstance(instance, file, PackedWriteOptions{.omega = 4});
+
+    const auto packed = LoadPackedInstance(file);
+    BOOST_CHECK_EQUAL(packed.header.omega, 4);
+    BOOST_TEST(!packed.errorVector.has_value());
+    BOOST_TEST(packed.ToDecodingInstance().errorVector.empty());
+
+    std::filesystem::remove(file);
+}
+
+BOOST_AUTO_TEST_CASE(InvalidFilesAreRejected) {
+    const auto instance = GenerateInstance(100, 50, 4, 9);
+    const auto file = TemporaryFile("invalid");
+    SavePackedInstance(instance, file);
+
+    // truncated file
+    std::filesystem::resize_file(file, std::filesystem::file_size(file) - 64);
+    BOOST_CHECK_THROW(LoadPackedInstance(file), std::runtime_error);
+
+    // unknown version
+    SavePackedInstance(instance, file);
+    {
+        std::fstream fs(file, std::ios::binary | std::ios::in | std::ios::out);
+        fs.seekp(8);
+        const std::uint32_t version = 99;
+        fs.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    }
+    BOOST_CHECK_THROW(LoadPackedInstance(file), std::runtime_error);
+
+    // stride which rows of the matrix wrap around 2^64 words, and stride shorter than a row
+    for(const std::uint64_t strideWords: {std::uint64_t(1) << 63, std::uint64_t(0)}) {
+        SavePackedInstance(instance, file);
+        {
+            std::fstream fs(file, std::ios::binary | std::ios::in | std::ios::out);
+            fs.seekp(offsetof(PackedHeader, strideWords));
+            fs.write(reinterpret_cast<const char*>(&strideWords), sizeof(strideWords));
+        }
+        BOOST_CHECK_THROW(LoadPackedInstance(file), std::runtime_error);
+    }
+
+    // text format
+    std::ofstream(file) << ToText(instance.syndrome) << '\n' << std::string(100, '0') << '\n';
+    BOOST_CHECK_THROW(LoadPackedInstance(file), std::runtime_error);
+
+    std::filesystem::remove(file);
+}
@@ -0,0 +1,101 @@
+#define BOOST_TEST_MODULE SystematicInstance
+#include <boost/test/included/unit_test.hpp>
+#include <algebra/binary_matrix.hpp>
+#include <algebra/systematic_matrix.hpp>
+#include <instances/instance_generator.hpp>
+#include <instances/systematic_instance.hpp>
+#include <instances/text_format.hpp>
+#include <permutations/random_permutation_iterator.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#define STR(x) #x
+#define RETURN_STR_MACRO(x) STR(x)
+
+
+std::string TemporaryDirectory(const std::string& name) {
+    auto directory = std::filesystem::temp_directory_path() / ("stern_attack_" + name);
+    std::filesystem::remove_all(directory);
+
+    return directory.string();
+}
+
+
+BOOST_AUTO_TEST_CASE(OnlyRedundantBlockIsStored) {
+    const auto instance = GenerateInstance(150, 90, 7, 2);
+    const auto systematic = SystematicMatrix::FromMatrix(instance.checkMatrix);
+    BOOST_REQUIRE(systematic.has_value());
+
+    BOOST_CHECK_EQUAL(systematic->RowsSize(), 60);
+    BOOST_CHECK_EQUAL(systematic->ColumnsSize(), 150);
+    BOOST_CHECK_EQUAL(systematic->Redundancy().RowsSize(), 60);
+    BOOST_CHECK_EQUAL(systematic->Redundancy().ColumnsSize(), 90);
+
+    BOOST_TEST((systematic->ToBinaryMatrix() == instance.checkMatrix));
+    BOOST_TEST(systematic->matVecMul(instance.errorVector) == instance.syndrome);
+    for(unsigned rowIdx = 0; rowIdx < 60; ++rowIdx) {
+        for(unsigned colIdx = 0; colIdx < 150; ++colIdx) {
+            BOOST_CHECK_EQUAL(systematic->Get(rowIdx, colIdx), instance.checkMatrix.getData()[rowIdx][colIdx]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(NonSystematicMatrixIsDetected) {
+    const auto instance = GenerateInstance(150, 90, 7, 2, false);
+    BOOST_TEST(!SystematicMatrix::FromMatrix(instance.checkMatrix).has_value());
+
+    // the identity block with one more bit
+    auto checkMatrix = GenerateInstance(150, 90, 7, 2).checkMatrix;
+    checkMatrix[3][10] = true;
+    BOOST_TEST(!SystematicMatrix::FromMatrix(checkMatrix).has_value());
+}
+
+BOOST_AUTO_TEST_CASE(PermutationIsAppliedWithoutIdentityBlock) {
+    const auto instance = GenerateInstance(130, 70, 5, 4);
+    const auto systematic = *SystematicMatrix::FromMatrix(instance.checkMatrix);
+
+    auto permutationIter = RandomPermutation(130).begin(3);
+    for(unsigned idx = 0; idx < 5; ++idx, ++permutationIter) {
+        BOOST_TEST((systematic.applyPermutation(*permutationIter) == instance.checkMatrix.applyPermutation(*permutationIter)));
+    }
+
+    // [Q | I] is its own gauss elimination, so the syndrome does not change
+    auto eliminated = systematic.applyPermutation(systematic.IdentityLastPermutation());
+    auto eliminatedCopy = eliminated;
+    auto syndrome = instance.syndrome;
+    BOOST_REQUIRE(BinaryMatrix::GaussElimination(eliminated, syndrome));
+    BOOST_TEST((eliminated == eliminatedCopy));
+    BOOST_TEST(syndrome == instance.syndrome);
+}
+
+BOOST_AUTO_TEST_CASE(LoadingOfSystematicText) {
+    const auto instance = GenerateInstance(140, 80, 6, 8);
+    const auto directory = TemporaryDirectory("systematic");
+    SaveInstance(instance, directory);
+
+    const auto loaded = LoadSystematicInstance(directory);
+    BOOST_REQUIRE(loaded.has_value());
+    BOOST_TEST((loaded->checkMatrix.ToBinaryMatrix() == instance.checkMatrix));
+    BOOST_TEST(loaded->syndrome == instance.syndrome);
+    BOOST_TEST(loaded->errorVector == instance.errorVector);
+
+    std::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_CASE(LoadingOfNonSystematicText) {
+    // test instances are random, they are loaded only when they are accepted as systematic
+    const std::string directory = RETURN_STR_MACRO(TEST_DATA) + std::string("/medium1/");
+    BOOST_TEST(!LoadSystematicInstance(directory).has_value());
+
+    const auto instance = LoadInstance(directory);
+    const auto accepted = LoadSystematicInstance(directory, true);
+    BOOST_REQUIRE(accepted.has_value());
+    const unsigned rows = instance.checkMatrix.RowsSize();
+    for(unsigned rowIdx = 0; rowIdx < rows; ++rowIdx) {
+        for(unsigned colIdx = rows; colIdx < instance.checkMatrix.ColumnsSize(); ++colIdx) {
+            BOOST_CHECK_EQUAL(accepted->checkMatrix.Get(rowIdx, colIdx), instance.checkMatrix.getData()[rowIdx][colIdx]);
+        }
+    }
+}
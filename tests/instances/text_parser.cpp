@@ -0,0 +1,123 @@
+#define BOOST_TEST_MODULE TextParser
+#include <boost/test/included/unit_test.hpp>
+#include <algebra/binary_matrix.hpp>
+#include <instances/text_format.hpp>
+#include <instances/text_parser.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#define STR(x) #x
+#define RETURN_STR_MACRO(x) STR(x)
+
+
+std::string WriteFile(const std::string& name, const std::string& content) {
+    const auto file = (std::filesystem::temp_directory_path() / ("stern_attack_" + name + ".txt")).string();
+    std::ofstream(file, std::ios::binary) << content;
+
+    return file;
+}
+
+std::string RandomLine(std::mt19937& gen, std::size_t length) {
+    std::string line(length, '0');
+    for(auto& c: line) {
+        c = gen() % 2 ? '1' : '0';
+    }
+
+    return line;
+}
+
+/// Lines of file as the text format defines them, parsed character by character
+std::vector<boost::dynamic_bitset<>> ParseByCharacters(const std::string& content) {
+    std::vector<boost::dynamic_bitset<>> lines;
+    boost::dynamic_bitset<> line;
+    for(const char c: content + '\n') {
+        if(c == '\n') {
+            if(!line.empty()) {
+                lines.push_back(line);
+            }
+            line.clear();
+        } else if(c != '\r') {
+            line.push_back(c == '1');
+        }
+    }
+
+    return lines;
+}
+
+void CheckReader(const std::string& name, const std::string& content) {
+    const auto file = WriteFile(name, content);
+    const auto expected = ParseByCharacters(content);
+
+    TextBitReader reader(file);
+    std::vector<TextBitReader::WordType> words;
+    for(const auto& line: expected) {
+        const auto bits = reader.NextLine(words);
+        BOOST_REQUIRE_EQUAL(bits, line.size());
+        BOOST_TEST(ToBitset(words, bits) == line);
+    }
+    BOOST_CHECK_EQUAL(reader.NextLine(words), 0);
+
+    std::filesystem::remove(file);
+}
+
+
+BOOST_AUTO_TEST_CASE(LinesOfAllLengths) {
+    std::mt19937 gen(1);
+    std::string content;
+    for(std::size_t length: {1, 2, 31, 32, 33, 63, 64, 65, 127, 128, 129, 200, 381, 1409}) {
+        content += RandomLine(gen, length) + '\n';
+    }
+
+    CheckReader("lengths", content);
+    // the last line without newline
+    CheckReader("no_newline", content + RandomLine(gen, 100));
+}
+
+BOOST_AUTO_TEST_CASE(CarriageReturnsAndEmptyLines) {
+    std::mt19937 gen(2);
+    const std::string content = RandomLine(gen, 70) + "\r\n\r\n\n" + RandomLine(gen, 70) + "\r\n" + RandomLine(gen, 5) + "\r";
+    CheckReader("crlf", content);
+}
+
+BOOST_AUTO_TEST_CASE(LinesAcrossBlocks) {
+    std::mt19937 gen(3);
+    for(std::size_t firstLength: {TextBitReader::blockSize - 1, TextBitReader::blockSize - 2, TextBitReader::blockSize - 37,
+                                  TextBitReader::blockSize + 5}) {
+        // "\r\n" and lines which continue from unaligned bits are split by the end of block
+        const std::string content = RandomLine(gen, firstLength) + "\r\n" + RandomLine(gen, 3 * TextBitReader::blockSize / 2) + "\r\n"
+                                  + RandomLine(gen, 1000) + '\n';
+        CheckReader("blocks", content);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(InvalidCharacter) {
+    const auto file = WriteFile("invalid", std::string(100, '0') + "\n" + std::string(70, '1') + "2" + "\n");
+
+    TextBitReader reader(file);
+    std::vector<TextBitReader::WordType> words;
+    BOOST_CHECK_EQUAL(reader.NextLine(words), 100);
+    BOOST_CHECK_THROW(reader.NextLine(words), std::runtime_error);
+
+    std::filesystem::remove(file);
+}
+
+BOOST_AUTO_TEST_CASE(InstanceIsReadAsBefore) {
+    // check matrices were read by std::getline, std::reverse and constructor of boost::dynamic_bitset from string
+    const std::string directory = RETURN_STR_MACRO(TEST_DATA) + std::string("/medium2/");
+    std::ifstream ifs(directory + "check_matrix.txt");
+    BinaryMatrix expected;
+    for(std::string line; std::getline(ifs, line);) {
+        std::reverse(line.begin(), line.end());
+        expected.addRow(line);
+    }
+
+    const auto instance = LoadInstance(directory);
+    BOOST_TEST((instance.checkMatrix == expected));
+    BOOST_CHECK_EQUAL(instance.syndrome.size(), expected.RowsSize());
+    BOOST_TEST(expected.matVecMul(instance.errorVector) == instance.syndrome);
+}
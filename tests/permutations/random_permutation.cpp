@@ -0,0 +1,90 @@
+#define BOOST_TEST_MODULE RandomPermutationModule
+#include <boost/test/included/unit_test.hpp>
+#include <permutations/random_permutation_iterator.hpp>
+#include <utils/philox.hpp>
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+
+BOOST_AUTO_TEST_CASE(PhiloxKnownAnswers) {
+    // known answers of the reference implementation Random123
+    using Counter = Philox4x32::CounterType;
+    BOOST_TEST((Philox4x32::Block({0, 0, 0, 0}, {0, 0}) == Counter{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    BOOST_TEST((Philox4x32::Block({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff})
+                == Counter{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+    BOOST_TEST((Philox4x32::Block({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0})
+                == Counter{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+}
+
+BOOST_AUTO_TEST_CASE(PhiloxStreams) {
+    Philox4x32 generator(381, 7), sameGenerator(381, 7), otherStream(381, 8);
+
+    std::vector<std::uint32_t> words, otherWords;
+    for(unsigned idx = 0; idx < 10; ++idx) {
+        words.push_back(generator());
+        otherWords.push_back(otherStream());
+        BOOST_CHECK_EQUAL(words.back(), sameGenerator());
+    }
+    BOOST_TEST(words != otherWords);
+
+    // the second block of the stream follows the first one
+    const auto secondBlock = Philox4x32::Block({1, 0, 7, 0}, {381, 0});
+    BOOST_TEST(std::equal(secondBlock.begin(), secondBlock.end(), words.begin() + 4));
+}
+
+BOOST_AUTO_TEST_CASE(BoundedRandomIsUniform) {
+    Philox4x32 generator(640, 0);
+    const unsigned range = 7, samples = 70000;
+
+    std::vector<unsigned> counts(range);
+    for(unsigned idx = 0; idx < samples; ++idx) {
+        const auto value = BoundedRandom(generator, range);
+        BOOST_REQUIRE(value < range);
+        ++counts[value];
+    }
+
+    for(const auto count: counts) {
+        BOOST_TEST(count > samples / range * 9 / 10);
+        BOOST_TEST(count < samples / range * 11 / 10);
+    }
+    BOOST_CHECK_EQUAL(BoundedRandom(generator, 1), 0);
+}
+
+BOOST_AUTO_TEST_CASE(PartialShuffleIsPrefixOfFullShuffle) {
+    RandomPermutation permutations(100);
+
+    const auto permutation = permutations.Get(1041, 3);
+    BOOST_TEST(std::is_permutation(permutation.begin(), permutation.end(), permutations.start_permutation.begin()));
+
+    for(std::size_t count: {0, 1, 40, 99, 100}) {
+        const auto partial = permutations.Get(1041, 3, count);
+        BOOST_TEST(std::is_permutation(partial.begin(), partial.end(), permutations.start_permutation.begin()));
+        BOOST_TEST(std::equal(partial.begin(), partial.begin() + count, permutation.begin()));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(IteratorsSplitStream) {
+    RandomPermutation permutations(50);
+    const unsigned numberOfStreams = 3;
+
+    std::set<std::vector<unsigned>> stridedPermutations;
+    for(unsigned streamIdx = 0; streamIdx < numberOfStreams; ++streamIdx) {
+        auto permutationIter = permutations.begin(1409, streamIdx, numberOfStreams);
+        for(unsigned step = 0; step < 4; ++step, ++permutationIter) {
+            const auto index = streamIdx + step * numberOfStreams;
+            BOOST_CHECK_EQUAL(permutationIter.Index(), index);
+            BOOST_TEST(*permutationIter == permutations.Get(1409, index));
+            stridedPermutations.insert(*permutationIter);
+        }
+    }
+
+    std::set<std::vector<unsigned>> consecutivePermutations;
+    auto permutationIter = permutations.begin(1409);
+    for(unsigned index = 0; index < numberOfStreams * 4; ++index, ++permutationIter) {
+        consecutivePermutations.insert(*permutationIter);
+    }
+
+    BOOST_TEST(stridedPermutations == consecutivePermutations);
+}
@@ -0,0 +1,93 @@
+#define BOOST_TEST_MODULE Checkpoint
+#define STERN_ATTACK_INSTRUMENTATION
+#include <boost/test/included/unit_test.hpp>
+#include <algebra/binary_matrix.hpp>
+#include <stern_attack/checkpoint.hpp>
+#include <stern_attack/stern_algorithm.hpp>
+#include <stern_attack/mmt_algorithm.hpp>
+#include "helper.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+
+std::string CheckpointFile(const std::string& name) {
+    auto file = std::filesystem::temp_directory_path() / ("stern_attack_" + name + ".checkpoint");
+    std::filesystem::remove(file);
+
+    return file.string();
+}
+
+BOOST_AUTO_TEST_CASE(SavingAndLoading) {
+    const auto file = CheckpointFile("saving");
+
+    DecodingCheckpoint checkpoint;
+    BOOST_TEST(!checkpoint.Load(file));
+
+    checkpoint.instance = 1;
+    checkpoint.seed = 0xFFFFFFFF00000001ull;
+    checkpoint.nextIndex = 381;
+    checkpoint.elapsedMilliseconds = 1000;
+    checkpoint.statistics["sum_of_lengths_l2"] = 640;
+    checkpoint.Save(file);
+
+    DecodingCheckpoint loaded;
+    BOOST_TEST(loaded.Load(file));
+    BOOST_CHECK_EQUAL(loaded.instance, checkpoint.instance);
+    BOOST_CHECK_EQUAL(loaded.seed, checkpoint.seed);
+    BOOST_CHECK_EQUAL(loaded.nextIndex, checkpoint.nextIndex);
+    BOOST_CHECK_EQUAL(loaded.elapsedMilliseconds, checkpoint.elapsedMilliseconds);
+    BOOST_TEST(loaded.statistics == checkpoint.statistics);
+
+    std::ofstream(file) << "seed 1\nnext_index x\n";
+    BOOST_TEST(!loaded.Load(file));
+    BOOST_CHECK_EQUAL(loaded.nextIndex, checkpoint.nextIndex);
+
+    std::filesystem::remove(file);
+}
+
+BOOST_AUTO_TEST_CASE(ResumingContinuesStream) {
+    const unsigned rows = 60, cols = 120, omega = 1;
+    auto [checkMatrix, syndrome] = GenerateInstanceWithoutSolution(rows, cols, 0, 1);
+    const auto file = CheckpointFile("resuming");
+
+    auto errorVector = DecodingWithCheckpoints(checkMatrix, syndrome, omega, MMTAlgorithm(cols, rows), file, std::chrono::hours(1), 3);
+    BOOST_TEST(errorVector.none());
+
+    DecodingCheckpoint first;
+    BOOST_REQUIRE(first.Load(file));
+    BOOST_CHECK_EQUAL(first.nextIndex, 3);
+    BOOST_CHECK_EQUAL(first.instance, DecodingCheckpoint::Fingerprint(checkMatrix, syndrome, omega));
+    BOOST_TEST(first.statistics.contains("count.lists"));
+
+    DecodingWithCheckpoints(checkMatrix, syndrome, omega, MMTAlgorithm(cols, rows), file, std::chrono::milliseconds(0), 2);
+
+    DecodingCheckpoint second;
+    BOOST_REQUIRE(second.Load(file));
+    BOOST_CHECK_EQUAL(second.seed, first.seed);
+    BOOST_CHECK_EQUAL(second.nextIndex, 5);
+    // statistics are accumulated over both runs, elimination of some iterations may fail
+    BOOST_TEST(second.statistics["count.lists"] >= first.statistics["count.lists"]);
+    BOOST_TEST(second.statistics["count.lists"] <= first.statistics["count.lists"] + 2 * 2);
+    BOOST_TEST(second.statistics["time_ns.elimination"] > first.statistics["time_ns.elimination"]);
+
+    // checkpoint of another instance is ignored
+    auto [otherCheckMatrix, otherSyndrome] = GenerateInstanceWithoutSolution(rows, cols, 2, 3);
+    DecodingWithCheckpoints(otherCheckMatrix, otherSyndrome, omega, SternAlgorithm(cols), file, std::chrono::hours(1), 1);
+    DecodingCheckpoint other;
+    BOOST_REQUIRE(other.Load(file));
+    BOOST_CHECK_EQUAL(other.nextIndex, 1);
+    BOOST_TEST(other.seed != first.seed);
+
+    std::filesystem::remove(file);
+}
+
+BOOST_AUTO_TEST_CASE(CheckpointIsRemovedOnSuccess) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium1/");
+    const unsigned cols = checkMatrix.ColumnsSize(), omega = errorVector.count();
+    const auto file = CheckpointFile("success");
+
+    BOOST_TEST(errorVector == DecodingWithCheckpoints(checkMatrix, syndrome, omega, SternAlgorithm(cols), file, std::chrono::milliseconds(0)));
+    BOOST_TEST(!std::filesystem::exists(file));
+}
@@ -0,0 +1,98 @@
+#define BOOST_TEST_MODULE DecodingPool
+#include <boost/test/included/unit_test.hpp>
+#include <algebra/binary_matrix.hpp>
+#include <stern_attack/decoding_pool.hpp>
+#include <stern_attack/stern_algorithm.hpp>
+#include <stern_attack/hash_mmt_algorithm.hpp>
+#include <stern_attack/information_set_decoding.hpp>
+#include "helper.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+
+
+BOOST_AUTO_TEST_CASE(EveryThreadRunsTask) {
+    DecodingPool pool(5);
+    BOOST_CHECK_EQUAL(pool.NumberOfThreads(), 5);
+    BOOST_TEST(pool.NumberOfNodes() >= 1);
+
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium1/");
+
+    for(int call = 0; call < 3; ++call) {
+        std::mutex mx;
+        std::set<unsigned> threadIndexes;
+        std::atomic<unsigned> numberOfEqualReplicas = 0;
+
+        pool.Run(checkMatrix, syndrome, [&](const BinaryMatrix& replicaOfMatrix, const boost::dynamic_bitset<>& replicaOfSyndrome, unsigned threadIdx) {
+            if(replicaOfMatrix == checkMatrix && replicaOfSyndrome == syndrome) {
+                ++numberOfEqualReplicas;
+            }
+
+            std::lock_guard lock(mx);
+            threadIndexes.insert(threadIdx);
+        });
+
+        BOOST_CHECK_EQUAL(numberOfEqualReplicas, 5);
+        BOOST_CHECK(threadIndexes == (std::set<unsigned>{0, 1, 2, 3, 4}));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ThreadsRunAtOnce) {
+    DecodingPool pool(6, false);
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium1/");
+
+    // every task waits for all others, so the test hangs if some of threads are not run concurrently
+    std::atomic<unsigned> numberOfArrived = 0;
+    std::atomic<unsigned> numberOfMet = 0;
+    pool.Run(checkMatrix, syndrome, [&](const BinaryMatrix&, const boost::dynamic_bitset<>&, unsigned) {
+        ++numberOfArrived;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        while(numberOfArrived < 6 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        numberOfMet += numberOfArrived == 6;
+    });
+
+    BOOST_CHECK_EQUAL(numberOfMet, 6);
+}
+
+BOOST_AUTO_TEST_CASE(ReplicasAreKeptBetweenCalls) {
+    DecodingPool pool(4, false);
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium1/");
+    auto [otherMatrix, otherSyndrome, otherErrorVector] = ReadInstance("medium2/");
+
+    auto replicas = [&pool](const BinaryMatrix& checkMatrix, const boost::dynamic_bitset<>& syndrome) {
+        std::mutex mx;
+        std::set<const BinaryMatrix*> addresses;
+        pool.Run(checkMatrix, syndrome, [&](const BinaryMatrix& replicaOfMatrix, const boost::dynamic_bitset<>& replicaOfSyndrome, unsigned) {
+            BOOST_CHECK(replicaOfMatrix == checkMatrix && replicaOfSyndrome == syndrome);
+            std::lock_guard lock(mx);
+            addresses.insert(&replicaOfMatrix);
+        });
+
+        return addresses;
+    };
+
+    const auto first = replicas(checkMatrix, syndrome);
+    BOOST_CHECK_EQUAL(first.size(), pool.NumberOfNodes());
+    BOOST_CHECK(replicas(checkMatrix, syndrome) == first);
+    BOOST_CHECK(replicas(otherMatrix, otherSyndrome) == first);
+    BOOST_CHECK(replicas(checkMatrix, syndrome) == first);
+}
+
+BOOST_AUTO_TEST_CASE(PoolIsReusedByDecoding) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium1/");
+    const unsigned cols = checkMatrix.ColumnsSize(), omega = errorVector.count();
+
+    for(bool pinThreads: {false, true}) {
+        DecodingPool pool(4, pinThreads);
+
+        for(int call = 0; call < 3; ++call) {
+            BOOST_TEST(errorVector == DecodingParallel(checkMatrix, syndrome, omega, SternAlgorithm(cols), pool));
+            BOOST_TEST(errorVector == DecodingParallel(checkMatrix, syndrome, omega, InformationSetDecoding(cols), pool));
+        }
+    }
+}
@@ -0,0 +1,139 @@
+#define BOOST_TEST_MODULE DecodingScheduler
+#include <boost/test/included/unit_test.hpp>
+#include <algebra/binary_matrix.hpp>
+#include <stern_attack/decoding_scheduler.hpp>
+#include <stern_attack/stern_algorithm.hpp>
+#include <stern_attack/hash_mmt_algorithm.hpp>
+#include "helper.hpp"
+
+#include <chrono>
+#include <thread>
+
+
+BOOST_AUTO_TEST_CASE(JobsShareCheckMatrix) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium1/");
+    auto [otherCheckMatrix, otherSyndrome, otherErrorVector] = ReadInstance("medium2/");
+    const unsigned cols = checkMatrix.ColumnsSize(), rows = checkMatrix.RowsSize(), omega = errorVector.count();
+
+    // the second job of the first matrix has the error vector moved by one position
+    boost::dynamic_bitset<> shiftedErrorVector = (errorVector << 1) | (errorVector >> (cols - 1));
+    const auto shiftedSyndrome = checkMatrix.matVecMul(shiftedErrorVector);
+
+    DecodingScheduler scheduler(3);
+    const auto first = scheduler.Submit(checkMatrix, syndrome, omega, SternAlgorithm(cols));
+    const auto shifted = scheduler.Submit(checkMatrix, shiftedSyndrome, omega, MMTHashAlgorithm(cols, rows), DecodingJobOptions{2});
+    const auto other = scheduler.Submit(otherCheckMatrix, otherSyndrome, otherErrorVector.count(), SternAlgorithm(otherCheckMatrix.ColumnsSize()));
+
+    BOOST_CHECK_EQUAL(scheduler.NumberOfJobs(), 3);
+    BOOST_CHECK_EQUAL(scheduler.NumberOfMatrices(), 2);
+
+    scheduler.Run();
+
+    const auto firstReport = scheduler.Report(first);
+    BOOST_TEST((firstReport.status == DecodingJobStatus::Solved));
+    BOOST_TEST(firstReport.errorVector == errorVector);
+    BOOST_TEST(firstReport.numberOfIterations > 0);
+
+    const auto shiftedReport = scheduler.Report(shifted);
+    BOOST_TEST((shiftedReport.status == DecodingJobStatus::Solved));
+    BOOST_CHECK_EQUAL(shiftedReport.errorVector.count(), omega);
+    BOOST_TEST(checkMatrix.matVecMul(shiftedReport.errorVector) == shiftedSyndrome);
+    BOOST_CHECK_EQUAL(shiftedReport.algorithmName, "MMTHash");
+
+    const auto otherReport = scheduler.Report(other);
+    BOOST_TEST((otherReport.status == DecodingJobStatus::Solved));
+    BOOST_TEST(otherReport.errorVector == otherErrorVector);
+}
+
+BOOST_AUTO_TEST_CASE(JobsExpireAfterDeadline) {
+    const unsigned omega = 1;
+    auto [checkMatrix, syndrome] = GenerateInstanceWithoutSolution(60, 120, 0, 1);
+    auto [smallCheckMatrix, smallSyndrome] = GenerateInstanceWithoutSolution(40, 80, 0, 1);
+
+    const auto deadline = DecodingScheduler::Clock::now() + std::chrono::milliseconds(500);
+    DecodingScheduler scheduler(2);
+    const auto low = scheduler.Submit(checkMatrix, syndrome, omega, SternAlgorithm(120), DecodingJobOptions{1, deadline, 1000});
+    const auto high = scheduler.Submit(smallCheckMatrix, smallSyndrome, omega, SternAlgorithm(80), DecodingJobOptions{4, deadline, 1000});
+
+    std::thread runner([&scheduler]() {
+        scheduler.Run();
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    const auto running = scheduler.Report(low);
+    BOOST_TEST((running.status == DecodingJobStatus::Active));
+    BOOST_TEST(running.iterationsPerSecond > 0);
+    BOOST_REQUIRE(running.etaSeconds.has_value());
+    BOOST_TEST(*running.etaSeconds > 0);
+
+    runner.join();
+    BOOST_TEST((DecodingScheduler::Clock::now() >= deadline));
+
+    for(const auto jobId: {low, high}) {
+        const auto report = scheduler.Report(jobId);
+        BOOST_TEST((report.status == DecodingJobStatus::Expired));
+        BOOST_TEST(report.errorVector.none());
+        BOOST_TEST(!report.etaSeconds.has_value());
+    }
+
+    // the job with higher priority and smaller matrix makes much more iterations
+    BOOST_TEST(scheduler.Report(high).numberOfIterations > 2 * scheduler.Report(low).numberOfIterations);
+}
+
+BOOST_AUTO_TEST_CASE(JobsAreSubmittedWhileRunning) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium1/");
+    auto [unsolvable, unsolvableSyndrome] = GenerateInstanceWithoutSolution(40, 80, 0, 1);
+
+    // the job without solution keeps threads busy until its deadline, jobs pushed meanwhile are decoded too
+    const auto deadline = DecodingScheduler::Clock::now() + std::chrono::milliseconds(1500);
+    DecodingScheduler scheduler(3);
+    scheduler.Submit(unsolvable, unsolvableSyndrome, 1, SternAlgorithm(80), DecodingJobOptions{1, deadline});
+
+    std::thread runner([&scheduler]() {
+        scheduler.Run();
+    });
+
+    std::vector<DecodingScheduler::JobId> submitted;
+    for(unsigned idx = 0; idx < 20; ++idx) {
+        submitted.push_back(scheduler.Submit(checkMatrix, syndrome, errorVector.count(), SternAlgorithm(checkMatrix.ColumnsSize()),
+                                             DecodingJobOptions{1, deadline}));
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    runner.join();
+
+    for(const auto jobId: submitted) {
+        const auto report = scheduler.Report(jobId);
+        BOOST_TEST((report.status == DecodingJobStatus::Solved));
+        BOOST_TEST(report.errorVector == errorVector);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(RateOfLateJobIsMeasuredFromItsStart) {
+    // both syndromes have no solution of weight 1 and the same check matrix, so every iteration serves
+    // both jobs after the late one is submitted
+    auto [checkMatrix, earlySyndrome] = GenerateInstanceWithoutSolution(40, 80, 0, 1);
+    auto [sameCheckMatrix, lateSyndrome] = GenerateInstanceWithoutSolution(40, 80, 2, 3);
+    BOOST_REQUIRE((checkMatrix == sameCheckMatrix));
+
+    const auto deadline = DecodingScheduler::Clock::now() + std::chrono::milliseconds(1600);
+    DecodingScheduler scheduler(2);
+    const auto early = scheduler.Submit(checkMatrix, earlySyndrome, 1, SternAlgorithm(80), DecodingJobOptions{1, deadline});
+
+    std::thread runner([&scheduler]() {
+        scheduler.Run();
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1200));
+    const auto late = scheduler.Submit(checkMatrix, lateSyndrome, 1, SternAlgorithm(80), DecodingJobOptions{1, deadline});
+    runner.join();
+
+    const auto earlyReport = scheduler.Report(early);
+    const auto lateReport = scheduler.Report(late);
+    BOOST_TEST((lateReport.status == DecodingJobStatus::Expired));
+    BOOST_TEST(lateReport.numberOfIterations > 0);
+
+    // the late job existed for a quarter of the run, its rate would be a quarter of the early one from the start of Run
+    const double ratio = lateReport.iterationsPerSecond / earlyReport.iterationsPerSecond;
+    BOOST_TEST(ratio > 0.5);
+    BOOST_TEST(ratio < 2.0);
+}
@@ -0,0 +1,78 @@
+#define BOOST_TEST_MODULE DistributedDecoding
+#include <boost/test/included/unit_test.hpp>
+#include <algebra/binary_matrix.hpp>
+#include <stern_attack/distributed_decoding.hpp>
+#include <stern_attack/stern_algorithm.hpp>
+#include <stern_attack/information_set_decoding.hpp>
+#include "helper.hpp"
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+
+BOOST_AUTO_TEST_CASE(PermutationsAreDeterminedBySeedAndIndex) {
+    RandomPermutation permutations(100);
+
+    BOOST_TEST(permutations.Get(381, 7) == permutations.Get(381, 7));
+
+    std::set<std::vector<unsigned>> differentPermutations;
+    for(unsigned index = 0; index < 100; ++index) {
+        auto permutation = permutations.Get(381, index);
+        BOOST_TEST(std::is_permutation(permutation.begin(), permutation.end(), permutations.start_permutation.begin()));
+        differentPermutations.insert(permutation);
+    }
+    differentPermutations.insert(permutations.Get(382, 0));
+
+    BOOST_CHECK_EQUAL(differentPermutations.size(), 101);
+}
+
+BOOST_AUTO_TEST_CASE(WorkersOnLoopback) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium1/");
+    const unsigned cols = checkMatrix.ColumnsSize(), omega = errorVector.count();
+
+    DecodingCoordinator coordinator(checkMatrix, syndrome, omega, 0, 4);
+    const auto port = coordinator.Port();
+
+    boost::dynamic_bitset<> found;
+    std::thread coordinatorThread([&]() {
+        found = coordinator.Run();
+    });
+
+    // a broken worker which reports a wrong error vector
+    {
+        boost::asio::io_context io;
+        boost::asio::ip::tcp::socket socket(io);
+        socket.connect(boost::asio::ip::tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), port));
+
+        boost::dynamic_bitset<> wrongErrorVector(cols);
+        wrongErrorVector.set(0, omega, true);
+        std::string bits;
+        boost::to_string(wrongErrorVector, bits);
+        boost::asio::write(socket, boost::asio::buffer("FOUND " + bits + '\n'));
+    }
+
+    std::atomic<std::uint64_t> iterationsOfWorkers = 0;
+    std::vector<std::thread> workers;
+    for(int workerIdx = 0; workerIdx < 3; ++workerIdx) {
+        workers.emplace_back([&, workerIdx]() {
+            if(workerIdx % 2 == 0) {
+                iterationsOfWorkers += DecodingWorker("127.0.0.1", port, checkMatrix, syndrome, omega, SternAlgorithm(cols));
+            } else {
+                iterationsOfWorkers += DecodingWorker("127.0.0.1", port, checkMatrix, syndrome, omega, InformationSetDecoding(cols));
+            }
+        });
+    }
+
+    for(auto& worker: workers) {
+        worker.join();
+    }
+    coordinatorThread.join();
+
+    BOOST_TEST(found == errorVector);
+    BOOST_TEST(coordinator.NumberOfWorkers() >= 1);
+    BOOST_TEST(iterationsOfWorkers > 0);
+    BOOST_TEST(iterationsOfWorkers <= coordinator.NumberOfAssignedIterations());
+    BOOST_TEST(coordinator.NumberOfIterations() == iterationsOfWorkers);
+}
@@ -1,5 +1,11 @@
 #include <boost/test/included/unit_test.hpp>
+#include <boost/dynamic_bitset.hpp>
+#include <algebra/binary_matrix.hpp>
+#include <instances/text_format.hpp>
+#include <algorithm>
+#include <random>
 #include <string>
+#include <tuple>
 #include <vector>
 #include <filesystem>
 
@@ -21,3 +27,46 @@ std::vector<std::string> ReadLinesFromFile(const std::string& file) {
 
     return lines;
 }
+
+/**
+ * Reads check matrix, syndrome and error vector of the test instance
+ * @param directory directory of instance in test data, e.g. "medium1/"
+ */
+std::tuple<BinaryMatrix, boost::dynamic_bitset<>, boost::dynamic_bitset<>> ReadInstance(const std::string& directory) {
+    const std::string instanceDirectory = RETURN_STR_MACRO(TEST_DATA) + std::string("/") + directory;
+    BOOST_TEST(std::filesystem::exists(instanceDirectory + "error_vector.txt"));
+
+    auto instance = LoadInstance(instanceDirectory);
+    return std::make_tuple(std::move(instance.checkMatrix), std::move(instance.syndrome), std::move(instance.errorVector));
+}
+
+/**
+ * Random check matrix with syndrome which is a sum of two columns but not a column itself,
+ * so there is no error vector of weight 1
+ * @param firstCol, secondCol columns which sum is the syndrome
+ */
+std::pair<BinaryMatrix, boost::dynamic_bitset<>> GenerateInstanceWithoutSolution(unsigned rows, unsigned cols, unsigned firstCol, unsigned secondCol) {
+    std::mt19937 gen(33);
+    std::bernoulli_distribution d(0.5);
+
+    BinaryMatrix checkMatrix;
+    for(unsigned rowIdx = 0; rowIdx < rows; ++rowIdx) {
+        BinaryMatrix::BitContainerType row(cols);
+        for(unsigned colIdx = 0; colIdx < cols; ++colIdx) {
+            row[colIdx] = d(gen);
+        }
+        checkMatrix.addRow(row);
+    }
+
+    boost::dynamic_bitset<> twoErrors(cols);
+    twoErrors.set(firstCol).set(secondCol);
+    auto syndrome = checkMatrix.matVecMul(twoErrors);
+
+    for(unsigned colIdx = 0; colIdx < cols; ++colIdx) {
+        boost::dynamic_bitset<> oneError(cols);
+        oneError.set(colIdx);
+        BOOST_REQUIRE(checkMatrix.matVecMul(oneError) != syndrome);
+    }
+
+    return std::make_pair(checkMatrix, syndrome);
+}
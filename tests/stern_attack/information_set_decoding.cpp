@@ -160,7 +160,7 @@ BOOST_AUTO_TEST_CASE(InformationSetDecodingBig) {
 
         auto mmtHash = MMTHashAlgorithm(checkMatrix.ColumnsSize(), checkMatrix.RowsSize());
         boost::dynamic_bitset<> errorVectorFromMMTHash = launchAndBenchmark(mmtHash);
-        mmt.sizes();
+        std::cout << "Expected length of list: " << mmt.ExpectedLengthOfList() << '\n' << Instrumentation::Collect();
 
         auto mmtp = MMTAlgorithm(checkMatrix.ColumnsSize(), checkMatrix.RowsSize());
         boost::dynamic_bitset<> errorVectorFromMMTParallel = launchAndBenchmarkParallel(mmtp);
@@ -0,0 +1,118 @@
+#define BOOST_TEST_MODULE Instrumentation
+#define STERN_ATTACK_INSTRUMENTATION
+#include <boost/test/included/unit_test.hpp>
+#include <algebra/binary_matrix.hpp>
+#include <stern_attack/base_decoding.hpp>
+#include <stern_attack/instrumentation.hpp>
+#include <stern_attack/stern_algorithm.hpp>
+#include <stern_attack/new_stern_algorithm.hpp>
+#include <stern_attack/fs-isd_algorithm.hpp>
+#include <stern_attack/mmt_algorithm.hpp>
+#include <stern_attack/hash_mmt_algorithm.hpp>
+#include <stern_attack/information_set_decoding.hpp>
+#include "helper.hpp"
+
+#include <map>
+#include <thread>
+#include <tuple>
+
+
+static_assert(Instrumentation::enabled);
+
+
+template <typename DecodingStepAlgorithm>
+InstrumentationReport MeasureSteps(const DecodingStepAlgorithm& algorithm, const BinaryMatrix& checkMatrix,
+                                   const boost::dynamic_bitset<>& syndrome, unsigned omega, unsigned numberOfSteps) {
+    const auto before = Instrumentation::Collect();
+
+    auto permutationIter = RandomPermutation(checkMatrix.ColumnsSize()).begin(1, 0);
+    for(unsigned step = 0; step < numberOfSteps; ++step, ++permutationIter) {
+        BinaryMatrix permutedCheckMatrix = checkMatrix.applyPermutation(*permutationIter);
+        algorithm(permutedCheckMatrix, syndrome, omega);
+    }
+
+    return Instrumentation::Collect() - before;
+}
+
+BOOST_AUTO_TEST_CASE(ReportIsSavedAndLoaded) {
+    InstrumentationReport report;
+    report.nanoseconds[static_cast<unsigned>(DecodingPhase::Matching)] = 381;
+    report.counters[static_cast<unsigned>(DecodingCounter::Collisions)] = 640;
+
+    std::map<std::string, std::uint64_t> statistics;
+    report.Save(statistics);
+    BOOST_CHECK_EQUAL(statistics["time_ns.matching"], 381);
+    BOOST_CHECK_EQUAL(statistics["count.collisions"], 640);
+
+    const auto loaded = InstrumentationReport::Load(statistics);
+    BOOST_TEST(loaded.nanoseconds == report.nanoseconds);
+    BOOST_TEST(loaded.counters == report.counters);
+
+    BOOST_CHECK_EQUAL((loaded + report - report).Count(DecodingCounter::Collisions), 640);
+    BOOST_CHECK_EQUAL(InstrumentationReport::Load({}).Count(DecodingCounter::Collisions), 0);
+}
+
+BOOST_AUTO_TEST_CASE(NestedPhasesAreExclusive) {
+    const auto before = Instrumentation::Collect();
+    {
+        const Instrumentation::PhaseTimer matching(DecodingPhase::Matching);
+        const Instrumentation::PhaseTimer verification(DecodingPhase::Verification);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    const auto report = Instrumentation::Collect() - before;
+
+    BOOST_TEST(report.Seconds(DecodingPhase::Verification) >= 0.02);
+    BOOST_TEST(report.Seconds(DecodingPhase::Matching) < 0.01);
+}
+
+BOOST_AUTO_TEST_CASE(AllAlgorithmsAreInstrumented) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium1/");
+    const unsigned rows = checkMatrix.RowsSize(), cols = checkMatrix.ColumnsSize(), omega = errorVector.count();
+
+    const auto checkListAlgorithm = [&](const auto& algorithm) {
+        const auto report = MeasureSteps(algorithm, checkMatrix, syndrome, omega, 20);
+        BOOST_TEST_CONTEXT(algorithm.algorithmName) {
+            BOOST_TEST(report.Seconds(DecodingPhase::Elimination) > 0);
+            BOOST_TEST(report.Seconds(DecodingPhase::ListConstruction) > 0);
+            BOOST_TEST(report.Seconds(DecodingPhase::SortHash) > 0);
+            BOOST_TEST(report.Count(DecodingCounter::Lists) > 0);
+            BOOST_TEST(report.Count(DecodingCounter::Lists) % 2 == 0);
+            BOOST_TEST(report.Count(DecodingCounter::ListEntries) > 0);
+            // every collision is verified once, matching stops on the first found error vector
+            BOOST_TEST(report.Count(DecodingCounter::CandidateChecks) == report.Count(DecodingCounter::Collisions));
+            BOOST_TEST(report.Count(DecodingCounter::EarlyAborts) <= report.Count(DecodingCounter::CandidateChecks));
+        }
+    };
+
+    checkListAlgorithm(SternAlgorithm(cols));
+    checkListAlgorithm(NewSternAlgorithm(cols));
+    checkListAlgorithm(FS_ISD_Algorithm(cols));
+    checkListAlgorithm(MMTAlgorithm(cols, rows));
+    checkListAlgorithm(MMTHashAlgorithm(cols, rows));
+
+    const auto report = MeasureSteps(InformationSetDecoding(cols), checkMatrix, syndrome, omega, 20);
+    BOOST_TEST(report.Seconds(DecodingPhase::Elimination) > 0);
+    BOOST_TEST(report.Count(DecodingCounter::CandidateChecks) > 0);
+    BOOST_CHECK_EQUAL(report.Count(DecodingCounter::Lists), 0);
+}
+
+BOOST_AUTO_TEST_CASE(RecordsOfThreadsAreMerged) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium1/");
+    const unsigned cols = checkMatrix.ColumnsSize(), omega = errorVector.count();
+    const SternAlgorithm stern(cols);
+
+    const auto single = MeasureSteps(stern, checkMatrix, syndrome, omega, 12);
+    BOOST_REQUIRE(single.Count(DecodingCounter::Lists) > 0);
+
+    const auto before = Instrumentation::Collect();
+    std::thread first([&]() { MeasureSteps(stern, checkMatrix, syndrome, omega, 12); });
+    std::thread second([&]() { MeasureSteps(stern, checkMatrix, syndrome, omega, 12); });
+    first.join();
+    second.join();
+    const auto merged = Instrumentation::Collect() - before;
+
+    // both threads make the same steps as the single run, records of finished threads are kept
+    BOOST_CHECK_EQUAL(merged.Count(DecodingCounter::Lists), 2 * single.Count(DecodingCounter::Lists));
+    BOOST_CHECK_EQUAL(merged.Count(DecodingCounter::ListEntries), 2 * single.Count(DecodingCounter::ListEntries));
+    BOOST_CHECK_EQUAL(merged.Count(DecodingCounter::Collisions), 2 * single.Count(DecodingCounter::Collisions));
+}
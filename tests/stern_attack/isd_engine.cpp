@@ -0,0 +1,352 @@
+#define BOOST_TEST_MODULE ISDEngine
+#include <boost/test/included/unit_test.hpp>
+#include <algebra/binary_matrix.hpp>
+#include <algebra/packed_matrix.hpp>
+#include <instances/instance_generator.hpp>
+#include <stern_attack/isd_engine.hpp>
+#include <stern_attack/list_matching.hpp>
+#include <stern_attack/stern_algorithm.hpp>
+#include <stern_attack/new_stern_algorithm.hpp>
+#include <stern_attack/fs-isd_algorithm.hpp>
+#include <stern_attack/mmt_algorithm.hpp>
+#include <stern_attack/hash_mmt_algorithm.hpp>
+#include <stern_attack/ball_collision_algorithm.hpp>
+#include <stern_attack/information_set_decoding.hpp>
+#include "helper.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+
+static_assert(DecodingPolicy<SternPolicy>);
+static_assert(DecodingPolicy<NewSternPolicy>);
+static_assert(DecodingPolicy<FS_ISD_Policy>);
+static_assert(DecodingPolicy<MMTPolicy>);
+static_assert(DecodingPolicy<MMTHashPolicy>);
+static_assert(DecodingPolicy<BallCollisionPolicy>);
+static_assert(!Matcher<SortMergeMatcher, HashedList, UnorderedList>);
+static_assert(!Matcher<HashJoinMatcher, SortedList, SortedList>);
+
+
+template <typename LeftStoreType, typename RightStoreType, typename MatcherType>
+std::set<std::pair<unsigned, unsigned>> FindCollisions(const std::vector<KeyType>& leftKeys, const std::vector<KeyType>& rightKeys) {
+    LeftStoreType left;
+    RightStoreType right;
+
+    for(unsigned idx = 0; idx < leftKeys.size(); ++idx) {
+        left.Add(leftKeys[idx], std::vector<unsigned>{idx});
+    }
+    for(unsigned idx = 0; idx < rightKeys.size(); ++idx) {
+        right.Add(rightKeys[idx], std::vector<unsigned>{idx, idx});
+    }
+
+    left.Finalize();
+    right.Finalize();
+
+    std::set<std::pair<unsigned, unsigned>> collisions;
+    MatcherType()(left, right, [&](std::size_t leftPos, std::size_t rightPos) {
+        BOOST_CHECK_EQUAL(left.Key(leftPos), right.Key(rightPos));
+        BOOST_CHECK_EQUAL(right.Indexes(rightPos).size(), 2);
+        collisions.emplace(left.Indexes(leftPos).front(), right.Indexes(rightPos).front());
+        return false;
+    });
+
+    return collisions;
+}
+
+BOOST_AUTO_TEST_CASE(MatchersFindAllCollisions) {
+    std::mt19937 gen(229);
+    std::uniform_int_distribution<KeyType> d(0, 31);
+    std::vector<KeyType> leftKeys(300), rightKeys(200);
+    std::generate(leftKeys.begin(), leftKeys.end(), [&]() { return d(gen) << 40; });
+    std::generate(rightKeys.begin(), rightKeys.end(), [&]() { return d(gen) << 40; });
+
+    std::set<std::pair<unsigned, unsigned>> collisionsShouldBe;
+    for(unsigned leftIdx = 0; leftIdx < leftKeys.size(); ++leftIdx) {
+        for(unsigned rightIdx = 0; rightIdx < rightKeys.size(); ++rightIdx) {
+            if(leftKeys[leftIdx] == rightKeys[rightIdx]) {
+                collisionsShouldBe.emplace(leftIdx, rightIdx);
+            }
+        }
+    }
+
+    BOOST_CHECK(collisionsShouldBe == (FindCollisions<SortedList, SortedList, SortMergeMatcher>(leftKeys, rightKeys)));
+    BOOST_CHECK(collisionsShouldBe == (FindCollisions<HashedList, UnorderedList, HashJoinMatcher>(leftKeys, rightKeys)));
+    BOOST_CHECK(collisionsShouldBe == (FindCollisions<UnorderedList, HashedList, HashJoinMatcher>(leftKeys, rightKeys)));
+}
+
+BOOST_AUTO_TEST_CASE(MatchingStopsOnFirstResult) {
+    SortedList left, right;
+    for(unsigned idx = 0; idx < 10; ++idx) {
+        left.Add(1, std::vector<unsigned>{idx});
+        right.Add(1, std::vector<unsigned>{idx});
+    }
+    left.Finalize();
+    right.Finalize();
+
+    unsigned numberOfCalls = 0;
+    auto result = SortMergeMatcher()(left, right, [&](std::size_t, std::size_t) {
+        return ++numberOfCalls == 3;
+    });
+
+    BOOST_CHECK(result);
+    BOOST_CHECK_EQUAL(numberOfCalls, 3);
+}
+
+BOOST_AUTO_TEST_CASE(ErrorVectorOfSystematicMatrix) {
+    // [Q | I] with k = 3, columns are listed by indexes of set bits
+    const std::vector<std::vector<unsigned>> rowsOfQ = {{0, 1}, {1, 2}, {0, 2}, {0, 1, 2}};
+    BinaryMatrix checkMatrix;
+    for(unsigned rowIdx = 0; rowIdx < rowsOfQ.size(); ++rowIdx) {
+        BinaryMatrix::BitContainerType row(7);
+        for(auto colIdx: rowsOfQ[rowIdx]) {
+            row.set(colIdx);
+        }
+        row.set(3 + rowIdx);
+        checkMatrix.addRow(row);
+    }
+
+    boost::dynamic_bitset<> errorVector(7);
+    errorVector.set(0).set(5);
+    boost::dynamic_bitset<> syndrome = checkMatrix.matVecMul(errorVector);
+
+    ISDContext context(checkMatrix, syndrome, 2);
+    BOOST_CHECK_EQUAL(context.InformationSetSize(), 3);
+
+    auto found = context.ErrorVector(std::vector<unsigned>{0});
+    BOOST_TEST(found.has_value());
+    BOOST_CHECK_EQUAL(*found, errorVector);
+    BOOST_CHECK_EQUAL(checkMatrix.matVecMul(*found), syndrome);
+
+    // weight of residual exceeds the budget
+    BOOST_TEST(!context.ErrorVector(std::vector<unsigned>{0, 1}).has_value());
+    // columns of identity part do not change error vector
+    BOOST_CHECK_EQUAL(*context.ErrorVector(std::vector<unsigned>{0, 3}), errorVector);
+}
+
+BOOST_AUTO_TEST_CASE(ContextOfPackedColumns) {
+    const unsigned omega = 6;
+    // the last n - k columns of random matrices are invertible for some seeds only
+    BinaryMatrix checkMatrix;
+    boost::dynamic_bitset<> syndrome;
+    for(std::uint64_t seed = 1; checkMatrix.RowsSize() == 0; ++seed) {
+        auto instance = GenerateInstance(200, 100, omega, seed, false);
+        if(BinaryMatrix::GaussElimination(instance.checkMatrix, instance.syndrome)) {
+            checkMatrix = std::move(instance.checkMatrix);
+            syndrome = std::move(instance.syndrome);
+        }
+    }
+
+    // columns are a view with rows padded to a cache line, as in a mapped file
+    const PackedMatrix columns = PackedMatrix(checkMatrix).Transposed();
+    const std::size_t stride = 8;
+    auto words = std::make_shared<std::vector<PackedMatrix::WordType>>(columns.RowsSize() * stride);
+    for(unsigned col = 0; col < columns.RowsSize(); ++col) {
+        std::copy_n(columns.Row(col), columns.WordsPerRow(), words->data() + col * stride);
+    }
+
+    const ISDContext context(checkMatrix, syndrome, omega);
+    const ISDContext packedContext(PackedMatrix::View(words->data(), columns.RowsSize(), columns.ColumnsSize(), stride, words),
+                                   syndrome, omega);
+    BOOST_CHECK_EQUAL(packedContext.RowsSize(), context.RowsSize());
+    BOOST_CHECK_EQUAL(packedContext.ColumnsSize(), context.ColumnsSize());
+    BOOST_TEST(packedContext.ColumnKeys(context.InformationSetSize(), 3, 20) == context.ColumnKeys(context.InformationSetSize(), 3, 20));
+    BOOST_CHECK_EQUAL(packedContext.IterationIdentifier(), context.IterationIdentifier());
+
+    const std::vector<unsigned> indexes = {0, 2};
+    BOOST_TEST((packedContext.ErrorVector(indexes) == context.ErrorVector(indexes)));
+}
+
+template <typename AlgorithmType>
+void CheckDecodingSmall(const AlgorithmType& algorithm, BinaryMatrix checkMatrix, boost::dynamic_bitset<> syndrome,
+                        unsigned omega, const boost::dynamic_bitset<>& errorVector) {
+    BOOST_TEST_CONTEXT(AlgorithmType::algorithmName) {
+        BOOST_TEST(errorVector == Decoding(checkMatrix, syndrome, omega, algorithm));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(AllPoliciesDecodeSmall) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium1/");
+    const unsigned cols = checkMatrix.ColumnsSize(), rows = checkMatrix.RowsSize(), omega = errorVector.count();
+
+    CheckDecodingSmall(SternAlgorithm(cols), checkMatrix, syndrome, omega, errorVector);
+    CheckDecodingSmall(NewSternAlgorithm(cols), checkMatrix, syndrome, omega, errorVector);
+    CheckDecodingSmall(FS_ISD_Algorithm(cols), checkMatrix, syndrome, omega, errorVector);
+    CheckDecodingSmall(MMTAlgorithm(cols, rows), checkMatrix, syndrome, omega, errorVector);
+    CheckDecodingSmall(MMTHashAlgorithm(cols, rows), checkMatrix, syndrome, omega, errorVector);
+    CheckDecodingSmall(BallCollisionAlgorithm(cols), checkMatrix, syndrome, omega, errorVector);
+}
+
+/**
+ * Random matrix [Q | I], so gauss elimination keeps it as is
+ */
+BinaryMatrix GenerateSystematicMatrix(unsigned rows, unsigned cols) {
+    const unsigned k = cols - rows;
+    std::mt19937 gen(381);
+    std::bernoulli_distribution d(0.5);
+
+    BinaryMatrix checkMatrix;
+    for(unsigned rowIdx = 0; rowIdx < rows; ++rowIdx) {
+        BinaryMatrix::BitContainerType row(cols);
+        for(unsigned colIdx = 0; colIdx < k; ++colIdx) {
+            row[colIdx] = d(gen);
+        }
+        row.set(k + rowIdx);
+        checkMatrix.addRow(row);
+    }
+
+    return checkMatrix;
+}
+
+BOOST_AUTO_TEST_CASE(BallCollisionAllowsErrorsInWindow) {
+    const unsigned rows = 100, cols = 200, k = cols - rows;
+    BinaryMatrix checkMatrix = GenerateSystematicMatrix(rows, cols);
+
+    auto [p, l, q] = BallCollisionAlgorithm(cols).getParams();
+    BOOST_REQUIRE(p == 1 && l == 2 && q == 1);
+
+    // one error in each half of Q, one error in the first row of the window and two errors outside of it
+    boost::dynamic_bitset<> errorVector(cols);
+    errorVector.set(3).set(k / 2 + 10).set(k).set(k + 10).set(k + 20);
+    boost::dynamic_bitset<> syndrome = checkMatrix.matVecMul(errorVector);
+    const unsigned omega = errorVector.count();
+
+    auto matrixForStern = checkMatrix;
+    BOOST_TEST(!SternAlgorithm(cols)(matrixForStern, syndrome, omega).has_value());
+
+    auto matrixForBallCollision = checkMatrix;
+    auto found = BallCollisionAlgorithm(cols)(matrixForBallCollision, syndrome, omega);
+    BOOST_TEST(found.has_value());
+    BOOST_CHECK_EQUAL(*found, errorVector);
+}
+
+BOOST_AUTO_TEST_CASE(SternChecksSeveralWindows) {
+    const unsigned rows = 100, cols = 200, k = cols - rows;
+    BinaryMatrix checkMatrix = GenerateSystematicMatrix(rows, cols);
+
+    auto [p, l] = SternAlgorithm(cols).getParams();
+    BOOST_REQUIRE(p == 1 && l == 2);
+
+    // the first window [0, 2) contains an error, the second one [2, 4) is free of errors
+    boost::dynamic_bitset<> errorVector(cols);
+    errorVector.set(3).set(k / 2 + 10).set(k).set(k + 10).set(k + 20);
+    boost::dynamic_bitset<> syndrome = checkMatrix.matVecMul(errorVector);
+    const unsigned omega = errorVector.count();
+
+    for(auto numberOfWindows: {1u, 2u, 100u}) {
+        BOOST_TEST_CONTEXT("windows: " << numberOfWindows) {
+            auto matrixForStern = checkMatrix;
+            auto found = SternAlgorithm(cols, numberOfWindows)(matrixForStern, syndrome, omega);
+
+            BOOST_TEST(found.has_value() == (numberOfWindows > 1));
+            if(found) {
+                BOOST_CHECK_EQUAL(*found, errorVector);
+            }
+
+            auto matrixForFS = checkMatrix;
+            auto foundByFS = FS_ISD_Algorithm(cols, numberOfWindows)(matrixForFS, syndrome, omega);
+            if(numberOfWindows > 1) {
+                BOOST_TEST(foundByFS.has_value());
+                BOOST_CHECK_EQUAL(*foundByFS, errorVector);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SternChecksSeveralSplits) {
+    const unsigned rows = 100, cols = 200, k = cols - rows;
+    BinaryMatrix checkMatrix = GenerateSystematicMatrix(rows, cols);
+
+    // both errors of Q are in the first half, so the fixed split can not find them
+    boost::dynamic_bitset<> errorVector(cols);
+    errorVector.set(3).set(10).set(k + 10).set(k + 20).set(k + 30);
+    boost::dynamic_bitset<> syndrome = checkMatrix.matVecMul(errorVector);
+    const unsigned omega = errorVector.count();
+
+    auto matrixForOneSplit = checkMatrix;
+    BOOST_TEST(!SternAlgorithm(cols)(matrixForOneSplit, syndrome, omega).has_value());
+
+    for(auto numberOfWindows: {1u, 3u}) {
+        BOOST_TEST_CONTEXT("windows: " << numberOfWindows) {
+            auto matrixForStern = checkMatrix;
+            auto found = SternAlgorithm(cols, numberOfWindows, 16)(matrixForStern, syndrome, omega);
+            BOOST_TEST(found.has_value());
+            if(found) {
+                BOOST_CHECK_EQUAL(*found, errorVector);
+            }
+
+            auto matrixForNewStern = checkMatrix;
+            auto foundByNewStern = NewSternAlgorithm(cols, numberOfWindows, 16)(matrixForNewStern, syndrome, omega);
+            BOOST_TEST(foundByNewStern.has_value());
+            if(foundByNewStern) {
+                BOOST_CHECK_EQUAL(*foundByNewStern, errorVector);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(IterationsHaveDifferentIdentifiers) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium1/");
+    const unsigned cols = checkMatrix.ColumnsSize(), omega = errorVector.count();
+
+    // splits of Stern algorithm are seeded by the identifier, so they differ between permutations and seeds
+    std::set<std::uint64_t> identifiers;
+    unsigned numberOfEliminations = 0;
+    for(const std::uint64_t seed: {1u, 2u}) {
+        auto permutationIter = RandomPermutation(cols).begin(seed);
+        for(unsigned iteration = 0; iteration < 20; ++iteration, ++permutationIter) {
+            BinaryMatrix permutedCheckMatrix = checkMatrix.applyPermutation(*permutationIter);
+            const auto context = SternAlgorithm(cols).Eliminate(permutedCheckMatrix, syndrome, omega);
+            if(context) {
+                ++numberOfEliminations;
+                identifiers.insert(context->IterationIdentifier());
+
+                BinaryMatrix repeatedCheckMatrix = checkMatrix.applyPermutation(*permutationIter);
+                const auto repeated = SternAlgorithm(cols).Eliminate(repeatedCheckMatrix, syndrome, omega);
+                BOOST_CHECK_EQUAL(repeated->IterationIdentifier(), context->IterationIdentifier());
+            }
+        }
+    }
+
+    BOOST_REQUIRE(numberOfEliminations > 0);
+    BOOST_CHECK_EQUAL(identifiers.size(), numberOfEliminations);
+}
+
+BOOST_AUTO_TEST_CASE(StoppedStepFindsNothing) {
+    const unsigned rows = 100, cols = 200, k = cols - rows;
+    BinaryMatrix checkMatrix = GenerateSystematicMatrix(rows, cols);
+
+    boost::dynamic_bitset<> errorVector(cols);
+    errorVector.set(3).set(k / 2 + 10).set(k + 10).set(k + 20).set(k + 30);
+    boost::dynamic_bitset<> syndrome = checkMatrix.matVecMul(errorVector);
+    const unsigned omega = errorVector.count();
+
+    std::atomic<bool> stopFlag = false;
+    auto matrixForStern = checkMatrix;
+    BOOST_TEST(SternAlgorithm(cols)(matrixForStern, syndrome, omega, stopFlag).has_value());
+
+    stopFlag = true;
+    matrixForStern = checkMatrix;
+    BOOST_TEST(!SternAlgorithm(cols)(matrixForStern, syndrome, omega, stopFlag).has_value());
+
+    auto matrixForMMT = checkMatrix;
+    BOOST_TEST(!MMTAlgorithm(cols, rows)(matrixForMMT, syndrome, omega, stopFlag).has_value());
+}
+
+BOOST_AUTO_TEST_CASE(ParallelDecodingSmall) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium1/");
+    const unsigned cols = checkMatrix.ColumnsSize(), omega = errorVector.count();
+
+    for(int numThreads: {1, 4, 16}) {
+        BOOST_TEST_CONTEXT("threads: " << numThreads) {
+            BOOST_TEST(errorVector == DecodingParallel(checkMatrix, syndrome, omega, SternAlgorithm(cols), numThreads));
+            BOOST_TEST(errorVector == DecodingParallel(checkMatrix, syndrome, omega, NewSternAlgorithm(cols), numThreads));
+            BOOST_TEST(errorVector == DecodingParallel(checkMatrix, syndrome, omega, InformationSetDecoding(cols), numThreads));
+        }
+    }
+}
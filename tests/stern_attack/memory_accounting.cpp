@@ -0,0 +1,195 @@
+#define BOOST_TEST_MODULE MemoryAccounting
+#include <boost/test/included/unit_test.hpp>
+#include <algebra/binary_matrix.hpp>
+#include <stern_attack/base_decoding.hpp>
+#include <stern_attack/decoding_pool.hpp>
+#include <stern_attack/memory_accounting.hpp>
+#include <stern_attack/parameter_optimizer.hpp>
+#include <stern_attack/stern_algorithm.hpp>
+#include <stern_attack/mmt_algorithm.hpp>
+#include <stern_attack/information_set_decoding.hpp>
+#include "helper.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+
+
+/// Budget of the test case, the budget is global, so it is restored for other test cases
+struct BudgetGuard {
+    explicit BudgetGuard(std::size_t bytes) {
+        MemoryAccounting::SetBudget(bytes);
+    }
+
+    ~BudgetGuard() {
+        MemoryAccounting::SetBudget(0);
+    }
+};
+
+
+template <typename DecodingStepAlgorithm>
+void MakeSteps(const DecodingStepAlgorithm& algorithm, const BinaryMatrix& checkMatrix,
+               const boost::dynamic_bitset<>& syndrome, unsigned omega, unsigned numberOfSteps) {
+    auto permutationIter = RandomPermutation(checkMatrix.ColumnsSize()).begin(1, 0);
+    for(unsigned step = 0; step < numberOfSteps; ++step, ++permutationIter) {
+        BinaryMatrix permutedCheckMatrix = checkMatrix.applyPermutation(*permutationIter);
+        algorithm(permutedCheckMatrix, syndrome, omega);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(AllocationsAreCounted) {
+    const auto threadBefore = MemoryAccounting::ThreadUsage();
+    const auto globalBefore = MemoryAccounting::GlobalUsage();
+    {
+        const AccountedVector<std::uint32_t> values(1000);
+        BOOST_CHECK_EQUAL(MemoryAccounting::ThreadUsage().currentBytes, threadBefore.currentBytes + 4000);
+        BOOST_CHECK_EQUAL(MemoryAccounting::GlobalUsage().currentBytes, globalBefore.currentBytes + 4000);
+    }
+
+    BOOST_CHECK_EQUAL(MemoryAccounting::ThreadUsage().currentBytes, threadBefore.currentBytes);
+    BOOST_TEST(MemoryAccounting::ThreadUsage().peakBytes >= threadBefore.currentBytes + 4000);
+    BOOST_TEST(MemoryAccounting::GlobalUsage().peakBytes >= globalBefore.currentBytes + 4000);
+
+    // memory of other threads is counted only globally
+    std::thread([]() {
+        const AccountedVector<std::uint32_t> values(1000);
+        BOOST_CHECK_EQUAL(MemoryAccounting::ThreadUsage().currentBytes, 4000);
+    }).join();
+    BOOST_CHECK_EQUAL(MemoryAccounting::ThreadUsage().currentBytes, threadBefore.currentBytes);
+}
+
+BOOST_AUTO_TEST_CASE(ScopesCountPeakOfCounter) {
+    MemoryCounter counter;
+    {
+        const MemoryAccounting::Scope scope(&counter);
+        AccountedVector<std::uint64_t> values(100);
+        {
+            const MemoryAccounting::Scope nested;
+            const AccountedVector<std::uint64_t> more(200);
+            BOOST_CHECK_EQUAL(nested.PeakBytes(), 1600);
+        }
+        values.clear();
+        values.shrink_to_fit();
+
+        BOOST_CHECK_EQUAL(scope.PeakBytes(), 2400);
+    }
+
+    BOOST_CHECK_EQUAL(counter.Usage().currentBytes, 0);
+    BOOST_CHECK_EQUAL(counter.Usage().peakBytes, 2400);
+}
+
+BOOST_AUTO_TEST_CASE(ListsOfAlgorithmAreCounted) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium4/");
+    const unsigned rows = checkMatrix.RowsSize(), cols = checkMatrix.ColumnsSize(), omega = errorVector.count();
+
+    const SternAlgorithm stern(SternParameters{2, 8});
+    const SternAlgorithm copy = stern;
+    MakeSteps(copy, checkMatrix, syndrome, omega, 10);
+
+    // copies share the counter, lists are released after every step
+    const auto usage = stern.MemoryOfLists();
+    BOOST_CHECK_EQUAL(usage.currentBytes, 0);
+    BOOST_TEST(usage.peakBytes > 0);
+    BOOST_TEST(usage.peakBytes <= 2 * stern.ExpectedWork(rows, cols).listBytes);
+    BOOST_TEST(usage.peakBytes >= stern.ExpectedWork(rows, cols).listBytes / 2);
+}
+
+BOOST_AUTO_TEST_CASE(ThreadsFitIntoBudget) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium4/");
+    const unsigned rows = checkMatrix.RowsSize(), cols = checkMatrix.ColumnsSize();
+    const SternAlgorithm stern(SternParameters{2, 8});
+    const double bytesOfThread = stern.ExpectedWork(rows, cols).listBytes + 2.0 * rows * cols / 8;
+
+    BOOST_CHECK_EQUAL(ThreadsWithinBudget(stern, checkMatrix, 8), 8);
+
+    {
+        const BudgetGuard budget(3.5 * bytesOfThread);
+        BOOST_CHECK_EQUAL(ThreadsWithinBudget(stern, checkMatrix, 8), 3);
+        BOOST_CHECK_EQUAL(ThreadsWithinBudget(stern, checkMatrix, 2), 2);
+        // algorithms which memory is unknown keep all threads
+        BOOST_CHECK_EQUAL(ThreadsWithinBudget(InformationSetDecoding(cols), checkMatrix, 8), 8);
+    }
+
+    {
+        // lists of MMT level 2 are truncated, so one thread is run if its level-1 lists fit
+        const MMTAlgorithm mmt(MMTParameters{1, 8, 1}, cols, rows);
+        const auto work = mmt.ExpectedWork(rows, cols);
+        const BudgetGuard budget(work.listBytes - work.truncatableListBytes / 2 + rows * cols / 4);
+        BOOST_CHECK_EQUAL(ThreadsWithinBudget(mmt, checkMatrix, 8), 1);
+    }
+
+    // one iteration does not fit, so decoding is not started at all
+    const BudgetGuard budget(1);
+    BOOST_CHECK_THROW(ThreadsWithinBudget(stern, checkMatrix, 8), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(DecodingWithinBudget) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium4/");
+    const unsigned rows = checkMatrix.RowsSize(), cols = checkMatrix.ColumnsSize(), omega = errorVector.count();
+    const SternAlgorithm stern(cols);
+
+    const BudgetGuard budget(2 * (stern.ExpectedWork(rows, cols).listBytes + rows * cols / 4));
+    BOOST_TEST(errorVector == DecodingParallel(checkMatrix, syndrome, omega, stern, 4));
+
+    DecodingPool pool(4, false);
+    BOOST_TEST(errorVector == DecodingParallel(checkMatrix, syndrome, omega, stern, pool));
+}
+
+BOOST_AUTO_TEST_CASE(ListsOfMMTAreTruncatedByBudget) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium4/");
+    const unsigned omega = errorVector.count();
+
+    const MMTAlgorithm unlimited(MMTParameters{1, 8, 1}, checkMatrix.ColumnsSize(), checkMatrix.RowsSize());
+    MakeSteps(unlimited, checkMatrix, syndrome, omega, 8);
+    BOOST_REQUIRE(unlimited.MemoryOfLists().peakBytes > 0);
+
+    const MMTAlgorithm limited(MMTParameters{1, 8, 1}, checkMatrix.ColumnsSize(), checkMatrix.RowsSize());
+    {
+        const BudgetGuard budget(unlimited.MemoryOfLists().peakBytes / 4);
+        MakeSteps(limited, checkMatrix, syndrome, omega, 8);
+    }
+
+    BOOST_TEST(limited.MemoryOfLists().peakBytes < unlimited.MemoryOfLists().peakBytes);
+}
+
+BOOST_AUTO_TEST_CASE(ExpectationOfMMTCountsTruncatedLists) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium4/");
+    const unsigned rows = checkMatrix.RowsSize(), cols = checkMatrix.ColumnsSize(), omega = errorVector.count();
+    const MMTAlgorithm mmt(MMTParameters{1, 8, 1}, cols, rows);
+    const auto work = mmt.ExpectedWork(rows, cols);
+    const double unlimited = mmt.ExpectedIterations(rows, cols, omega);
+    BOOST_CHECK_EQUAL(mmt.KeptFractionOfLevel2(rows, cols), 1);
+
+    {
+        // a half of every level-2 list is kept, both tuples of the error vector are kept with probability 1/4
+        const BudgetGuard budget(work.listBytes - work.truncatableListBytes / 2 + rows * cols / 4);
+        BOOST_TEST(mmt.KeptFractionOfLevel2(rows, cols) == 0.5, boost::test_tools::tolerance(0.01));
+        BOOST_TEST(mmt.ExpectedIterations(rows, cols, omega) > 3 * unlimited);
+    }
+
+    // level-1 lists do not fit, so lists of level 2 would be always empty
+    const BudgetGuard budget((work.listBytes - work.truncatableListBytes) / 2);
+    BOOST_TEST(std::isinf(mmt.ExpectedIterations(rows, cols, omega)));
+    BOOST_CHECK_THROW(Decoding(checkMatrix, syndrome, omega, mmt), std::runtime_error);
+    BOOST_CHECK_THROW(DecodingParallel(checkMatrix, syndrome, omega, mmt, 2), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(ParametersAreDegradedByBudget) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("big1/");
+    const unsigned rows = checkMatrix.RowsSize(), cols = checkMatrix.ColumnsSize(), omega = errorVector.count();
+
+    ParameterOptimizer<SternAlgorithm> optimizer(checkMatrix, syndrome, omega);
+    optimizer.SetCostModel(IterationCostModel{1, 0, 0});
+    const auto best = optimizer.Best();
+    const double bytesOfBest = SternAlgorithm(best.parameters).ExpectedWork(rows, cols).listBytes;
+
+    // the whole budget is shared by two threads
+    const BudgetGuard budget(bytesOfBest);
+    ParameterOptimizer<SternAlgorithm> limited(checkMatrix, syndrome, omega, OptimizerOptions{.numberOfThreads = 2});
+    limited.SetCostModel(IterationCostModel{1, 0, 0});
+    const auto degraded = limited.Best();
+
+    BOOST_TEST(SternAlgorithm(degraded.parameters).ExpectedWork(rows, cols).listBytes <= bytesOfBest / 2);
+    BOOST_TEST(degraded.expectedIterations >= best.expectedIterations);
+}
@@ -0,0 +1,139 @@
+#define BOOST_TEST_MODULE ParameterOptimizer
+#include <boost/test/included/unit_test.hpp>
+#include <algebra/binary_matrix.hpp>
+#include <stern_attack/base_decoding.hpp>
+#include <stern_attack/parameter_optimizer.hpp>
+#include <stern_attack/stern_algorithm.hpp>
+#include <stern_attack/fs-isd_algorithm.hpp>
+#include <stern_attack/mmt_algorithm.hpp>
+#include <stern_attack/hash_mmt_algorithm.hpp>
+#include <stern_attack/ball_collision_algorithm.hpp>
+#include <stern_attack/information_set_decoding.hpp>
+#include "helper.hpp"
+
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+
+static_assert(OptimizableAlgorithm<SternAlgorithm> && OptimizableAlgorithm<FS_ISD_Algorithm>);
+static_assert(OptimizableAlgorithm<MMTAlgorithm> && OptimizableAlgorithm<MMTHashAlgorithm>);
+static_assert(OptimizableAlgorithm<BallCollisionAlgorithm> && OptimizableAlgorithm<InformationSetDecoding>);
+
+
+BOOST_AUTO_TEST_CASE(AlgorithmsAreCreatedFromParameters) {
+    const unsigned rows = 50, cols = 100;
+
+    BOOST_TEST((SternAlgorithm(SternParameters{2, 10}).getParams() == std::make_pair(2u, 10u)));
+    BOOST_TEST((MMTAlgorithm(MMTParameters{1, 5, 3}, cols, rows).getParams() == std::make_tuple(1u, 5u, 3u, 8u)));
+    BOOST_TEST((BallCollisionAlgorithm(BallCollisionParameters{1, 6, 2}).getParams() == std::make_tuple(1u, 6u, 2u)));
+    BOOST_CHECK_EQUAL(InformationSetDecoding(InformationSetDecodingParameters{3}).getParams(), 3);
+
+    // width of window is limited by width of key
+    BOOST_CHECK_EQUAL(SternAlgorithm(SternParameters{1, 100}).getParams().second, maxKeyLength);
+}
+
+BOOST_AUTO_TEST_CASE(CandidatesAreFeasible) {
+    const unsigned rows = 50, cols = 100, omega = 6;
+
+    const auto checkCandidates = [&]<typename AlgorithmType>(const AlgorithmType*) {
+        const auto candidates = AlgorithmType::ParameterCandidates(rows, cols, omega);
+        BOOST_TEST_CONTEXT(AlgorithmType::algorithmName) {
+            BOOST_TEST(!candidates.empty());
+            for(const auto& parameters: candidates) {
+                const auto algorithm = MakeAlgorithm<AlgorithmType>(parameters, rows, cols);
+                BOOST_TEST(std::isfinite(algorithm.ExpectedIterations(rows, cols, omega)));
+                BOOST_TEST(algorithm.ExpectedWork(rows, cols).collisions > 0);
+            }
+        }
+    };
+
+    checkCandidates(static_cast<const SternAlgorithm*>(nullptr));
+    checkCandidates(static_cast<const MMTAlgorithm*>(nullptr));
+    checkCandidates(static_cast<const BallCollisionAlgorithm*>(nullptr));
+    checkCandidates(static_cast<const InformationSetDecoding*>(nullptr));
+
+    // MMT needs 4p <= omega
+    BOOST_TEST(MMTAlgorithm::ParameterCandidates(rows, cols, 3).empty());
+}
+
+BOOST_AUTO_TEST_CASE(WorkOfIteration) {
+    const unsigned rows = 50, cols = 100;
+
+    // two lists of C(25, 1) entries, pairs collide on one bit with probability 1/2
+    const auto stern = SternAlgorithm(SternParameters{1, 1}).ExpectedWork(rows, cols);
+    BOOST_TEST(stern.listEntries == 50, boost::test_tools::tolerance(1e-9));
+    BOOST_TEST(stern.collisions == 625 / 2.0, boost::test_tools::tolerance(1e-9));
+
+    // every window and split is one more round
+    const auto sternRounds = SternAlgorithm(SternParameters{1, 1}, 2, 3).ExpectedWork(rows, cols);
+    BOOST_TEST(sternRounds.listEntries == 6 * stern.listEntries, boost::test_tools::tolerance(1e-9));
+
+    const auto isd = InformationSetDecoding(InformationSetDecodingParameters{2}).ExpectedWork(rows, cols);
+    BOOST_TEST(isd.collisions == NumberOfCombinations(50, 2), boost::test_tools::tolerance(1e-9));
+}
+
+BOOST_AUTO_TEST_CASE(CostModelIsFitted) {
+    const IterationCostModel model{1e-4, 2e-8, 5e-7};
+
+    std::vector<CalibrationPoint> points;
+    for(const auto& work: {IterationWork{10, 5}, IterationWork{1000, 10}, IterationWork{100, 2000}, IterationWork{100000, 300}}) {
+        points.push_back(CalibrationPoint{work, model.Seconds(work)});
+    }
+
+    const auto fitted = FitCostModel(points);
+    BOOST_TEST(fitted.secondsPerIteration == model.secondsPerIteration, boost::test_tools::tolerance(1e-6));
+    BOOST_TEST(fitted.secondsPerEntry == model.secondsPerEntry, boost::test_tools::tolerance(1e-6));
+    BOOST_TEST(fitted.secondsPerCollision == model.secondsPerCollision, boost::test_tools::tolerance(1e-6));
+
+    // noise which makes time decrease with work does not give negative costs
+    const auto clamped = FitCostModel({CalibrationPoint{IterationWork{10, 10}, 2e-3}, CalibrationPoint{IterationWork{1000, 1000}, 1e-3}});
+    BOOST_TEST(clamped.secondsPerIteration >= 0);
+    BOOST_TEST(clamped.secondsPerEntry >= 0);
+    BOOST_TEST(clamped.secondsPerCollision >= 0);
+
+    BOOST_CHECK_EQUAL(FitCostModel({}).Seconds(IterationWork{1, 1}), 0);
+}
+
+BOOST_AUTO_TEST_CASE(BestParametersHaveLeastExpectedTime) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("big1/");
+    const unsigned rows = checkMatrix.RowsSize(), cols = checkMatrix.ColumnsSize(), omega = errorVector.count();
+
+    ParameterOptimizer<SternAlgorithm> optimizer(checkMatrix, syndrome, omega, OptimizerOptions{.maxListEntries = 1 << 20});
+    optimizer.SetCostModel(IterationCostModel{1e-3, 1e-8, 1e-7});
+    const auto best = optimizer.Best();
+
+    for(const auto& parameters: SternAlgorithm::ParameterCandidates(rows, cols, omega)) {
+        const SternAlgorithm algorithm(parameters);
+        if(algorithm.ExpectedWork(rows, cols).listEntries <= 1 << 20) {
+            const double seconds = algorithm.ExpectedIterations(rows, cols, omega) * optimizer.CostModel().Seconds(algorithm.ExpectedWork(rows, cols));
+            BOOST_TEST(best.expectedSeconds <= seconds);
+        }
+    }
+
+    // when entries are expensive, the least lists win
+    optimizer.SetCostModel(IterationCostModel{0, 1, 0});
+    BOOST_CHECK_EQUAL(optimizer.Best().parameters.p, 1);
+
+    // too strict limit of memory leaves no candidates
+    ParameterOptimizer<SternAlgorithm> limited(checkMatrix, syndrome, omega, OptimizerOptions{.maxListEntries = 1});
+    BOOST_CHECK_THROW(limited.Best(), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(OptimizedAlgorithmFindsErrorVector) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium4/");
+    const unsigned omega = errorVector.count();
+
+    ParameterOptimizer<SternAlgorithm> optimizer(checkMatrix, syndrome, omega, OptimizerOptions{.calibrationPoints = 4, .calibrationIterations = 2});
+    const auto model = optimizer.Calibrate();
+    BOOST_CHECK_EQUAL(optimizer.CalibrationPoints().size(), 4);
+    BOOST_TEST(model.Seconds(IterationWork{1, 1}) > 0);
+
+    const auto checkDecoding = [&](const auto& algorithm) {
+        BOOST_CHECK_EQUAL(Decoding(checkMatrix, syndrome, omega, algorithm), errorVector);
+    };
+
+    checkDecoding(MakeOptimizedAlgorithm<SternAlgorithm>(checkMatrix, syndrome, omega));
+    checkDecoding(MakeOptimizedAlgorithm<MMTHashAlgorithm>(checkMatrix, syndrome, omega));
+    checkDecoding(MakeOptimizedAlgorithm<BallCollisionAlgorithm>(checkMatrix, syndrome, omega));
+}
@@ -0,0 +1,55 @@
+#define BOOST_TEST_MODULE PipelinedDecoding
+#include <boost/test/included/unit_test.hpp>
+#include <algebra/binary_matrix.hpp>
+#include <stern_attack/pipelined_decoding.hpp>
+#include <stern_attack/stern_algorithm.hpp>
+#include <stern_attack/hash_mmt_algorithm.hpp>
+#include <stern_attack/information_set_decoding.hpp>
+#include "helper.hpp"
+
+#include <atomic>
+
+
+static_assert(PipelinedAlgorithm<SternAlgorithm>);
+static_assert(PipelinedAlgorithm<MMTHashAlgorithm>);
+static_assert(!PipelinedAlgorithm<InformationSetDecoding>);
+
+BOOST_AUTO_TEST_CASE(StagesMakeStep) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium1/");
+    const unsigned cols = checkMatrix.ColumnsSize(), omega = errorVector.count();
+    const SternAlgorithm stern(cols);
+
+    for(std::uint64_t index = 0; index < 20; ++index) {
+        const auto permutation = RandomPermutation(cols).Get(381, index);
+
+        BinaryMatrix permutedCheckMatrix = checkMatrix.applyPermutation(permutation);
+        const auto step = stern(permutedCheckMatrix, syndrome, omega);
+
+        permutedCheckMatrix = checkMatrix.applyPermutation(permutation);
+        const auto context = stern.Eliminate(permutedCheckMatrix, syndrome, omega);
+        if(!context) {
+            BOOST_TEST(!step);
+            continue;
+        }
+
+        BOOST_TEST((step == stern.Search(*context)));
+
+        const std::atomic<bool> stopFlag = true;
+        permutedCheckMatrix = checkMatrix.applyPermutation(permutation);
+        const auto stoppedContext = stern.Eliminate(permutedCheckMatrix, syndrome, omega, &stopFlag);
+        BOOST_REQUIRE(stoppedContext);
+        BOOST_TEST(!stern.Search(*stoppedContext));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(PipelineFindsErrorVector) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium1/");
+    const unsigned cols = checkMatrix.ColumnsSize(), rows = checkMatrix.RowsSize(), omega = errorVector.count();
+
+    for(const auto& options: {PipelineOptions{1, 1, 1}, PipelineOptions{4, 1, 1}, PipelineOptions{2, 3, 1}, PipelineOptions{1, 2, 3}}) {
+        BOOST_TEST_CONTEXT("depth: " << options.queueDepth << ", producers: " << options.numberOfProducers << ", consumers: " << options.numberOfConsumers) {
+            BOOST_TEST(errorVector == DecodingPipelined(checkMatrix, syndrome, omega, SternAlgorithm(cols), options));
+            BOOST_TEST(errorVector == DecodingPipelined(checkMatrix, syndrome, omega, MMTHashAlgorithm(cols, rows), options));
+        }
+    }
+}
@@ -0,0 +1,113 @@
+#define BOOST_TEST_MODULE PortfolioDecoding
+#include <boost/test/included/unit_test.hpp>
+#include <algebra/binary_matrix.hpp>
+#include <stern_attack/portfolio_decoding.hpp>
+#include <stern_attack/stern_algorithm.hpp>
+#include <stern_attack/fs-isd_algorithm.hpp>
+#include <stern_attack/mmt_algorithm.hpp>
+#include <stern_attack/hash_mmt_algorithm.hpp>
+#include <stern_attack/ball_collision_algorithm.hpp>
+#include <stern_attack/information_set_decoding.hpp>
+#include "helper.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <thread>
+
+
+BOOST_AUTO_TEST_CASE(ExpectedIterationsOfAlgorithms) {
+    const unsigned rows = 50, cols = 100, k = cols - rows, omega = 6;
+    const double all = NumberOfCombinations(cols, omega);
+
+    // p = 1, l = 1
+    const double stern = all / (NumberOfCombinations(k / 2, 1) * NumberOfCombinations(k / 2, 1) * NumberOfCombinations(rows - 1, omega - 2));
+    BOOST_TEST(SternAlgorithm(cols).ExpectedIterations(rows, cols, omega) == stern, boost::test_tools::tolerance(1e-9));
+    BOOST_TEST(SternAlgorithm(cols, 4, 2).ExpectedIterations(rows, cols, omega) == 1 / (1 - std::pow(1 - 1 / stern, 8)), boost::test_tools::tolerance(1e-9));
+
+    const double fsIsd = all / (NumberOfCombinations((k + 1) / 2, 1) * NumberOfCombinations((k + 1) / 2, 1) * NumberOfCombinations(rows - 1, omega - 2));
+    BOOST_TEST(FS_ISD_Algorithm(cols).ExpectedIterations(rows, cols, omega) == fsIsd, boost::test_tools::tolerance(1e-9));
+
+    // p = 1, l1 = 2, l2 = 1
+    const double mmt = all / (NumberOfCombinations((k + 3) / 2, 2) * NumberOfCombinations((k + 3) / 2, 2) * NumberOfCombinations(rows - 3, omega - 4));
+    BOOST_TEST(MMTAlgorithm(cols, rows).ExpectedIterations(rows, cols, omega) == mmt, boost::test_tools::tolerance(1e-9));
+
+    // p = 1, l = 1, q = 1: the only row of window belongs to its second half
+    const double ballSuccesses = NumberOfCombinations(k / 2, 1) * NumberOfCombinations(k / 2, 1)
+                                 * (NumberOfCombinations(rows - 1, omega - 2) + NumberOfCombinations(rows - 1, omega - 3));
+    BOOST_TEST(BallCollisionAlgorithm(cols).ExpectedIterations(rows, cols, omega) == all / ballSuccesses, boost::test_tools::tolerance(1e-9));
+
+    const double isd = all / (NumberOfCombinations(k, 1) * NumberOfCombinations(rows, omega - 1));
+    BOOST_TEST(InformationSetDecoding(cols).ExpectedIterations(rows, cols, omega) == isd, boost::test_tools::tolerance(1e-9));
+
+    // error vector can not be found if omega < 2p
+    BOOST_TEST(std::isinf(SternAlgorithm(cols).ExpectedIterations(rows, cols, 1)));
+    BOOST_TEST(std::isinf(MMTAlgorithm(cols, rows).ExpectedIterations(rows, cols, 3)));
+
+    // sizes of real instances do not overflow
+    BOOST_TEST(std::isfinite(SternAlgorithm(3488).ExpectedIterations(720, 3488, 64)));
+}
+
+BOOST_AUTO_TEST_CASE(PortfolioFindsErrorVector) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium1/");
+    const unsigned cols = checkMatrix.ColumnsSize(), rows = checkMatrix.RowsSize(), omega = errorVector.count();
+
+    for(int run = 0; run < 3; ++run) {
+        DecodingPortfolio portfolio(checkMatrix, syndrome, omega, 3, 2);
+        portfolio.Add(SternAlgorithm(cols));
+        portfolio.Add(FS_ISD_Algorithm(cols));
+        portfolio.Add(MMTHashAlgorithm(cols, rows));
+        portfolio.Add(InformationSetDecoding(cols));
+
+        BOOST_TEST(portfolio.Winner() == nullptr);
+        BOOST_TEST(errorVector == portfolio.Run());
+        BOOST_REQUIRE(portfolio.Winner() != nullptr);
+
+        const auto reports = portfolio.Report();
+        BOOST_CHECK_EQUAL(reports.size(), 4);
+        BOOST_CHECK_EQUAL(reports.front().algorithmName, "Stern");
+        for(const auto& report: reports) {
+            BOOST_TEST(report.expectedIterations >= 1);
+            BOOST_CHECK_EQUAL(report.numberOfThreads, 0);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ThreadsMoveToBestAlgorithm) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium1/");
+    const unsigned cols = checkMatrix.ColumnsSize(), omega = errorVector.count();
+    const unsigned warmupIterations = 3;
+
+    DecodingPortfolio portfolio(checkMatrix, syndrome, omega, 2, warmupIterations);
+    portfolio.Add(SternAlgorithm(cols), 1e12);
+    portfolio.Add(SternAlgorithm(cols), 1);
+
+    BOOST_TEST(errorVector == portfolio.Run());
+
+    const auto reports = portfolio.Report();
+    BOOST_TEST(reports[0].numberOfIterations <= warmupIterations);
+    BOOST_TEST(reports[1].projectedSeconds < reports[0].projectedSeconds);
+    BOOST_TEST(std::string(portfolio.Winner()) == "Stern");
+
+    DecodingPortfolio withoutAlgorithms(checkMatrix, syndrome, omega);
+    BOOST_CHECK_THROW(withoutAlgorithms.Run(), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE(AlgorithmsAreAddedWhileRunning) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium4/");
+    const unsigned cols = checkMatrix.ColumnsSize(), omega = errorVector.count();
+
+    DecodingPortfolio portfolio(checkMatrix, syndrome, omega, 3, 1);
+    portfolio.Add(InformationSetDecoding(cols));
+
+    std::thread adder([&]() {
+        for(unsigned idx = 0; idx < 20; ++idx) {
+            portfolio.Add(SternAlgorithm(cols));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    BOOST_TEST(errorVector == portfolio.Run());
+    adder.join();
+    BOOST_CHECK_EQUAL(portfolio.Report().size(), 21);
+}
@@ -0,0 +1,140 @@
+#define BOOST_TEST_MODULE ProgressReporting
+#include <boost/test/included/unit_test.hpp>
+#include <algebra/binary_matrix.hpp>
+#include <stern_attack/base_decoding.hpp>
+#include <stern_attack/decoding_pool.hpp>
+#include <stern_attack/progress_reporting.hpp>
+#include <stern_attack/stern_algorithm.hpp>
+#include "helper.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+
+std::string MetricsFile(const std::string& name) {
+    auto file = std::filesystem::temp_directory_path() / ("stern_attack_" + name + ".jsonl");
+    std::filesystem::remove(file);
+
+    return file.string();
+}
+
+std::vector<std::string> ReadReports(const std::string& file) {
+    std::ifstream ifs(file);
+    std::vector<std::string> lines;
+    for(std::string line; std::getline(ifs, line);) {
+        lines.push_back(line);
+    }
+
+    return lines;
+}
+
+
+BOOST_AUTO_TEST_CASE(IterationsOfThreadsAreCounted) {
+    ProgressReporter reporter(ProgressOptions{.expectedIterations = 100}, 3);
+
+    std::vector<std::thread> threads;
+    for(unsigned threadIdx = 0; threadIdx < 3; ++threadIdx) {
+        threads.emplace_back([&reporter, threadIdx]() {
+            for(unsigned iteration = 0; iteration < 1000 * (threadIdx + 1); ++iteration) {
+                reporter.AddIteration(threadIdx);
+            }
+        });
+    }
+    for(auto& thread: threads) {
+        thread.join();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    const auto report = reporter.Report();
+    BOOST_CHECK_EQUAL(report.numberOfIterations, 6000);
+    BOOST_CHECK_EQUAL(report.threadIterationsPerSecond.size(), 3);
+    BOOST_TEST(report.threadIterationsPerSecond[2] == 3 * report.threadIterationsPerSecond[0], boost::test_tools::tolerance(1e-9));
+    BOOST_TEST(report.iterationsPerSecond == 6000 / report.elapsedSeconds, boost::test_tools::tolerance(1e-9));
+
+    // iterations are independent trials, so 6000 iterations of expected 100 succeed almost surely
+    BOOST_TEST(report.successProbability > 0.999);
+    BOOST_REQUIRE(report.etaSeconds.has_value());
+    BOOST_TEST(*report.etaSeconds == 100 / report.iterationsPerSecond, boost::test_tools::tolerance(1e-9));
+}
+
+BOOST_AUTO_TEST_CASE(UnknownExpectationHasNoETA) {
+    const ProgressReporter reporter(ProgressOptions{}, 1);
+    const auto report = reporter.Report();
+
+    BOOST_CHECK_EQUAL(report.numberOfIterations, 0);
+    BOOST_CHECK_EQUAL(report.successProbability, 0);
+    BOOST_TEST(!report.etaSeconds.has_value());
+}
+
+BOOST_AUTO_TEST_CASE(ReportsAreWrittenPeriodically) {
+    const auto file = MetricsFile("periodic");
+    {
+        ProgressReporter reporter(ProgressOptions{.interval = std::chrono::milliseconds(5), .metricsFile = file, .expectedIterations = 10}, 2);
+        reporter.AddIteration(1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    const auto reports = ReadReports(file);
+    BOOST_REQUIRE(reports.size() >= 2);
+    BOOST_TEST(reports.front().find("\"iterations\": 1,") != std::string::npos);
+    BOOST_TEST(reports.front().find("\"final\": false") != std::string::npos);
+    // the final report is written when the reporter stops
+    BOOST_TEST(reports.back().find("\"final\": true") != std::string::npos);
+
+    std::filesystem::remove(file);
+}
+
+BOOST_AUTO_TEST_CASE(DecodingReportsProgress) {
+    auto [checkMatrix, syndrome, errorVector] = ReadInstance("medium4/");
+    const unsigned omega = errorVector.count();
+    const SternAlgorithm stern(checkMatrix.ColumnsSize());
+
+    const auto file = MetricsFile("decoding");
+    const ProgressOptions progress{.interval = std::chrono::milliseconds(1), .metricsFile = file};
+
+    BOOST_TEST(errorVector == Decoding(checkMatrix, syndrome, omega, stern, progress));
+    BOOST_TEST(errorVector == DecodingParallel(checkMatrix, syndrome, omega, stern, 2, progress));
+
+    DecodingPool pool(2, false);
+    BOOST_TEST(errorVector == DecodingParallel(checkMatrix, syndrome, omega, stern, pool, progress));
+
+    // expected number of iterations is taken from the algorithm
+    const auto reports = ReadReports(file);
+    BOOST_REQUIRE(reports.size() >= 3);
+    const std::string expected = "\"expected_iterations\": 0,";
+    for(const auto& report: reports) {
+        BOOST_TEST(report.find(expected) == std::string::npos);
+    }
+
+    std::filesystem::remove(file);
+}
+
+BOOST_AUTO_TEST_CASE(ExpectationCountsPermutationsAsReporter) {
+    const unsigned rows = 30, cols = 60, omega = 4;
+    const auto [checkMatrix, syndrome] = GenerateInstanceWithoutSolution(rows, cols, 0, 1);
+    const SternAlgorithm stern(cols);
+
+    // reporter counts every permutation as decoding loops do, elimination fails for about 71% of them
+    ProgressReporter reporter(ProgressOptions{}, 1);
+    const unsigned numberOfPermutations = 4000;
+    unsigned numberOfEliminations = 0;
+    auto permutationIter = RandomPermutation(cols).begin(7);
+    for(unsigned iteration = 0; iteration < numberOfPermutations; ++iteration, ++permutationIter) {
+        BinaryMatrix permutedCheckMatrix = checkMatrix.applyPermutation(*permutationIter);
+        auto copiedSyndrome = syndrome;
+        numberOfEliminations += stern.GaussElimination(permutedCheckMatrix, copiedSyndrome);
+        reporter.AddIteration(0);
+    }
+
+    const double measuredProbability = static_cast<double>(numberOfEliminations) / reporter.Report().numberOfIterations;
+    BOOST_TEST(measuredProbability == EliminationSuccessProbability(rows), boost::test_tools::tolerance(0.15));
+
+    // expectation of the algorithm counts information sets, so reports convert it to permutations
+    const auto progressReporter = StartProgress(ProgressOptions{.interval = std::chrono::hours(1)}, stern, checkMatrix, omega, 1);
+    BOOST_REQUIRE(progressReporter);
+    const double expectedPermutations = progressReporter->Report().expectedIterations;
+    BOOST_TEST(expectedPermutations == ExpectedPermutations(stern, rows, cols, omega), boost::test_tools::tolerance(1e-9));
+    BOOST_TEST(expectedPermutations * measuredProbability == stern.ExpectedIterations(rows, cols, omega), boost::test_tools::tolerance(0.15));
+}
@@ -0,0 +1,156 @@
+#define BOOST_TEST_MODULE SystematicDecoding
+#include <boost/test/included/unit_test.hpp>
+#include <algebra/systematic_matrix.hpp>
+#include <instances/packed_format.hpp>
+#include <instances/instance_generator.hpp>
+#include <stern_attack/information_set_decoding.hpp>
+#include <stern_attack/isd_engine.hpp>
+#include <stern_attack/stern_algorithm.hpp>
+#include <stern_attack/systematic_decoding.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+/// Finds error vectors which lie in the identity block, counts eliminated and searched steps
+struct IdentityBlockAlgorithm {
+    constexpr static const char* algorithmName = "IdentityBlock";
+    mutable unsigned numberOfSearches = 0;
+    mutable unsigned numberOfSteps = 0;
+
+    std::optional<boost::dynamic_bitset<>> Search(const ISDContext& context) const {
+        ++numberOfSearches;
+        return context.ErrorVector({});
+    }
+
+    std::optional<boost::dynamic_bitset<>> operator()(BinaryMatrix& checkMatrix, boost::dynamic_bitset<> syndrome, const unsigned omega) const {
+        ++numberOfSteps;
+        if(!BinaryMatrix::GaussElimination(checkMatrix, syndrome)) {
+            return std::nullopt;
+        }
+        return Search(ISDContext(checkMatrix, syndrome, omega));
+    }
+};
+
+
+BOOST_AUTO_TEST_CASE(FirstIterationSkipsElimination) {
+    const unsigned n = 160, k = 100, omega = 6;
+    auto instance = GenerateInstance(n, k, omega, 12);
+    const auto checkMatrix = *SystematicMatrix::FromMatrix(instance.checkMatrix);
+
+    // the error lies in the identity columns, so the first information set (the columns of Q) has no errors
+    boost::dynamic_bitset<> errorVector(n);
+    for(unsigned idx = 0; idx < omega; ++idx) {
+        errorVector.set(7 * idx);
+    }
+
+    const IdentityBlockAlgorithm algorithm;
+    std::ostringstream output;
+    auto* const coutBuffer = std::cout.rdbuf(output.rdbuf());
+    const auto decoded = Decoding(checkMatrix, checkMatrix.matVecMul(errorVector), omega, algorithm);
+    std::cout.rdbuf(coutBuffer);
+
+    BOOST_TEST(decoded == errorVector);
+    BOOST_CHECK_EQUAL(algorithm.numberOfSearches, 1);
+    BOOST_CHECK_EQUAL(algorithm.numberOfSteps, 0);
+    // the successful step is counted as in other overloads of Decoding
+    BOOST_TEST(output.str().find("number of iterations: 1\n") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(DecodingOfPlantedError) {
+    const unsigned n = 200, k = 120, omega = 8;
+    for(std::uint64_t seed = 1; seed <= 3; ++seed) {
+        const auto instance = GenerateInstance(n, k, omega, seed);
+        const auto checkMatrix = *SystematicMatrix::FromMatrix(instance.checkMatrix);
+
+        BOOST_TEST(Decoding(checkMatrix, instance.syndrome, omega, SternAlgorithm(n)) == instance.errorVector);
+        BOOST_TEST(Decoding(checkMatrix, instance.syndrome, omega, InformationSetDecoding(InformationSetDecodingParameters{2})) == instance.errorVector);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(CheckpointedDecodingStartsFromStoredSystematicForm) {
+    const unsigned n = 160, k = 100, omega = 6;
+    const auto file = (std::filesystem::temp_directory_path() / "stern_attack_first_information_set.bin").string();
+    const auto checkpointFile = file + ".checkpoint";
+
+    // the last n - k columns of random matrices are invertible for some seeds only
+    std::uint64_t seed = 1;
+    PackedInstance packed;
+    for(; !packed.systematicMatrix; ++seed) {
+        SavePackedInstance(GenerateInstance(n, k, omega, seed, false), file,
+                           PackedWriteOptions{.layout = PackedLayout::Columns, .withSystematicForm = true});
+        packed = LoadPackedInstance(file);
+    }
+
+    // the error lies in the last n - k columns, which are the identity of the stored systematic form
+    const BinaryMatrix checkMatrix = packed.CheckMatrix();
+    boost::dynamic_bitset<> errorVector(n);
+    for(unsigned idx = 0; idx < omega; ++idx) {
+        errorVector.set(k + 9 * idx);
+    }
+    const auto syndrome = checkMatrix.matVecMul(errorVector);
+    auto systematicMatrix = checkMatrix;
+    auto systematicSyndrome = syndrome;
+    BOOST_REQUIRE(BinaryMatrix::GaussElimination(systematicMatrix, systematicSyndrome));
+
+    std::vector<unsigned> identity(n);
+    std::iota(identity.begin(), identity.end(), 0);
+    auto columns = *packed.SystematicColumns();
+    BOOST_TEST(columns.IsView());
+
+    const IdentityBlockAlgorithm algorithm;
+    std::ostringstream output;
+    auto* const coutBuffer = std::cout.rdbuf(output.rdbuf());
+    const auto decoded = DecodingWithCheckpoints(checkMatrix, syndrome, omega, algorithm,
+                                                 EliminatedInformationSet{identity, std::move(columns), systematicSyndrome},
+                                                 checkpointFile, std::chrono::hours(1), 1);
+    std::cout.rdbuf(coutBuffer);
+
+    BOOST_TEST(decoded == errorVector);
+    BOOST_CHECK_EQUAL(algorithm.numberOfSearches, 1);
+    BOOST_CHECK_EQUAL(algorithm.numberOfSteps, 0);
+    BOOST_TEST(!std::filesystem::exists(checkpointFile));
+
+    std::filesystem::remove(file);
+}
+
+BOOST_AUTO_TEST_CASE(CheckpointedDecodingSkipsFirstElimination) {
+    const unsigned n = 160, k = 100, omega = 6;
+    const auto instance = GenerateInstance(n, k, omega, 12);
+    const auto checkMatrix = *SystematicMatrix::FromMatrix(instance.checkMatrix);
+    const auto checkpointFile = (std::filesystem::temp_directory_path() / "stern_attack_systematic.checkpoint").string();
+
+    // checkpoints of both matrices of the instance are interchangeable
+    BOOST_CHECK_EQUAL(DecodingCheckpoint::Fingerprint(checkMatrix, instance.syndrome, omega),
+                      DecodingCheckpoint::Fingerprint(instance.checkMatrix, instance.syndrome, omega));
+
+    boost::dynamic_bitset<> errorVector(n);
+    for(unsigned idx = 0; idx < omega; ++idx) {
+        errorVector.set(7 * idx);
+    }
+
+    const IdentityBlockAlgorithm algorithm;
+    std::ostringstream output;
+    auto* const coutBuffer = std::cout.rdbuf(output.rdbuf());
+    const auto decoded = DecodingWithCheckpoints(checkMatrix, checkMatrix.matVecMul(errorVector), omega, algorithm, checkpointFile,
+                                                 std::chrono::hours(1), 1);
+    std::cout.rdbuf(coutBuffer);
+
+    BOOST_TEST(decoded == errorVector);
+    BOOST_CHECK_EQUAL(algorithm.numberOfSearches, 1);
+    BOOST_CHECK_EQUAL(algorithm.numberOfSteps, 0);
+    BOOST_TEST(output.str().find("number of iterations: 1\n") != std::string::npos);
+
+    // other iterations permute [I | Q] built from Q
+    const auto planted = GenerateInstance(200, 120, 8, 2);
+    const auto plantedMatrix = *SystematicMatrix::FromMatrix(planted.checkMatrix);
+    BOOST_TEST(DecodingWithCheckpoints(plantedMatrix, planted.syndrome, 8, SternAlgorithm(200), checkpointFile) == planted.errorVector);
+    BOOST_TEST(!std::filesystem::exists(checkpointFile));
+}
@@ -0,0 +1,98 @@
+#define BOOST_TEST_MODULE PerfEvents
+#define STERN_ATTACK_HARDWARE_COUNTERS
+#include <boost/test/included/unit_test.hpp>
+#include <utils/perf_events.hpp>
+#include <stern_attack/instrumentation.hpp>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+
+static_assert(Instrumentation::enabled && Instrumentation::hardwareCounters);
+
+
+/// Some work which makes instructions and memory accesses
+std::uint64_t Work(std::size_t size) {
+    std::vector<std::uint64_t> values(size);
+    std::uint64_t sum = 0;
+    for(std::size_t idx = 0; idx < size; ++idx) {
+        values[idx] = idx * 0x9E3779B97F4A7C15ull;
+        sum += values[(idx * 7919) % (idx + 1)];
+    }
+
+    return sum;
+}
+
+#ifdef __linux__
+BOOST_AUTO_TEST_CASE(SoftwareEventsAreCounted) {
+    // software events are available without PMU, e.g. in virtual machines
+    const std::array<PerfEventDescription, 3> events{{
+        {"task_clock", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+        {"unsupported", PERF_TYPE_SOFTWARE, ~std::uint64_t(0)},
+        {"page_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+    }};
+
+    const PerfEventGroup group(events);
+    BOOST_TEST(!group.IsCounted(1));
+
+    std::array<std::uint64_t, 3> before, after;
+    if(!group.Read(before)) {
+        BOOST_TEST_MESSAGE("perf_event_open is not permitted, nothing to check");
+        return;
+    }
+
+    BOOST_TEST(group.IsCounted(0));
+    BOOST_TEST(Work(1 << 20) != 1);
+    BOOST_TEST(group.Read(after));
+
+    BOOST_TEST(after[0] > before[0]);
+    BOOST_TEST(after[2] >= before[2]);
+    BOOST_CHECK_EQUAL(after[1], 0);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(MissingHardwareEventsAreSkipped) {
+    const PerfEventGroup group(hardwarePerfEvents);
+
+    std::array<std::uint64_t, hardwarePerfEvents.size()> values;
+    values.fill(1);
+    if(!group.Read(values)) {
+        for(const auto value: values) {
+            BOOST_CHECK_EQUAL(value, 0);
+        }
+    }
+
+    for(std::size_t event = 0; event < hardwarePerfEvents.size(); ++event) {
+        if(!group.IsCounted(event)) {
+            BOOST_CHECK_EQUAL(values[event], 0);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(EventsOfPhasesAreReported) {
+    const auto before = Instrumentation::Collect();
+    {
+        const Instrumentation::PhaseTimer timer(DecodingPhase::Matching);
+        BOOST_TEST(Work(1 << 20) != 1);
+    }
+    const auto report = Instrumentation::Collect() - before;
+
+    std::map<std::string, std::uint64_t> statistics;
+    report.Save(statistics);
+
+    for(std::size_t event = 0; event < hardwarePerfEvents.size(); ++event) {
+        const std::string name = std::string("events.matching.") + hardwarePerfEvents[event].name;
+        BOOST_TEST(statistics.contains(name) == report.IsEventCounted(event));
+        BOOST_CHECK_EQUAL(report.Event(DecodingPhase::Elimination, event), 0);
+    }
+
+    if(report.IsEventCounted(0)) {
+        BOOST_TEST(report.Event(DecodingPhase::Matching, 0) > 0);
+        BOOST_TEST(InstrumentationReport::Load(statistics).events == report.events);
+    } else {
+        BOOST_TEST_MESSAGE("hardware events are not supported, nothing to check");
+    }
+}